@@ -2,6 +2,9 @@
 #define AUDIO_PROCESSING_H
 
 #include <stdint.h>
+#include "biquad_filter.h"
+#include "hum_notch.h"
+#include "noise_floor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,7 +20,30 @@ extern "C" {
 /* Audio processing configuration */
 #define SAMPLE_RATE 10000      /* Hz - sampling frequency */
 #define SAMPLE_SIZE 1024       /* Number of samples to process */
-#define MIN_AMPLITUDE 50       /* Minimum amplitude to consider valid signal */
+#define MIN_AMPLITUDE 50       /* Minimum amplitude until the noise floor is learned */
+#define ANALYZER_FRAME_SIZE 256 /* Samples per analysis frame (FFT size) */
+#define ANALYZER_HISTORY_SIZE 1024 /* Samples kept for the opt-in long refinement */
+#define ANALYZER_VALIDATION_SIZE 512 /* Newest samples the harmonic validation runs on */
+
+/**
+ * Per-stream analysis state
+ * 
+ * Everything one input carries from frame to frame. The audio_processing_*
+ * functions and apply_fft() run on a built-in instance; the audio_analyzer_*
+ * functions run on a caller-owned one, so independent streams can be
+ * analyzed side by side (interleaved on one core or on several threads).
+ * FFT buffers are per frame on the caller's stack and are not part of it.
+ */
+typedef struct {
+	biquad_cascade_t prefilter;                     /* Band-pass before windowing */
+	noise_floor_t noise_tracker;                    /* Adaptive noise floor */
+	int spectral_subtraction;                       /* 1 to subtract the floor before peak search */
+	int long_refinement;                            /* 1 to refine again on the long frame */
+	float last_confidence;                          /* Harmonicity of the latest frame */
+	hum_notch_t hum_filter;                         /* Streaming mains hum notch */
+	int16_t stream_window[ANALYZER_HISTORY_SIZE];   /* Most recent notched, pre-filtered samples */
+	uint32_t stream_fill;
+} audio_analyzer_t;
 
 /* Function prototypes */
 
@@ -27,8 +53,73 @@ extern "C" {
  */
 void audio_processing_init(void);
 
+/**
+ * Configure the band-pass/high-pass pre-filter applied before windowing
+ * Called by audio_processing_init() for standard guitar; call again after
+ * switching instrument so the pass band follows the new string range
+ * 
+ * @param mode: PREFILTER_OFF, PREFILTER_HIGHPASS or PREFILTER_BANDPASS
+ * @param min_string_hz: Lowest open-string frequency of the instrument
+ * @param max_string_hz: Highest open-string frequency of the instrument
+ */
+void audio_processing_configure_prefilter(prefilter_mode_t mode, float min_string_hz, float max_string_hz);
+
+/**
+ * Restart adaptive noise-floor tracking (forget the learned room noise)
+ */
+void audio_processing_reset_noise_floor(void);
+
+/**
+ * Configure noise-relative detection
+ * 
+ * @param snr_ratio: Magnitude ratio a peak must reach over the noise floor
+ * @param subtract: 1 to enable spectral subtraction before peak search
+ */
+void audio_processing_set_noise_options(float snr_ratio, int subtract);
+
+/**
+ * Refine the note a second time on up to ANALYZER_HISTORY_SIZE samples
+ * 
+ * Off by default. The 256-sample refinement reads E2 and A2 within several
+ * cents from frame to frame (the main lobe overlaps its negative-frequency
+ * image and the second harmonic); this pins them within a cent. It costs
+ * PEAK_REFINE_PROBES more Goertzel probes over 1024 samples per frame, about
+ * 16k double multiply-adds, four times the default refinement.
+ * 
+ * @param enable: 1 to add the long-frame search, 0 for the 256-sample one only
+ */
+void audio_processing_set_long_refinement(int enable);
+
+/**
+ * Select the mains hum notch used by audio_processing_process_block()
+ * HUM_NOTCH_AUTO (the default) detects 50 or 60 Hz from the input
+ * 
+ * @param mode: HUM_NOTCH_OFF, HUM_NOTCH_AUTO, HUM_NOTCH_50HZ or HUM_NOTCH_60HZ
+ */
+void audio_processing_set_hum_notch(hum_notch_mode_t mode);
+
+/**
+ * Mains frequency the hum notch is locked to
+ * 
+ * @return: Tracked mains frequency in Hz (0.0 while detecting or if no hum)
+ */
+float audio_processing_mains_hz(void);
+
+/**
+ * Streaming analysis of contiguous capture blocks
+ * Removes mains hum, then every 128 new samples runs the FFT on the newest
+ * 256 and validates the note on up to the last 512
+ * 
+ * @param block: Audio samples (int16_t PCM), any block size
+ * @param num_samples: Number of samples in block
+ * @param detected_frequency: Output: result of the latest analyzed frame
+ * @return: 1 if a frame was analyzed during this call, 0 otherwise
+ */
+int audio_processing_process_block(const int16_t* block, int num_samples, double* detected_frequency);
+
 /**
  * Capture audio and detect fundamental frequency using real FFT
+ * Drains the capture driver's queue when it is running (see audio_capture.h)
  * 
  * @param detected_frequency: Output parameter for detected frequency in Hz
  * @return: 1 if valid frequency detected, 0 if no valid signal
@@ -44,6 +135,40 @@ int audio_processing_capture(double* detected_frequency);
  */
 double apply_fft(const int16_t* samples, int num_samples);
 
+/**
+ * Harmonic confidence of the most recent apply_fft() frame
+ * apply_fft() returns 0.0 for frames below HARMONIC_CONFIDENCE_MIN
+ * 
+ * @return: Fraction of the frame's energy in partials standing out of their valleys (0-1)
+ */
+float audio_processing_last_confidence(void);
+
+/* Caller-owned analyzers - same processing as the functions above */
+
+/**
+ * Initialize an analyzer with the audio_processing_init() defaults
+ * (no console output, safe to call for thousands of streams)
+ */
+void audio_analyzer_init(audio_analyzer_t* analyzer);
+
+void audio_analyzer_configure_prefilter(audio_analyzer_t* analyzer, prefilter_mode_t mode,
+                                        float min_string_hz, float max_string_hz);
+
+void audio_analyzer_set_hum_notch(audio_analyzer_t* analyzer, hum_notch_mode_t mode);
+
+void audio_analyzer_set_long_refinement(audio_analyzer_t* analyzer, int enable);
+
+/**
+ * apply_fft() on one analyzer; confidence is left in analyzer->last_confidence
+ */
+double audio_analyzer_apply_fft(audio_analyzer_t* analyzer, const int16_t* samples, int num_samples);
+
+/**
+ * audio_processing_process_block() on one analyzer
+ */
+int audio_analyzer_process_block(audio_analyzer_t* analyzer, const int16_t* block, int num_samples,
+                                 double* detected_frequency);
+
 /**
  * Remove DC offset from audio samples
  * DC bias can skew FFT results, so this preprocessing step is important
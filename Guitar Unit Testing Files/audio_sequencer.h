@@ -24,6 +24,17 @@
 #define FILE_10_CENTS "10CENTS.WAV"
 #define FILE_20_CENTS "20CENTS.WAV"
 
+// Overlap between cached clips of one phrase (0 = butt splice)
+#define SEQUENCER_CROSSFADE_SAMPLES 0
+
+// Longest phrase: "[String] [Cents] [Direction]"
+#define SEQUENCER_MAX_PHRASE_CLIPS 3
+
+// Parts of a phrase, so it can be announced in stages
+#define SEQUENCER_PART_STRING 0x01     // "[String]"
+#define SEQUENCER_PART_OFFSET 0x02     // "[Cents] [Direction]" or "In tune"
+#define SEQUENCER_PART_ALL    (SEQUENCER_PART_STRING | SEQUENCER_PART_OFFSET)
+
 /* ============================================================================
  * STATIC FEEDBACK MODE (Original Implementation)
  * ========================================================================== */
@@ -38,21 +49,62 @@ void audio_sequencer_init(void);
  * Generate audio feedback using pre-recorded files
  * Plays: "[String Name] [Cents] [Direction]" sequence
  * Example: "E ... Ten Cents ... UP"
+ * The first clip starts immediately (from the prompt cache when loaded)
  */
 void generate_audio_feedback(const TuningResult* result);
 
+/**
+ * Same for selected SEQUENCER_PART_* only, e.g. the string name as soon as a
+ * coarse estimate names it and the offset once the estimate is confident
+ */
+void generate_audio_feedback_parts(const TuningResult* result, int parts);
+
 /**
  * Update static audio playback state
  * Call this regularly to advance through audio file playback
+ * Only needed when some clips are not cached: a fully cached phrase is queued
+ * as one gapless playlist and finishes without polling
  */
 void audio_sequencer_update(void);
 
+/**
+ * Called once when a feedback phrase has finished playing
+ * From the audio update for cached phrases - keep it short
+ */
+typedef void (*audio_feedback_done_fn)(void* context);
+
+void audio_sequencer_on_complete(audio_feedback_done_fn callback, void* context);
+
+/**
+ * @return Nonzero while a feedback phrase is playing
+ */
+int audio_sequencer_is_playing(void);
+
 void play_audio_file(const char* filename);
 
+/**
+ * Clip names for the phrase describing `result`, without playing them
+ * 
+ * @param clips: Room for SEQUENCER_MAX_PHRASE_CLIPS names
+ * @return Number of clips written
+ */
+int audio_sequencer_build_phrase(const TuningResult* result, const char** clips);
+
+/**
+ * Clip names for the selected SEQUENCER_PART_* of the phrase
+ */
+int audio_sequencer_build_phrase_parts(const TuningResult* result, int parts, const char** clips);
+
 /* ============================================================================
  * DYNAMIC BEEP FEEDBACK MODE (New Implementation)
  * ========================================================================== */
 
+// Beeps are synthesized (tone_synth) and mixed into the output blocks
+#define BEEP_PITCH_SHARP_HZ 1320.0f     // Note too high - tune down
+#define BEEP_PITCH_FLAT_HZ  660.0f      // Note too low - tune up
+#define BEEP_DURATION_MS    50
+#define BEEP_LEVEL          0.5f
+
 /**
  * Generate dynamic beep feedback based on tuning accuracy
  * 
@@ -70,28 +122,22 @@ void play_audio_file(const char* filename);
  *   1. User plays a string
  *   2. FFT detects frequency and calculates cents offset
  *   3. Call: generate_dynamic_beep_feedback(&result)
- *   4. Call audio_sequencer_update_beeps() regularly in main loop
+ *   4. feedback_scheduler_render() fires the beeps in the output blocks
  *   5. Beeps play at rate based on how far user is from target
  *   6. As user adjusts pitch, beep rate automatically changes
  */
 void generate_dynamic_beep_feedback(const TuningResult* result);
 
 /**
- * Update dynamic beep timing
- * 
- * Call this frequently (10-50 ms intervals) in your main loop to maintain
- * accurate beep timing. It will emit beeps at the calculated rate based on
- * the current cents offset.
+ * Re-check the dynamic beep rate
  * 
- * @param current_time_ms: Current system time in milliseconds (from millis())
+ * Beeps are scheduled in sample time (feedback_scheduler) and fired inside
+ * the output block callback, so the main loop no longer has to poll for
+ * timing. Call this only when the TuningResult given to
+ * generate_dynamic_beep_feedback() is updated in place; a new result can
+ * simply be passed to generate_dynamic_beep_feedback() again.
  * 
- * Example in main loop:
- * ```
- *   void loop() {
- *       // ... other code ...
- *       audio_sequencer_update_beeps(millis());
- *   }
- * ```
+ * @param current_time_ms: Unused, kept for existing callers
  * 
  * Beep rate mapping (cents offset → beep interval):
  * - 100+ cents off: 100 ms between beeps (fastest feedback)
@@ -116,4 +162,12 @@ void audio_sequencer_update_beeps(uint32_t current_time_ms);
  */
 uint32_t calculate_beep_interval(double cents_offset);
 
+/**
+ * Beep pitch for a tuning offset: a higher tone when sharp, a lower one when flat
+ * 
+ * @param cents_offset: Positive = too high, negative = too low
+ * @return: Oscillator frequency in Hz
+ */
+float get_beep_pitch(double cents_offset);
+
 #endif
\ No newline at end of file
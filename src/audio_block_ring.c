@@ -0,0 +1,97 @@
+/**
+ * audio_block_ring.c - Lock-free SPSC block queue implementation
+ *
+ * Uses the GCC __atomic builtins (available in both the native toolchain
+ * and arm-none-eabi-gcc). Each side only writes its own index:
+ * - The producer reads tail with acquire (slot is free again) and stores
+ *   head with release (block contents visible before the new head)
+ * - The consumer reads head with acquire and stores tail with release
+ * On the single-core Teensy this compiles to plain loads/stores plus DMB.
+ */
+
+#include <string.h>
+#include "audio_block_ring.h"
+
+#define RING_MASK (AUDIO_RING_BLOCKS - 1)
+
+void audio_ring_init(audio_block_ring_t* ring) {
+    ring->head = 0;
+    ring->overruns = 0;
+    ring->tail = 0;
+    ring->underruns = 0;
+}
+
+// ---------------- Producer ----------------
+
+int16_t* audio_ring_write_acquire(audio_block_ring_t* ring) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);  // Own index
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= AUDIO_RING_BLOCKS) {
+        return NULL;
+    }
+    return ring->blocks[head & RING_MASK];
+}
+
+void audio_ring_write_commit(audio_block_ring_t* ring) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void audio_ring_write_drop(audio_block_ring_t* ring) {
+    __atomic_store_n(&ring->overruns, ring->overruns + 1, __ATOMIC_RELAXED);
+}
+
+bool audio_ring_push(audio_block_ring_t* ring, const int16_t* block) {
+    int16_t* slot = audio_ring_write_acquire(ring);
+    if (slot == NULL) {
+        return false;
+    }
+    memcpy(slot, block, AUDIO_RING_BLOCK_SIZE * sizeof(int16_t));
+    audio_ring_write_commit(ring);
+    return true;
+}
+
+// ---------------- Consumer ----------------
+
+const int16_t* audio_ring_read_acquire(audio_block_ring_t* ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);  // Own index
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        __atomic_store_n(&ring->underruns, ring->underruns + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    return ring->blocks[tail & RING_MASK];
+}
+
+void audio_ring_read_release(audio_block_ring_t* ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+bool audio_ring_pop(audio_block_ring_t* ring, int16_t* block) {
+    const int16_t* slot = audio_ring_read_acquire(ring);
+    if (slot == NULL) {
+        return false;
+    }
+    memcpy(block, slot, AUDIO_RING_BLOCK_SIZE * sizeof(int16_t));
+    audio_ring_read_release(ring);
+    return true;
+}
+
+// ---------------- Status ----------------
+
+uint32_t audio_ring_count(const audio_block_ring_t* ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head - tail;
+}
+
+uint32_t audio_ring_overruns(const audio_block_ring_t* ring) {
+    return __atomic_load_n(&ring->overruns, __ATOMIC_RELAXED);
+}
+
+uint32_t audio_ring_underruns(const audio_block_ring_t* ring) {
+    return __atomic_load_n(&ring->underruns, __ATOMIC_RELAXED);
+}
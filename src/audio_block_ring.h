@@ -0,0 +1,140 @@
+/**
+ * audio_block_ring.h - Lock-free single-producer/single-consumer block queue
+ *
+ * Carries fixed-size audio blocks from the capture side (DMA ISR or audio
+ * library callback) to the analysis loop without locks or disabling
+ * interrupts:
+ * - Exactly one producer calls the write functions, exactly one consumer
+ *   calls the read functions
+ * - Head and tail are free-running counters; capacity is a power of two so
+ *   the slot index is a mask and "full" is head - tail == capacity
+ * - Producer and consumer state live on separate cache lines, and every
+ *   block slot starts on its own cache line (DMA-safe on Cortex-M7)
+ * - A block becomes visible to the consumer only after it is completely
+ *   written (release/acquire ordering), so blocks are never torn
+ *
+ * When the analysis loop stalls for longer than the ring can absorb, the
+ * newest block is refused - blocks already queued are never overwritten.
+ * A producer that cannot wait (the capture ISR) then drops the block and
+ * reports it with audio_ring_write_drop(); one that applies back-pressure
+ * retries instead, and nothing is counted. Size AUDIO_RING_BLOCKS for the
+ * longest stall.
+ */
+
+#ifndef AUDIO_BLOCK_RING_H
+#define AUDIO_BLOCK_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define AUDIO_RING_BLOCK_SIZE   128     // Samples per block (matches AUDIO_BLOCK_SIZE)
+#define AUDIO_RING_BLOCKS       32      // Capacity, must be a power of two (410 ms at 10 kHz)
+
+#if defined(__arm__)
+#define AUDIO_RING_CACHE_LINE   32      // Cortex-M7 D-cache line
+#else
+#define AUDIO_RING_CACHE_LINE   64      // x86-64 / AArch64
+#endif
+
+#if (AUDIO_RING_BLOCKS & (AUDIO_RING_BLOCKS - 1)) != 0
+#error "AUDIO_RING_BLOCKS must be a power of two"
+#endif
+
+/* ============================================================================
+ * RING TYPE
+ * ========================================================================== */
+
+typedef struct {
+    // Producer-owned line
+    uint32_t head __attribute__((aligned(AUDIO_RING_CACHE_LINE)));  // Blocks ever committed
+    uint32_t overruns;                                              // Blocks dropped because the ring was full
+
+    // Consumer-owned line
+    uint32_t tail __attribute__((aligned(AUDIO_RING_CACHE_LINE)));  // Blocks ever released
+    uint32_t underruns;                                             // Reads attempted on an empty ring
+
+    int16_t blocks[AUDIO_RING_BLOCKS][AUDIO_RING_BLOCK_SIZE] __attribute__((aligned(AUDIO_RING_CACHE_LINE)));
+} audio_block_ring_t;
+
+/**
+ * Reset the ring to empty and clear the counters
+ * Not thread-safe: call before the producer and consumer start
+ */
+void audio_ring_init(audio_block_ring_t* ring);
+
+/* ============================================================================
+ * PRODUCER (ISR / audio callback)
+ * ========================================================================== */
+
+/**
+ * Get the next free slot to fill in place (e.g. as a DMA destination)
+ *
+ * @return Slot of AUDIO_RING_BLOCK_SIZE samples, or NULL if the ring is full
+ *         (retry later, or give up with audio_ring_write_drop())
+ */
+int16_t* audio_ring_write_acquire(audio_block_ring_t* ring);
+
+/**
+ * Publish the slot returned by audio_ring_write_acquire()
+ */
+void audio_ring_write_commit(audio_block_ring_t* ring);
+
+/**
+ * Copy one block into the ring
+ *
+ * @return true if queued, false if the ring was full (block refused; retry
+ *         later, or give up with audio_ring_write_drop())
+ */
+bool audio_ring_push(audio_block_ring_t* ring, const int16_t* block);
+
+/**
+ * Count a block the producer gave up on because the ring was full
+ * (reported by audio_ring_overruns()); retries are not drops
+ */
+void audio_ring_write_drop(audio_block_ring_t* ring);
+
+/* ============================================================================
+ * CONSUMER (analysis loop)
+ * ========================================================================== */
+
+/**
+ * Get the oldest queued block without copying it
+ *
+ * @return Block of AUDIO_RING_BLOCK_SIZE samples, or NULL if the ring is
+ *         empty (counted as an underrun)
+ */
+const int16_t* audio_ring_read_acquire(audio_block_ring_t* ring);
+
+/**
+ * Return the block from audio_ring_read_acquire() to the producer
+ */
+void audio_ring_read_release(audio_block_ring_t* ring);
+
+/**
+ * Copy the oldest block out of the ring
+ *
+ * @return true if a block was copied, false if the ring was empty
+ */
+bool audio_ring_pop(audio_block_ring_t* ring, int16_t* block);
+
+/* ============================================================================
+ * STATUS (either side)
+ * ========================================================================== */
+
+uint32_t audio_ring_count(const audio_block_ring_t* ring);
+uint32_t audio_ring_overruns(const audio_block_ring_t* ring);
+uint32_t audio_ring_underruns(const audio_block_ring_t* ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_BLOCK_RING_H
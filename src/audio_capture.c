@@ -0,0 +1,293 @@
+/**
+ * audio_capture.c - Double-buffered capture driver implementation
+ *
+ * The completion handlers are shared by both backends, so everything
+ * downstream of them (callback or ring, analysis timing) behaves the same
+ * on the simulator as on the Teensy.
+ */
+
+#ifndef __arm__
+#define _POSIX_C_SOURCE 199309L     // clock_gettime for the simulator
+#endif
+
+#include "audio_capture.h"
+#include "config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef __arm__
+#include <time.h>
+#endif
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ========================================================================== */
+
+static int16_t dma_buffer[AUDIO_CAPTURE_DMA_SAMPLES] __attribute__((aligned(AUDIO_RING_CACHE_LINE)));
+static audio_block_ring_t capture_ring;
+
+static uint32_t capture_sample_rate = 0;
+static audio_capture_callback_t capture_callback = NULL;
+static void* capture_user = NULL;
+static volatile bool capture_running = false;
+static volatile uint64_t block_clock = 0;       // Samples in completed halves
+static audio_capture_stats_t capture_stats;
+
+#ifndef __arm__
+/* Simulation backend */
+static audio_capture_generator_t sim_generator = NULL;
+static void* sim_user = NULL;
+static FILE* sim_file = NULL;
+static bool sim_loop = false;
+static uint32_t sim_dma_pos = 0;                // Next sample the "DMA" writes
+static struct timespec sim_start_time;
+#endif
+
+/* ============================================================================
+ * DRIVER
+ * ========================================================================== */
+
+audio_capture_error_t audio_capture_init(uint32_t sample_rate, audio_capture_callback_t callback, void* user) {
+    if (sample_rate == 0) {
+        return AUDIO_CAPTURE_ERROR;
+    }
+
+    audio_capture_stop();
+    capture_sample_rate = sample_rate;
+    capture_callback = callback;
+    capture_user = user;
+    block_clock = 0;
+    memset(&capture_stats, 0, sizeof(capture_stats));
+    memset(dma_buffer, 0, sizeof(dma_buffer));
+    audio_ring_init(&capture_ring);
+    return AUDIO_CAPTURE_OK;
+}
+
+audio_capture_error_t audio_capture_start(void) {
+    if (capture_sample_rate == 0) {
+        return AUDIO_CAPTURE_ERROR;
+    }
+    block_clock = 0;
+
+#ifdef __INCLUDE_TEENSY_LIBS__
+    /* Not yet supported on hardware: nothing programs the timer-triggered
+       ADC or the circular DMA channel over dma_buffer, so no block would
+       ever complete. Report it rather than claim a running capture; the
+       Teensy build gets its audio from the Audio library (teensy_audio_io). */
+    return AUDIO_CAPTURE_ERROR;
+#elif !defined(__arm__)
+    if (sim_generator == NULL && sim_file == NULL) {
+        return AUDIO_CAPTURE_NO_SOURCE;
+    }
+    sim_dma_pos = 0;
+    clock_gettime(CLOCK_MONOTONIC, &sim_start_time);
+#endif
+
+    capture_running = true;
+    return AUDIO_CAPTURE_OK;
+}
+
+void audio_capture_stop(void) {
+    capture_running = false;
+}
+
+bool audio_capture_is_running(void) {
+    return capture_running;
+}
+
+bool audio_capture_read_block(int16_t* block) {
+    return audio_ring_pop(&capture_ring, block);
+}
+
+uint64_t audio_capture_sample_clock(void) {
+#ifndef __arm__
+    return block_clock + (sim_dma_pos % AUDIO_CAPTURE_BLOCK_SIZE);
+#else
+    return block_clock;
+#endif
+}
+
+void audio_capture_get_stats(audio_capture_stats_t* stats) {
+    *stats = capture_stats;
+    stats->blocks_dropped = audio_ring_overruns(&capture_ring);
+}
+
+/* ============================================================================
+ * DMA INTERFACE
+ * ========================================================================== */
+
+int16_t* audio_capture_dma_buffer(void) {
+    return dma_buffer;
+}
+
+/**
+ * Hand one finished half to the callback or the ring
+ */
+static void deliver_block(int16_t* block) {
+    if (!capture_running) {
+        return;
+    }
+
+    uint64_t start = block_clock;
+    block_clock = start + AUDIO_CAPTURE_BLOCK_SIZE;
+    capture_stats.blocks_delivered++;
+
+    if (capture_callback != NULL) {
+        capture_callback(block, start, capture_user);
+    } else if (!audio_ring_push(&capture_ring, block)) {
+        audio_ring_write_drop(&capture_ring);   // the half is refilled next period: the block is lost
+    }
+}
+
+void audio_capture_dma_half_complete(void) {
+    deliver_block(&dma_buffer[0]);
+}
+
+void audio_capture_dma_full_complete(void) {
+    deliver_block(&dma_buffer[AUDIO_CAPTURE_BLOCK_SIZE]);
+}
+
+/* ============================================================================
+ * NATIVE SIMULATION BACKEND
+ * ========================================================================== */
+
+#ifndef __arm__
+
+static uint64_t elapsed_us(const struct timespec* from, const struct timespec* to) {
+    int64_t ns = (int64_t)(to->tv_sec - from->tv_sec) * 1000000000LL + (to->tv_nsec - from->tv_nsec);
+    return (uint64_t)(ns / 1000);
+}
+
+static void close_sim_file(void) {
+    if (sim_file != NULL) {
+        fclose(sim_file);
+        sim_file = NULL;
+    }
+}
+
+audio_capture_error_t audio_capture_sim_generator(audio_capture_generator_t generator, void* user) {
+    if (generator == NULL) {
+        return AUDIO_CAPTURE_ERROR;
+    }
+    close_sim_file();
+    sim_generator = generator;
+    sim_user = user;
+    return AUDIO_CAPTURE_OK;
+}
+
+audio_capture_error_t audio_capture_sim_file(const char* filename, bool loop) {
+    close_sim_file();
+    sim_generator = NULL;
+
+    sim_file = fopen(filename, "rb");
+    if (sim_file == NULL) {
+        printf("ERROR: Cannot open capture file: %s\n", filename);
+        return AUDIO_CAPTURE_FILE_ERROR;
+    }
+    sim_loop = loop;
+    return AUDIO_CAPTURE_OK;
+}
+
+/**
+ * Read little-endian int16 samples from the capture file
+ */
+static uint32_t read_sim_file(int16_t* out, uint32_t num_samples) {
+    uint8_t bytes[2 * AUDIO_CAPTURE_BLOCK_SIZE];
+    uint32_t produced = 0;
+
+    while (produced < num_samples) {
+        uint32_t want = num_samples - produced;
+        size_t got = fread(bytes, 2, want, sim_file);
+
+        for (size_t i = 0; i < got; i++) {
+            out[produced + i] = (int16_t)(bytes[2 * i] | (bytes[2 * i + 1] << 8));
+        }
+        produced += (uint32_t)got;
+
+        if (got < want) {
+            if (!sim_loop || ftell(sim_file) < 2) {
+                break;      // End of stream (or an empty file that cannot loop)
+            }
+            rewind(sim_file);
+        }
+    }
+    return produced;
+}
+
+uint32_t audio_capture_sim_advance(uint32_t num_samples) {
+    uint32_t captured = 0;
+
+    while (capture_running && captured < num_samples) {
+        /* Fill up to the next half boundary, like the DMA would */
+        uint32_t boundary = (sim_dma_pos < AUDIO_CAPTURE_BLOCK_SIZE) ? AUDIO_CAPTURE_BLOCK_SIZE : AUDIO_CAPTURE_DMA_SAMPLES;
+        uint32_t chunk = boundary - sim_dma_pos;
+        if (chunk > num_samples - captured) {
+            chunk = num_samples - captured;
+        }
+
+        uint32_t produced = (sim_file != NULL)
+            ? read_sim_file(&dma_buffer[sim_dma_pos], chunk)
+            : sim_generator(&dma_buffer[sim_dma_pos], chunk, audio_capture_sample_clock(), sim_user);
+        sim_dma_pos += produced;
+        captured += produced;
+
+        if (sim_dma_pos == AUDIO_CAPTURE_BLOCK_SIZE || sim_dma_pos == AUDIO_CAPTURE_DMA_SAMPLES) {
+            /* Completion "interrupt" - time it against the block period */
+            struct timespec before, after;
+            clock_gettime(CLOCK_MONOTONIC, &before);
+            if (sim_dma_pos == AUDIO_CAPTURE_BLOCK_SIZE) {
+                audio_capture_dma_half_complete();
+            } else {
+                audio_capture_dma_full_complete();
+                sim_dma_pos = 0;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &after);
+
+            uint32_t callback_us = (uint32_t)elapsed_us(&before, &after);
+            uint32_t period_us = (uint32_t)(1000000ULL * AUDIO_CAPTURE_BLOCK_SIZE / capture_sample_rate);
+            if (callback_us > capture_stats.max_callback_us) {
+                capture_stats.max_callback_us = callback_us;
+            }
+            if (callback_us > period_us) {
+                capture_stats.late_callbacks++;
+            }
+        }
+
+        if (produced < chunk) {
+            audio_capture_stop();   // Source exhausted
+        }
+    }
+    return captured;
+}
+
+uint32_t audio_capture_sim_pump_realtime(void) {
+    if (!capture_running) {
+        return 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t due = elapsed_us(&sim_start_time, &now) * capture_sample_rate / 1000000ULL;
+    uint64_t clock = audio_capture_sample_clock();
+
+    if (due <= clock) {
+        return 0;
+    }
+    return audio_capture_sim_advance((uint32_t)(due - clock));
+}
+
+uint32_t audio_capture_sine_generator(int16_t* out, uint32_t num_samples, uint64_t first_sample, void* user) {
+    const audio_capture_sine_t* sine = (const audio_capture_sine_t*)user;
+    const double two_pi = 6.28318530717958647692;
+
+    for (uint32_t i = 0; i < num_samples; i++) {
+        /* Phase from the absolute sample index - no drift over long runs */
+        double cycles = (double)sine->frequency_hz * (double)(first_sample + i) / sine->sample_rate;
+        cycles -= (double)(uint64_t)cycles;
+        out[i] = (int16_t)(sine->amplitude * sin(two_pi * cycles));
+    }
+    return num_samples;
+}
+
+#endif // __arm__
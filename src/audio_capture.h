@@ -0,0 +1,173 @@
+/**
+ * audio_capture.h - Double-buffered microphone capture driver
+ *
+ * Modelled on circular DMA: the converter fills one buffer of two halves
+ * (ping-pong). When the first half is full the half-complete interrupt hands
+ * it to the callback while the second half is being filled, then the
+ * full-complete interrupt does the same for the second half. The callback
+ * therefore has one block period to finish before its half is overwritten.
+ *
+ * Backends:
+ * - Teensy: not yet supported - audio_capture_start() returns
+ *   AUDIO_CAPTURE_ERROR. The intended wiring is a timer-triggered ADC on
+ *   MICROPHONE_INPUT_PIN whose DMA ISR calls audio_capture_dma_half_complete()
+ *   / audio_capture_dma_full_complete() on audio_capture_dma_buffer(),
+ *   with the samples already signed 16-bit
+ * - Native simulation: a generator or a raw PCM file is "sampled" into the
+ *   same buffer at a virtual sample clock and the same completion handlers
+ *   fire, so the real-time pipeline can be run and timed on Linux
+ *
+ * Without a user callback, completed blocks are queued in an internal
+ * audio_block_ring_t and read with audio_capture_read_block().
+ */
+
+#ifndef AUDIO_CAPTURE_H
+#define AUDIO_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_block_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define AUDIO_CAPTURE_BLOCK_SIZE    AUDIO_RING_BLOCK_SIZE   // Samples per half buffer
+#define AUDIO_CAPTURE_DMA_SAMPLES   (2 * AUDIO_CAPTURE_BLOCK_SIZE)
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    AUDIO_CAPTURE_OK = 0,
+    AUDIO_CAPTURE_ERROR = -1,
+    AUDIO_CAPTURE_FILE_ERROR = -2,
+    AUDIO_CAPTURE_NO_SOURCE = -3
+} audio_capture_error_t;
+
+/**
+ * Block-complete callback - runs in interrupt context on hardware
+ *
+ * @param block AUDIO_CAPTURE_BLOCK_SIZE samples, valid until the callback returns
+ * @param sample_clock Sample index of block[0] since audio_capture_start()
+ * @param user Pointer given to audio_capture_init()
+ */
+typedef void (*audio_capture_callback_t)(const int16_t* block, uint64_t sample_clock, void* user);
+
+/**
+ * Simulation source: fill `num_samples` samples starting at sample index `first_sample`
+ *
+ * @return Samples produced; fewer than requested ends the stream
+ */
+typedef uint32_t (*audio_capture_generator_t)(int16_t* out, uint32_t num_samples, uint64_t first_sample, void* user);
+
+/* Sine generator state for audio_capture_sine_generator() */
+typedef struct {
+    float frequency_hz;
+    float amplitude;            // Peak, in int16 units
+    uint32_t sample_rate;
+} audio_capture_sine_t;
+
+typedef struct {
+    uint32_t blocks_delivered;  // Halves handed to the callback / ring
+    uint32_t blocks_dropped;    // Ring full (analysis stalled)
+    uint32_t late_callbacks;    // Callback took longer than one block period (simulation)
+    uint32_t max_callback_us;   // Slowest callback seen (simulation)
+} audio_capture_stats_t;
+
+/* ============================================================================
+ * DRIVER
+ * ========================================================================== */
+
+/**
+ * Configure the driver (does not start capturing)
+ *
+ * @param sample_rate Converter sample rate in Hz (e.g. FFT_INPUT_SAMPLE_RATE)
+ * @param callback Block handler, or NULL to queue blocks in the internal ring
+ * @param user Passed to callback
+ */
+audio_capture_error_t audio_capture_init(uint32_t sample_rate, audio_capture_callback_t callback, void* user);
+
+/**
+ * Start the converter and DMA (or the simulation clock)
+ * On native builds a simulation source must be selected first; on Teensy
+ * the hardware backend is not yet supported and AUDIO_CAPTURE_ERROR is returned
+ */
+audio_capture_error_t audio_capture_start(void);
+void audio_capture_stop(void);
+bool audio_capture_is_running(void);
+
+/**
+ * Pop the oldest queued block (only when no callback was registered)
+ *
+ * @return true if AUDIO_CAPTURE_BLOCK_SIZE samples were copied to block
+ */
+bool audio_capture_read_block(int16_t* block);
+
+/**
+ * Samples captured since audio_capture_start()
+ */
+uint64_t audio_capture_sample_clock(void);
+
+void audio_capture_get_stats(audio_capture_stats_t* stats);
+
+/* ============================================================================
+ * DMA INTERFACE (called from the DMA ISR or the simulator)
+ * ========================================================================== */
+
+int16_t* audio_capture_dma_buffer(void);
+void audio_capture_dma_half_complete(void);
+void audio_capture_dma_full_complete(void);
+
+/* ============================================================================
+ * NATIVE SIMULATION BACKEND
+ * ========================================================================== */
+
+#ifndef __arm__
+
+/**
+ * Use a generator as the microphone
+ */
+audio_capture_error_t audio_capture_sim_generator(audio_capture_generator_t generator, void* user);
+
+/**
+ * Use a raw 16-bit little-endian mono PCM file as the microphone
+ *
+ * @param loop true to restart at end of file, false to stop the clock there
+ */
+audio_capture_error_t audio_capture_sim_file(const char* filename, bool loop);
+
+/**
+ * Advance the virtual sample clock, filling the DMA buffer and firing the
+ * half/full completion handlers exactly as the hardware would
+ *
+ * @return Samples captured (less than num_samples once the source ends)
+ */
+uint32_t audio_capture_sim_advance(uint32_t num_samples);
+
+/**
+ * Advance the virtual clock to match wall-clock time since start
+ * (real-time pacing, for latency measurements)
+ *
+ * @return Samples captured by this call
+ */
+uint32_t audio_capture_sim_pump_realtime(void);
+
+/**
+ * Built-in generator: sine of the configured frequency and amplitude
+ * (user = audio_capture_sine_t*)
+ */
+uint32_t audio_capture_sine_generator(int16_t* out, uint32_t num_samples, uint64_t first_sample, void* user);
+
+#endif // __arm__
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_CAPTURE_H
@@ -43,7 +43,13 @@
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "audio_processing.h"
+#include "tuning_table.h"
+#include "noise_floor.h"
+#include "hum_notch.h"
+#include "signal_processing.h"
+#include "audio_capture.h"
 #include <stdlib.h>
 
 /* CMSIS-DSP FFT library - provides hardware-optimized FFT functions */
@@ -54,15 +60,28 @@
 #endif
 
 /* FFT configuration - must be power of 2 for efficiency */
-#define FFT_SIZE 256                    /* 256-point FFT: 10kHz / 256 = 39 Hz/bin resolution */
+#define FFT_SIZE ANALYZER_FRAME_SIZE    /* 256-point FFT: 10kHz / 256 = 39 Hz/bin resolution */
 
-/* Static FFT buffers - allocated once for performance */
-static float fft_input_buffer[FFT_SIZE];        /* Input: 256 real-valued audio samples */
-static float fft_real[FFT_SIZE];                /* Real component of FFT output */
-static float fft_imag[FFT_SIZE];                /* Imaginary component of FFT output */
-static float magnitude_spectrum[FFT_SIZE / 2];  /* Magnitude of each frequency bin (128 bins) */
+/* Per-stream state (pre-filter, noise floor, hum notch, stream window) lives
+   in audio_analyzer_t; the global API below runs on this instance. FFT
+   buffers are per frame, on the caller's stack, so analyzers can run on
+   several threads at once. */
+static audio_analyzer_t default_analyzer;
 static int fft_initialized = 0;                 /* Initialization flag for safety */
 
+/* Streaming front end - hum notch runs continuously, frames overlap by half */
+#define STREAM_HOP (FFT_SIZE / 2)               /* New samples between analyses (12.8 ms) */
+#define STREAM_CHUNK 128                        /* Samples converted per notch call */
+
+#define DEFAULT_PEAK_MAGNITUDE  0.5f    /* Fixed peak threshold used until the tracker is primed */
+#define MIN_PEAK_MAGNITUDE      0.05f   /* Never accept peaks below this, however quiet the room */
+#define MIN_AMPLITUDE_QUIET     (MIN_AMPLITUDE / 5)  /* Lowest amplitude gate (quiet room) */
+#define HANN_POWER_GAIN         (3.0f * FFT_SIZE / 8.0f)  /* sum(w^2) of the Hann window */
+#define PEAK_SEARCH_MAX_HZ      2000    /* Upper end of the peak search (see find_peak_frequency) */
+#define PEAK_SEARCH_BINS        ((FFT_SIZE / 2) * PEAK_SEARCH_MAX_HZ / SAMPLE_RATE)
+#define PEAK_REFINE_PROBES      16      /* Goertzel probes per frame for the sub-bin frequency */
+#define PEAK_REFINE_HALF_BINS   0.6     /* Golden-section bracket either side of the peak bin */
+
 /**
  * Bit reversal permutation for FFT
  * Rearranges input data according to bit-reversed indices
@@ -135,6 +154,124 @@ void audio_processing_init(void) {
 	       SAMPLE_RATE, FFT_SIZE, SAMPLE_SIZE);
 	fft_initialized = 1;
 	printf("FFT initialized successfully.\n");
+	
+	audio_analyzer_init(&default_analyzer);
+}
+
+/**
+ * Initialize one stream's analysis state (no console output)
+ * Defaults match audio_processing_init(): automatic hum notch, band-pass
+ * pre-filter for standard guitar, noise floor not yet learned
+ */
+void audio_analyzer_init(audio_analyzer_t* analyzer) {
+	noise_floor_init(&analyzer->noise_tracker, FFT_SIZE / 2, PEAK_SEARCH_BINS, NOISE_FLOOR_SNR_DEFAULT);
+	analyzer->spectral_subtraction = 0;
+	analyzer->long_refinement = 0;
+	analyzer->last_confidence = 0.0f;
+	audio_analyzer_set_hum_notch(analyzer, HUM_NOTCH_AUTO);
+	
+	/* Default pre-filter covers standard guitar tuning */
+	const tuning_table_t* guitar = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+	audio_analyzer_configure_prefilter(analyzer, PREFILTER_BANDPASS, guitar->min_hz, guitar->max_hz);
+}
+
+/**
+ * Design the pre-filter for the active string range
+ * 
+ * High-pass corner sits a fifth below the lowest string so its fundamental
+ * passes untouched while rumble, handling noise and most hum are removed.
+ * The low-pass corner keeps the 12th fret of the highest string plus its
+ * first few harmonics and cuts the hiss and click energy above that.
+ */
+void audio_processing_configure_prefilter(prefilter_mode_t mode, float min_string_hz, float max_string_hz) {
+	audio_analyzer_configure_prefilter(&default_analyzer, mode, min_string_hz, max_string_hz);
+}
+
+void audio_analyzer_configure_prefilter(audio_analyzer_t* analyzer, prefilter_mode_t mode,
+                                        float min_string_hz, float max_string_hz) {
+	float low_hz = min_string_hz / 1.5f;
+	float high_hz = max_string_hz * 8.0f;
+	
+	if (high_hz > 0.4f * SAMPLE_RATE) {
+		high_hz = 0.4f * SAMPLE_RATE;
+	}
+	biquad_cascade_design(&analyzer->prefilter, mode, low_hz, high_hz, (float)SAMPLE_RATE);
+}
+
+/**
+ * Restart noise-floor tracking (e.g. after moving to a different room)
+ */
+void audio_processing_reset_noise_floor(void) {
+	noise_floor_t* tracker = &default_analyzer.noise_tracker;
+	noise_floor_init(tracker, FFT_SIZE / 2, PEAK_SEARCH_BINS, tracker->snr_threshold);
+}
+
+/**
+ * Set the SNR a spectral peak must reach over the noise floor
+ * 
+ * @param snr_ratio: Magnitude ratio (3.0 = ~9.5 dB)
+ * @param subtract: 1 to apply spectral subtraction before the peak search
+ */
+void audio_processing_set_noise_options(float snr_ratio, int subtract) {
+	default_analyzer.noise_tracker.snr_threshold = snr_ratio;
+	default_analyzer.spectral_subtraction = subtract;
+}
+
+/**
+ * Add the second golden-section search on the long frame (off by default)
+ */
+void audio_processing_set_long_refinement(int enable) {
+	audio_analyzer_set_long_refinement(&default_analyzer, enable);
+}
+
+void audio_analyzer_set_long_refinement(audio_analyzer_t* analyzer, int enable) {
+	analyzer->long_refinement = enable;
+}
+
+/**
+ * Select the mains hum notch for the streaming front end
+ * Restarts detection/tracking and clears the stream window
+ */
+void audio_processing_set_hum_notch(hum_notch_mode_t mode) {
+	audio_analyzer_set_hum_notch(&default_analyzer, mode);
+}
+
+void audio_analyzer_set_hum_notch(audio_analyzer_t* analyzer, hum_notch_mode_t mode) {
+	hum_notch_init(&analyzer->hum_filter, mode, (float)SAMPLE_RATE);
+	biquad_cascade_reset(&analyzer->prefilter);
+	analyzer->stream_fill = 0;
+}
+
+/**
+ * Mains frequency the notch bank is locked to (0.0 if none)
+ */
+float audio_processing_mains_hz(void) {
+	return hum_notch_mains_hz(&default_analyzer.hum_filter);
+}
+
+/**
+ * Harmonic confidence of the most recent apply_fft() frame
+ */
+float audio_processing_last_confidence(void) {
+	return default_analyzer.last_confidence;
+}
+
+/**
+ * Amplitude gate that follows the room instead of a fixed MIN_AMPLITUDE
+ * 
+ * Converts the tracked noise floor back to a time-domain RMS (white noise
+ * of variance s^2 gives bin power s^2 * sum(w^2) after the Hann window) and
+ * requires the frame peak to clear roughly 3 sigma of it. Until the tracker
+ * has seen enough frames the fixed MIN_AMPLITUDE is used.
+ */
+static int adaptive_amplitude_gate(const noise_floor_t* noise_tracker) {
+	if (!noise_floor_ready(noise_tracker)) {
+		return MIN_AMPLITUDE;
+	}
+	
+	float sigma = sqrtf(noise_floor_broadband_power(noise_tracker) / HANN_POWER_GAIN) * 32768.0f;
+	int gate = (int)(3.0f * sigma);
+	return (gate < MIN_AMPLITUDE_QUIET) ? MIN_AMPLITUDE_QUIET : gate;
 }
 
 /**
@@ -148,6 +285,29 @@ static void apply_hann_window(float* data, int num_samples) {
 	}
 }
 
+/**
+ * Newest `size` samples of a frame (all of them if fewer), mean removed,
+ * normalized to [-1, 1] and Hann-windowed
+ * 
+ * @return: Number of samples written to `output`
+ */
+static uint32_t window_newest(const int16_t* samples, int num_samples, float* output, uint32_t size) {
+	if ((uint32_t)num_samples < size) {
+		size = (uint32_t)num_samples;
+	}
+	const int16_t* newest = samples + (num_samples - size);
+	float mean = 0.0f;
+	for (uint32_t i = 0; i < size; i++) {
+		mean += newest[i];
+	}
+	mean /= (float)size;
+	for (uint32_t i = 0; i < size; i++) {
+		output[i] = ((float)newest[i] - mean) / 32768.0f;
+	}
+	apply_hann_window(output, (int)size);
+	return size;
+}
+
 /**
  * Remove DC offset from audio samples
  * DC offset can skew FFT results, so we subtract the mean
@@ -204,15 +364,17 @@ void apply_gain(int16_t* samples, int num_samples, float gain_factor) {
  * @param magnitude: Array of magnitude values for each frequency bin (output of FFT)
  * @param num_bins: Number of frequency bins (128 for 256-point FFT)
  * @param sampling_rate: Sample rate in Hz (10000 Hz)
+ * @param noise_tracker: Noise floor of the stream the frame belongs to
  * @return: Detected frequency in Hz (0.0 if no valid peak found)
  */
-static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uint32_t sampling_rate) {
+static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uint32_t sampling_rate,
+                                  const noise_floor_t* noise_tracker) {
 	uint32_t peak_bin = 0;
 	float peak_magnitude = 0.0f;
 	
 	/* Calculate bin count for 2000 Hz (accommodates all detectable frequencies)
 	   EXAMPLE: 2000 Hz / (10000 Hz / 256 bins) = 2000 * 256 / 10000 = 51.2 bins */
-	uint32_t search_limit = (num_bins * 2000) / sampling_rate;
+	uint32_t search_limit = (num_bins * PEAK_SEARCH_MAX_HZ) / sampling_rate;
 	if (search_limit > num_bins) {
 		search_limit = num_bins;
 	}
@@ -225,8 +387,17 @@ static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uin
 		}
 	}
 	
-	/* No significant peak = no valid signal */
-	if (peak_magnitude < 0.5f) {  /* Lowered threshold from 1.0f to 0.5f for better sensitivity */
+	/* No significant peak = no valid signal. Once the noise tracker is primed
+	   the peak must stand SNR-times above the floor in its own bin instead of
+	   clearing a fixed level. */
+	float threshold = DEFAULT_PEAK_MAGNITUDE;
+	if (noise_floor_ready(noise_tracker)) {
+		threshold = noise_floor_threshold(noise_tracker, peak_bin);
+		if (threshold < MIN_PEAK_MAGNITUDE) {
+			threshold = MIN_PEAK_MAGNITUDE;
+		}
+	}
+	if (peak_bin == 0 || peak_magnitude < threshold) {
 		return 0.0;
 	}
 	
@@ -244,7 +415,8 @@ static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uin
  * 
  * STEP 1: Validate signal amplitude
  *    - Check if signal is strong enough to analyze
- *    - Reject noise (very weak signals below MIN_AMPLITUDE)
+ *    - Reject noise (below MIN_AMPLITUDE, or the adaptive gate once the
+ *      noise floor has been learned)
  * 
  * STEP 2: Convert samples to float and normalize
  *    - Input: int16_t PCM audio samples (-32768 to +32767)
@@ -266,6 +438,18 @@ static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uin
  *    - Call find_peak_frequency() to locate dominant frequency
  *    - Returns detected frequency in Hz
  * 
+ * STEP 6: Fine refinement
+ *    - The FFT peak is only a bin centre (+/-20 Hz); a golden-section
+ *      search of Goertzel probes on the windowed (unfiltered) frame places
+ *      it within a few cents (PEAK_REFINE_PROBES probes over 256 samples)
+ *    - With long refinement enabled, a second search on up to
+ *      ANALYZER_HISTORY_SIZE samples pins the low strings within a cent
+ * 
+ * STEP 7: Harmonic validation
+ *    - Reject frames whose partials do not stand out of the valleys
+ *      between them (claps, breath, speech, handling noise), judged on
+ *      up to ANALYZER_VALIDATION_SIZE samples so E2's valleys are resolved
+ * 
  * EXAMPLE FLOW:
  *    Input: 1024 audio samples of A2 string (110 Hz)
  *         ↓
@@ -278,7 +462,9 @@ static double find_peak_frequency(const float *magnitude, uint32_t num_bins, uin
  *    Compute magnitudes: |X(0)|, |X(1)|, |X(2)|, |X(3)|, ...
  *    Where |X(3)| is highest because bin 3 ≈ 117 Hz ≈ A2
  *         ↓
- *    find_peak_frequency() finds bin 3, converts to 110 Hz
+ *    find_peak_frequency() finds bin 3 (117 Hz)
+ *         ↓
+ *    Goertzel probes between 94 and 141 Hz close in on 110 Hz
  *         ↓
  *    Output: 110.0 Hz
  * 
@@ -292,6 +478,26 @@ double apply_fft(const int16_t* samples, int num_samples) {
 		printf("ERROR: FFT not initialized!\n");
 		return 0.0;
 	}
+	return audio_analyzer_apply_fft(&default_analyzer, samples, num_samples);
+}
+
+/**
+ * Frame analysis shared by the one-shot and streaming entry points
+ * 
+ * @param prefilter_frame: 1 to run the pre-filter over this frame from rest
+ *                         (one-shot frames); 0 when the streaming front end
+ *                         has already filtered the samples continuously
+ */
+static double analyze_frame(audio_analyzer_t* analyzer, const int16_t* samples, int num_samples,
+                            int prefilter_frame) {
+	float fft_real[FFT_SIZE];                   /* Real component of FFT output */
+	float fft_imag[FFT_SIZE];                   /* Imaginary component of FFT output */
+	float magnitude_spectrum[FFT_SIZE / 2];     /* Magnitude of each frequency bin (128 bins) */
+	float clean_spectrum[FFT_SIZE / 2];         /* Noise-subtracted copy of magnitude_spectrum */
+	float windowed[FFT_SIZE];                   /* Windowed frame kept for the fine refinement */
+	float validation[ANALYZER_VALIDATION_SIZE]; /* Windowed frame for the harmonic validation */
+	float history[ANALYZER_HISTORY_SIZE];       /* Windowed long frame (opt-in refinement) */
+	noise_floor_t* noise_tracker = &analyzer->noise_tracker;
 	
 	if (samples == NULL || num_samples == 0) {
 		return 0.0;
@@ -299,7 +505,8 @@ double apply_fft(const int16_t* samples, int num_samples) {
 	
 	/* ========== STEP 1: Check signal amplitude ==========
 	   Find the maximum absolute value in the sample buffer.
-	   If signal is too weak, reject it as noise (return 0.0) */
+	   If signal is too weak it is noise: no note is searched for, but the
+	   frame is still transformed so the noise floor learns the quiet room */
 	int max_amplitude = 0;
 	for (int i = 0; i < num_samples; i++) {
 		int amplitude = abs(samples[i]);
@@ -308,20 +515,19 @@ double apply_fft(const int16_t* samples, int num_samples) {
 		}
 	}
 	
-	if (max_amplitude < MIN_AMPLITUDE) {
-		return 0.0; /* Signal too weak - likely noise or no guitar playing */
-	}
+	int below_gate = (max_amplitude < adaptive_amplitude_gate(noise_tracker));
 	
 	/* ========== STEP 2: Convert int16_t to float32 ==========
 	   The FFT requires floating-point input. We:
-	   - Use only FFT_SIZE (256) samples for efficiency
+	   - Use only the newest FFT_SIZE (256) samples for efficiency
 	   - Divide by 32768.0f to normalize to [-1, 1] range
 	   - Pad with zeros if fewer samples provided
 	   - Apply Hann window to reduce spectral leakage */
 	uint32_t fft_input_size = (num_samples < FFT_SIZE) ? num_samples : FFT_SIZE;
+	const int16_t* fft_samples = samples + (num_samples - fft_input_size);
 	
 	for (uint32_t i = 0; i < fft_input_size; i++) {
-		fft_real[i] = (float)samples[i] / 32768.0f;
+		fft_real[i] = (float)fft_samples[i] / 32768.0f;
 		fft_imag[i] = 0.0f;  /* Imaginary part starts at zero for real input */
 	}
 	
@@ -331,6 +537,28 @@ double apply_fft(const int16_t* samples, int num_samples) {
 		fft_imag[i] = 0.0f;
 	}
 	
+	/* The refinement probes the frame as handed in: for one-shot frames that
+	   is before the pre-filter, which starts from rest, rings near its
+	   corner for the first few milliseconds and would pull the low strings
+	   flat. The mean stands in for its DC rejection. */
+	float mean = 0.0f;
+	for (uint32_t i = 0; i < fft_input_size; i++) {
+		mean += fft_real[i];
+	}
+	mean = (fft_input_size > 0) ? mean / (float)fft_input_size : 0.0f;
+	for (uint32_t i = 0; i < FFT_SIZE; i++) {
+		windowed[i] = (i < fft_input_size) ? fft_real[i] - mean : 0.0f;
+	}
+	apply_hann_window(windowed, FFT_SIZE);
+	
+	/* Pre-filter before windowing. Each apply_fft() call is an independent
+	   frame, so the filter starts from rest; the streaming front end keeps
+	   the cascade running across blocks and hands over filtered samples. */
+	if (prefilter_frame) {
+		biquad_cascade_reset(&analyzer->prefilter);
+		biquad_cascade_process(&analyzer->prefilter, fft_real, fft_real, fft_input_size);
+	}
+	
 	/* Apply Hann window to reduce spectral leakage */
 	apply_hann_window(fft_real, FFT_SIZE);
 	
@@ -374,6 +602,14 @@ double apply_fft(const int16_t* samples, int num_samples) {
 		magnitude_spectrum[i] = sqrtf(fft_real[i] * fft_real[i] + fft_imag[i] * fft_imag[i]);
 	}
 	
+	/* Signal too weak - likely noise or no guitar playing. The whole
+	   spectrum is noise, so every bin updates the floor. */
+	if (below_gate) {
+		analyzer->last_confidence = 0.0f;
+		noise_floor_update(noise_tracker, magnitude_spectrum, 0);
+		return 0.0;
+	}
+	
 	/* ========== STEP 5: Find peak frequency ==========
 	   Call find_peak_frequency() which:
 	   - Searches for the bin with highest magnitude
@@ -381,13 +617,152 @@ double apply_fft(const int16_t* samples, int num_samples) {
 	   - Returns the detected fundamental frequency
 	   
 	   OUTPUT: Detected frequency in Hz (or 0.0 if no peak found) */
-	double detected_freq = find_peak_frequency(magnitude_spectrum, num_bins, SAMPLE_RATE);
+	const float* search_spectrum = magnitude_spectrum;
+	if (analyzer->spectral_subtraction && noise_floor_ready(noise_tracker)) {
+		memcpy(clean_spectrum, magnitude_spectrum, sizeof(clean_spectrum));
+		noise_floor_subtract(noise_tracker, clean_spectrum, 1.5f, 0.1f);
+		search_spectrum = clean_spectrum;
+	}
+	
+	double detected_freq = find_peak_frequency(search_spectrum, num_bins, SAMPLE_RATE, noise_tracker);
+	
+	/* Learn the noise floor from this frame before any further rejection,
+	   holding out the peak (and its harmonics) whether or not it passes */
+	uint32_t note_bin = (uint32_t)(detected_freq * FFT_SIZE / SAMPLE_RATE + 0.5);
+	noise_floor_update(noise_tracker, magnitude_spectrum, note_bin);
+	
+	/* ========== STEP 6: Fine refinement ==========
+	   The peak bin only places the note within +/-20 Hz (A2 reads 117 Hz).
+	   Inside the Hann main lobe |X(f)| has a single maximum, so a
+	   golden-section search of single-frequency Goertzel probes on the
+	   windowed frame finds it: PEAK_REFINE_PROBES dot products instead of a
+	   longer FFT.
+	   On 256 samples E2's main lobe overlaps its own negative-frequency
+	   image and its second harmonic, which drag the maximum by several
+	   cents from frame to frame. On the long frame both sit many lobe
+	   widths away, so the opt-in second search there, bracketed by one of
+	   its bins (the first estimate is well inside that), settles the low
+	   strings at four times the cost. */
+	if (detected_freq > 0.0) {
+		const double bin_hz = (double)SAMPLE_RATE / FFT_SIZE;
+		detected_freq = golden_section_peak(windowed, FFT_SIZE, SAMPLE_RATE,
+		                                    detected_freq - PEAK_REFINE_HALF_BINS * bin_hz,
+		                                    detected_freq + PEAK_REFINE_HALF_BINS * bin_hz,
+		                                    PEAK_REFINE_PROBES);
+		if (analyzer->long_refinement && num_samples > FFT_SIZE) {
+			uint32_t history_size = window_newest(samples, num_samples, history, ANALYZER_HISTORY_SIZE);
+			const double history_bin_hz = (double)SAMPLE_RATE / history_size;
+			detected_freq = golden_section_peak(history, history_size, SAMPLE_RATE,
+			                                    detected_freq - history_bin_hz,
+			                                    detected_freq + history_bin_hz,
+			                                    PEAK_REFINE_PROBES);
+		}
+	}
+	
+	/* ========== STEP 7: Harmonic validation ==========
+	   A string's energy sits on lines at its partials with quiet valleys in
+	   between; claps and speech fill the valleys. The partials are probed at
+	   the refined frequency (a bin centre would miss the upper ones) on the
+	   newest ANALYZER_VALIDATION_SIZE samples, where E2's valleys are
+	   resolved. Frames that do not look like a string are dropped here, so
+	   callers skip string matching and feedback for them. */
+	analyzer->last_confidence = 0.0f;
+	if (detected_freq > 0.0) {
+		uint32_t validation_size = window_newest(samples, num_samples, validation, ANALYZER_VALIDATION_SIZE);
+		analyzer->last_confidence = harmonic_validation_score(validation, validation_size, SAMPLE_RATE, detected_freq);
+		if (analyzer->last_confidence < HARMONIC_CONFIDENCE_MIN) {
+			detected_freq = 0.0;
+		}
+	}
 	
 	/* Return result - no debug print (already validated by tests) */
 	return detected_freq;
 }
 
+double audio_analyzer_apply_fft(audio_analyzer_t* analyzer, const int16_t* samples, int num_samples) {
+	return analyze_frame(analyzer, samples, num_samples, 1);
+}
+
+/**
+ * Streaming front end: feed contiguous capture blocks of any size
+ * 
+ * Unlike apply_fft(), which treats every call as an independent frame, this
+ * keeps state across calls so the adaptive hum notch can lock onto the
+ * mains phase and the pre-filter runs without restarting (no start-up
+ * ringing in every frame). Filtered samples collect in a sliding window of
+ * up to ANALYZER_HISTORY_SIZE and a frame is analyzed every STREAM_HOP samples:
+ * 
+ *    block -> hum notch -> pre-filter -> sliding window -> frame (FFT, peak)
+ * 
+ * @param block: Contiguous audio samples (int16_t PCM)
+ * @param num_samples: Number of samples in block
+ * @param detected_frequency: Latest frame result (0.0 if that frame had no valid signal)
+ * @return: 1 if at least one frame was analyzed during this call, 0 otherwise
+ */
+int audio_processing_process_block(const int16_t* block, int num_samples, double* detected_frequency) {
+	return audio_analyzer_process_block(&default_analyzer, block, num_samples, detected_frequency);
+}
+
+int audio_analyzer_process_block(audio_analyzer_t* analyzer, const int16_t* block, int num_samples,
+                                 double* detected_frequency) {
+	int16_t* stream_window = analyzer->stream_window;
+	float chunk[STREAM_CHUNK];
+	int analyzed = 0;
+	
+	for (int offset = 0; offset < num_samples; offset += STREAM_CHUNK) {
+		uint32_t count = (num_samples - offset < STREAM_CHUNK) ? (uint32_t)(num_samples - offset) : STREAM_CHUNK;
+		
+		for (uint32_t i = 0; i < count; i++) {
+			chunk[i] = (float)block[offset + i] / 32768.0f;
+		}
+		hum_notch_process(&analyzer->hum_filter, chunk, count);
+		biquad_cascade_process(&analyzer->prefilter, chunk, chunk, count);
+		
+		for (uint32_t i = 0; i < count; i++) {
+			int32_t value = (int32_t)lrintf(chunk[i] * 32768.0f);
+			stream_window[analyzer->stream_fill++] = (int16_t)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+			
+			/* The first frame goes out once an FFT's worth is in; the window
+			   keeps growing to ANALYZER_HISTORY_SIZE and then slides */
+			if (analyzer->stream_fill >= FFT_SIZE && (analyzer->stream_fill - FFT_SIZE) % STREAM_HOP == 0) {
+				*detected_frequency = analyze_frame(analyzer, stream_window, (int)analyzer->stream_fill, 0);
+				hum_notch_set_note(&analyzer->hum_filter, (float)*detected_frequency);
+				analyzed = 1;
+				if (analyzer->stream_fill == ANALYZER_HISTORY_SIZE) {
+					memmove(stream_window, &stream_window[STREAM_HOP],
+					        (ANALYZER_HISTORY_SIZE - STREAM_HOP) * sizeof(int16_t));
+					analyzer->stream_fill = ANALYZER_HISTORY_SIZE - STREAM_HOP;
+				}
+			}
+		}
+	}
+	return analyzed;
+}
+
+/**
+ * Capture audio and detect the fundamental
+ * 
+ * With the capture driver running (no callback registered), every queued
+ * microphone block goes through the streaming front end and the latest
+ * frame's result is reported. Without it, a synthetic 440 Hz frame is
+ * analyzed so the pipeline can still be exercised on a bench.
+ */
 int audio_processing_capture(double* detected_frequency) {
+	if (audio_capture_is_running()) {
+		int16_t block[AUDIO_CAPTURE_BLOCK_SIZE];
+		double freq = 0.0;
+		int analyzed = 0;
+		
+		while (audio_capture_read_block(block)) {
+			analyzed |= audio_processing_process_block(block, AUDIO_CAPTURE_BLOCK_SIZE, &freq);
+		}
+		if (analyzed && freq > 0) {
+			*detected_frequency = freq;
+			return 1;
+		}
+		return 0;
+	}
+	
 	int16_t samples[SAMPLE_SIZE];
 	for (int i = 0; i < SAMPLE_SIZE; i++) {
 		samples[i] = (int16_t)(1000 * sinf(2 * PI * 440.0 * i / SAMPLE_RATE));
@@ -3,18 +3,34 @@
  *
  * Generates appropriate audio feedback based on tuning results
  * Plays note names, cent values, and tuning directions
- * Implements dynamic beep rate feedback based on tuning accuracy
+ * Implements dynamic beep rate feedback based on tuning accuracy; beeps are
+ * scheduled in sample time and fired by the output block callback
+ *
+ * A phrase whose clips are all in the prompt cache is queued as one
+ * playlist and spliced sample-accurately in the audio update; otherwise each
+ * step waits for the previous clip to finish instead of blocking on the SD card.
  */
 
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
 #include "audio_sequencer.h"
+#include "prompt_cache.h"
+#include "tone_synth.h"
+#include "feedback_scheduler.h"
 
-static int is_playing = 0;
+static volatile int is_playing = 0;
 static const TuningResult* current_result = NULL;
 static int playback_step = 0;
 
+/* "[String] [Cents] [Direction]" for the current result */
+static const char* phrase[SEQUENCER_MAX_PHRASE_CLIPS];
+static int phrase_length = 0;
+static int phrase_queued = 0;           // Whole phrase handed to the prompt cache
+
+static audio_feedback_done_fn done_callback = NULL;
+static void* done_context = NULL;
+
 /* ============================================================================
  * DYNAMIC BEEP RATE FEEDBACK
  * ========================================================================== */
@@ -44,9 +60,10 @@ static const BeepRateConfig beep_rates[] = {
 
 #define NUM_BEEP_RATES (sizeof(beep_rates) / sizeof(BeepRateConfig))
 
-/* State for beep timing */
-static uint32_t last_beep_time = 0;
-static uint32_t beep_end_time = 0;
+/* State for beep timing: what is currently scheduled */
+#define BEEP_EVENT_TAG 1
+static uint32_t scheduled_interval = 0;
+static float scheduled_pitch = 0.0f;
 static int beeping_active = 0;
 
 /**
@@ -73,6 +90,49 @@ uint32_t calculate_beep_interval(double cents_offset) {
 	return 0;
 }
 
+/**
+ * Beep pitch encodes the tuning direction
+ * 
+ * @return: BEEP_PITCH_SHARP_HZ when the note is too high (tune down),
+ *          BEEP_PITCH_FLAT_HZ when it is too low (tune up)
+ */
+float get_beep_pitch(double cents_offset) {
+	return (cents_offset > 0.0) ? BEEP_PITCH_SHARP_HZ : BEEP_PITCH_FLAT_HZ;
+}
+
+/**
+ * Start, retime or stop the repeating beep for `result`
+ * A running beep train is left alone while interval and pitch are unchanged,
+ * so its rhythm is not restarted by every new detection
+ */
+static void schedule_beeps(const TuningResult* result) {
+	uint32_t beep_interval = (result != NULL) ? calculate_beep_interval(result->cents_offset) : 0;
+	
+	if (beep_interval == 0) {
+		if (beeping_active) {
+			feedback_cancel(BEEP_EVENT_TAG);
+			tone_synth_stop();
+		}
+		beeping_active = 0;
+		scheduled_interval = 0;
+		return;
+	}
+	
+	float pitch = get_beep_pitch(result->cents_offset);
+	if (beeping_active && beep_interval == scheduled_interval && pitch == scheduled_pitch) {
+		return;
+	}
+	
+	/* First beep on the next output block, then every interval to the sample */
+	tone_pattern_t beep;
+	tone_synth_pattern(&beep, pitch, BEEP_DURATION_MS, 0, 1, BEEP_LEVEL);
+	feedback_cancel(BEEP_EVENT_TAG);
+	feedback_schedule_beep(feedback_scheduler_now(), feedback_ms_to_samples(beep_interval), &beep, BEEP_EVENT_TAG);
+	beeping_active = 1;
+	scheduled_interval = beep_interval;
+	scheduled_pitch = pitch;
+}
+
 /**
  * Generate dynamic beep feedback based on tuning accuracy
  * 
@@ -84,24 +144,15 @@ uint32_t calculate_beep_interval(double cents_offset) {
  * @param result: Current tuning result with cents_offset
  */
 void generate_dynamic_beep_feedback(const TuningResult* result) {
-	if (result == NULL) {
-		beeping_active = 0;
-		return;
-	}
-	
-	uint32_t beep_interval = calculate_beep_interval(result->cents_offset);
+	uint32_t beep_interval = (result != NULL) ? calculate_beep_interval(result->cents_offset) : 0;
 	
-	if (beep_interval == 0) {
-		/* In tune - stop beeping */
-		beeping_active = 0;
+	if (result != NULL && beep_interval == 0) {
 		printf("[BEEP] In tune! No beeping.\n");
-	} else {
-		beeping_active = 1;
-		last_beep_time = 0;  /* Force immediate first beep */
-		printf("[BEEP] Starting dynamic beeps at %ld ms interval (offset: %.1f cents)\n", 
-		       beep_interval, result->cents_offset);
+	} else if (result != NULL && (!beeping_active || beep_interval != scheduled_interval)) {
+		printf("[BEEP] Starting dynamic beeps at %lu ms interval (offset: %.1f cents)\n", 
+		       (unsigned long)beep_interval, result->cents_offset);
 	}
-	
+	schedule_beeps(result);
 	current_result = result;
 }
 
@@ -111,12 +162,20 @@ void audio_sequencer_init(void) {
 	printf("  - Dynamic beep mode: generate_dynamic_beep_feedback()\n");
 	is_playing = 0;
 	playback_step = 0;
+	phrase_length = 0;
+	phrase_queued = 0;
 	beeping_active = 0;
-	last_beep_time = 0;
-	beep_end_time = 0;
+	scheduled_interval = 0;
+	scheduled_pitch = 0.0f;
+	tone_synth_init();
+	feedback_scheduler_init();
 }
 
 void play_audio_file(const char* filename) {
+	/* Cached prompts start on the next audio block, no SD access */
+	if (prompt_cache_play(filename)) {
+		return;
+	}
 	printf("[AUDIO] Playing: %s\n", filename);
 }
 
@@ -145,93 +204,111 @@ const char* get_cents_filename(double cents) {
 	}
 }
 
+/**
+ * Fill `clips` with the phrase for `result`, in playback order
+ * Pure: sessions that only need the decision (no playback) call it directly
+ */
+int audio_sequencer_build_phrase(const TuningResult* result, const char** clips) {
+	return audio_sequencer_build_phrase_parts(result, SEQUENCER_PART_ALL, clips);
+}
+
+int audio_sequencer_build_phrase_parts(const TuningResult* result, int parts, const char** clips) {
+	int count = 0;
+	const char* string_file = get_string_filename(result->detected_string);
+	if (string_file && (parts & SEQUENCER_PART_STRING)) {
+		clips[count++] = string_file;
+	}
+	if (!(parts & SEQUENCER_PART_OFFSET)) {
+		return count;
+	}
+	if (strcmp(result->direction, "IN_TUNE") != 0) {
+		const char* cents_file = get_cents_filename(result->cents_offset);
+		if (cents_file) {
+			clips[count++] = cents_file;
+		}
+		if (strcmp(result->direction, "UP") == 0) {
+			clips[count++] = FILE_UP;
+		} else if (strcmp(result->direction, "DOWN") == 0) {
+			clips[count++] = FILE_DOWN;
+		}
+	} else {
+		clips[count++] = FILE_IN_TUNE;
+	}
+	return count;
+}
+
+/**
+ * Playlist finished - runs in the audio update
+ */
+static void phrase_done(void* context) {
+	(void)context;
+	is_playing = 0;
+	if (done_callback != NULL) {
+		done_callback(done_context);
+	}
+}
+
+void audio_sequencer_on_complete(audio_feedback_done_fn callback, void* context) {
+	done_callback = callback;
+	done_context = context;
+}
+
+int audio_sequencer_is_playing(void) {
+	return is_playing;
+}
+
 void generate_audio_feedback(const TuningResult* result) {
+	generate_audio_feedback_parts(result, SEQUENCER_PART_ALL);
+}
+
+void generate_audio_feedback_parts(const TuningResult* result, int parts) {
 	printf("Generating audio feedback...\n");
 	current_result = result;
-	is_playing = 1;
 	playback_step = 0;
+	phrase_length = (result != NULL) ? audio_sequencer_build_phrase_parts(result, parts, phrase) : 0;
+	is_playing = (phrase_length > 0);
+	
+	/* Whole phrase from RAM: no gaps, no further polling */
+	phrase_queued = is_playing &&
+		prompt_cache_play_list(phrase, phrase_length, SEQUENCER_CROSSFADE_SAMPLES, phrase_done, NULL);
+	
+	/* Start the first clip now rather than on the next loop pass */
+	audio_sequencer_update();
 }
 
 void audio_sequencer_update(void) {
-	if (!is_playing || current_result == NULL) {
+	if (!is_playing || phrase_queued) {
+		return;             // Idle, or the prompt cache reports completion itself
+	}
+	/* Let the current prompt finish before the next step */
+	if (prompt_cache_is_playing()) {
 		return;
 	}
-	switch (playback_step) {
-		case 0: {
-			const char* string_file = get_string_filename(current_result->detected_string);
-			if (string_file) {
-				play_audio_file(string_file);
-			}
-			playback_step++;
-			break;
-		}
-		case 1:
-			if (strcmp(current_result->direction, "IN_TUNE") != 0) {
-				const char* cents_file = get_cents_filename(current_result->cents_offset);
-				if (cents_file) {
-					play_audio_file(cents_file);
-				}
-			}
-			playback_step++;
-			break;
-		case 2:
-			if (strcmp(current_result->direction, "IN_TUNE") != 0) {
-				const char* direction_file = NULL;
-				if (strcmp(current_result->direction, "UP") == 0) {
-					direction_file = FILE_UP;
-				} else if (strcmp(current_result->direction, "DOWN") == 0) {
-					direction_file = FILE_DOWN;
-				}
-				if (direction_file) {
-					play_audio_file(direction_file);
-				}
-			} else {
-				play_audio_file(FILE_IN_TUNE);
-			}
-			playback_step++;
-			break;
-		default:
-			is_playing = 0;
-			playback_step = 0;
-			printf("Audio feedback complete.\n");
-			break;
+	if (playback_step < phrase_length) {
+		play_audio_file(phrase[playback_step++]);
+		return;
+	}
+	is_playing = 0;
+	playback_step = 0;
+	printf("Audio feedback complete.\n");
+	if (done_callback != NULL) {
+		done_callback(done_context);
 	}
 }
 
 /**
- * Update dynamic beep feedback based on current time
+ * Re-check the beep rate against the current result
  * 
- * Call this frequently (e.g., every 10-50 ms) in your main loop
- * to maintain accurate beep timing.
+ * Beep timing no longer depends on this call: beeps are fired on their
+ * sample by feedback_scheduler_render(). Calling it is only needed when the
+ * TuningResult passed to generate_dynamic_beep_feedback() is updated in place.
  * 
- * @param current_time_ms: Current system time in milliseconds
- * 
- * Example usage in main loop:
- *   static uint32_t last_ms = 0;
- *   uint32_t now = millis();
- *   if (now >= last_ms + 10) {
- *       audio_sequencer_update_beeps(now);
- *       last_ms = now;
- *   }
+ * @param current_time_ms: Unused, kept for existing callers
  */
 void audio_sequencer_update_beeps(uint32_t current_time_ms) {
-	if (!beeping_active || current_result == NULL) {
+	(void)current_time_ms;
+	if (current_result == NULL) {
 		return;
 	}
-	
-	uint32_t beep_interval = calculate_beep_interval(current_result->cents_offset);
-	
-	if (beep_interval == 0) {
-		/* Tuning changed to in-tune, stop beeping */
-		beeping_active = 0;
-		return;
-	}
-	
-	/* Check if it's time for a new beep */
-	if (current_time_ms >= last_beep_time + beep_interval) {
-		/* Time to beep! */
-		printf("[BEEP]\n");  /* Placeholder - actual implementation would call tone/beep hardware */
-		last_beep_time = current_time_ms;
-		beep_end_time = current_time_ms + 50;  /* Beep duration: 50 ms */
-	}
+	schedule_beeps(current_result);
 }
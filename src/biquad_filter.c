@@ -0,0 +1,106 @@
+/**
+ * biquad_filter.c - Biquad IIR cascade implementation
+ *
+ * Coefficients come from the RBJ audio-EQ cookbook bilinear-transform
+ * formulas. A 4th-order Butterworth response is built from two sections
+ * with Q = 0.5412 and Q = 1.3066 (poles at 67.5 and 22.5 degrees).
+ */
+
+#include <math.h>
+#include <string.h>
+#include "biquad_filter.h"
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+
+/* Section Qs of a 4th-order Butterworth filter */
+static const float butterworth4_q[2] = {0.54119610f, 1.30656296f};
+
+/**
+ * Fill one stage with a high-pass or low-pass section
+ * Stores {b0, b1, b2, -a1, -a2} normalized by a0 (CMSIS df2T layout)
+ */
+static void design_section(float* c, int highpass, float corner_hz, float q, float sample_rate) {
+	float w0 = 2.0f * PI * corner_hz / sample_rate;
+	float cos_w0 = cosf(w0);
+	float alpha = sinf(w0) / (2.0f * q);
+	float a0 = 1.0f + alpha;
+
+	if (highpass) {
+		c[0] = (1.0f + cos_w0) / 2.0f / a0;
+		c[1] = -(1.0f + cos_w0) / a0;
+		c[2] = c[0];
+	} else {
+		c[0] = (1.0f - cos_w0) / 2.0f / a0;
+		c[1] = (1.0f - cos_w0) / a0;
+		c[2] = c[0];
+	}
+	c[3] = 2.0f * cos_w0 / a0;          /* -a1 / a0 */
+	c[4] = -(1.0f - alpha) / a0;        /* -a2 / a0 */
+}
+
+void biquad_cascade_design(biquad_cascade_t* cascade, prefilter_mode_t mode,
+                           float low_hz, float high_hz, float sample_rate) {
+	uint32_t stage = 0;
+
+	memset(cascade, 0, sizeof(*cascade));
+
+	if (mode == PREFILTER_HIGHPASS || mode == PREFILTER_BANDPASS) {
+		for (int i = 0; i < 2; i++) {
+			design_section(&cascade->coeffs[5 * stage++], 1, low_hz, butterworth4_q[i], sample_rate);
+		}
+	}
+	if (mode == PREFILTER_BANDPASS && high_hz < 0.5f * sample_rate) {
+		for (int i = 0; i < 2; i++) {
+			design_section(&cascade->coeffs[5 * stage++], 0, high_hz, butterworth4_q[i], sample_rate);
+		}
+	}
+	cascade->num_stages = stage;
+
+#ifdef __arm__
+	if (stage > 0) {
+		arm_biquad_cascade_df2T_init_f32(&cascade->arm_instance, (uint8_t)stage,
+		                                 cascade->coeffs, cascade->state);
+	}
+#endif
+}
+
+void biquad_cascade_reset(biquad_cascade_t* cascade) {
+	memset(cascade->state, 0, sizeof(cascade->state));
+}
+
+void biquad_cascade_process(biquad_cascade_t* cascade, const float* input, float* output, uint32_t num_samples) {
+	if (cascade->num_stages == 0) {
+		if (output != input) {
+			memmove(output, input, num_samples * sizeof(float));
+		}
+		return;
+	}
+
+#ifdef __arm__
+	/* CMSIS-DSP reads input and state before writing, so in-place is fine */
+	arm_biquad_cascade_df2T_f32(&cascade->arm_instance, (float*)input, output, num_samples);
+#else
+	/* Portable transposed direct form II - same arithmetic as the CMSIS version */
+	const float* src = input;
+	for (uint32_t s = 0; s < cascade->num_stages; s++) {
+		const float* c = &cascade->coeffs[5 * s];
+		float b0 = c[0], b1 = c[1], b2 = c[2], a1 = c[3], a2 = c[4];
+		float d1 = cascade->state[2 * s];
+		float d2 = cascade->state[2 * s + 1];
+
+		for (uint32_t n = 0; n < num_samples; n++) {
+			float x = src[n];
+			float y = b0 * x + d1;
+			d1 = b1 * x + a1 * y + d2;
+			d2 = b2 * x + a2 * y;
+			output[n] = y;
+		}
+
+		cascade->state[2 * s] = d1;
+		cascade->state[2 * s + 1] = d2;
+		src = output;   /* Later stages run in place on the output */
+	}
+#endif
+}
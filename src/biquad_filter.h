@@ -0,0 +1,72 @@
+/**
+ * biquad_filter.h - Biquad IIR cascade for the analysis front end
+ *
+ * Second-order sections in transposed direct form II, the same structure and
+ * coefficient layout as CMSIS-DSP's arm_biquad_cascade_df2T_f32. On Teensy the
+ * CMSIS routine does the filtering; on native builds a portable loop with
+ * identical arithmetic is used, so both platforms produce the same output.
+ *
+ * Coefficients per stage: {b0, b1, b2, a1, a2} where the difference equation is
+ *   y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] + a1*y[n-1] + a2*y[n-2]
+ * (a1/a2 are stored negated compared to the textbook form, as CMSIS expects).
+ */
+
+#ifndef BIQUAD_FILTER_H
+#define BIQUAD_FILTER_H
+
+#include <stdint.h>
+
+#ifdef __arm__
+#include <arm_math.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIQUAD_MAX_STAGES 4     /* 4th-order high-pass + 4th-order low-pass */
+
+/* Pre-filter shapes */
+typedef enum {
+	PREFILTER_OFF = 0,          /* Pass-through */
+	PREFILTER_HIGHPASS,         /* 4th-order Butterworth high-pass below the lowest string */
+	PREFILTER_BANDPASS          /* High-pass plus 4th-order Butterworth low-pass above the harmonics */
+} prefilter_mode_t;
+
+typedef struct {
+	uint32_t num_stages;
+	float coeffs[5 * BIQUAD_MAX_STAGES];
+	float state[2 * BIQUAD_MAX_STAGES];
+#ifdef __arm__
+	arm_biquad_cascade_df2T_instance_f32 arm_instance;
+#endif
+} biquad_cascade_t;
+
+/**
+ * Design a Butterworth pre-filter cascade
+ *
+ * @param cascade: Cascade to fill in (state is cleared)
+ * @param mode: PREFILTER_OFF, PREFILTER_HIGHPASS or PREFILTER_BANDPASS
+ * @param low_hz: High-pass corner frequency
+ * @param high_hz: Low-pass corner frequency (band-pass only)
+ * @param sample_rate: Sample rate in Hz
+ */
+void biquad_cascade_design(biquad_cascade_t* cascade, prefilter_mode_t mode,
+                           float low_hz, float high_hz, float sample_rate);
+
+/**
+ * Clear the filter state (delay lines) without touching coefficients
+ */
+void biquad_cascade_reset(biquad_cascade_t* cascade);
+
+/**
+ * Filter one block; state carries over to the next call
+ * Input and output may be the same buffer
+ */
+void biquad_cascade_process(biquad_cascade_t* cascade, const float* input, float* output, uint32_t num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIQUAD_FILTER_H */
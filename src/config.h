@@ -98,6 +98,9 @@ extern "C" {
 #define AUDIO_FILE_TUNE_DOWN    "/AUDIO/TUNE_DOWN.wav"
 #define AUDIO_FILE_IN_TUNE      "/AUDIO/IN_TUNE.wav"
 
+/* All prompts packed into one file (tools/prompt_packer) - preferred at startup */
+#define AUDIO_PROMPT_BUNDLE     "/AUDIO/PROMPTS.BIN"
+
 /* ============================================================================
  * DIGITAL SIGNAL PROCESSING (FFT)
  * ========================================================================== */
@@ -0,0 +1,225 @@
+/**
+ * cqt_analyzer.c - Constant-Q transform implementation
+ *
+ * By Parseval, the constant-Q bin sum_n x[n] * conj(k[n]) equals
+ * (1/N) sum_j X[j] * conj(K[j]); K is concentrated around the bin's
+ * frequency, so only that run of coefficients is stored and multiplied.
+ */
+
+#include "cqt_analyzer.h"
+#include "signal_processing.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+/* ============================================================================
+ * FFT
+ * ========================================================================== */
+
+static void fft(cqt_analyzer_t* cqt) {
+    float* re = cqt->re;
+    float* im = cqt->im;
+
+    for (uint32_t i = 0; i < CQT_FFT_SIZE; i++) {
+        uint32_t reversed = 0;
+        for (uint32_t b = 0, j = i; b < CQT_LOG2_SIZE; b++, j >>= 1) {
+            reversed = (reversed << 1) | (j & 1);
+        }
+        if (i < reversed) {
+            float tmp = re[i];
+            re[i] = re[reversed];
+            re[reversed] = tmp;
+            tmp = im[i];
+            im[i] = im[reversed];
+            im[reversed] = tmp;
+        }
+    }
+    for (uint32_t half = 1, stride = CQT_FFT_SIZE / 2; half < CQT_FFT_SIZE; half <<= 1, stride >>= 1) {
+        for (uint32_t i = 0; i < CQT_FFT_SIZE; i += 2 * half) {
+            for (uint32_t j = 0; j < half; j++) {
+                const float wr = cqt->twiddle_re[j * stride];
+                const float wi = cqt->twiddle_im[j * stride];
+                uint32_t a = i + j;
+                uint32_t b = a + half;
+                float tr = wr * re[b] - wi * im[b];
+                float ti = wr * im[b] + wi * re[b];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * INIT: SPARSE SPECTRAL KERNEL
+ * ========================================================================== */
+
+/**
+ * Transform one bin's temporal kernel and keep the run of coefficients
+ * above CQT_KERNEL_THRESHOLD of its peak
+ */
+static void build_kernel(cqt_analyzer_t* cqt, int bin) {
+    const double q = 1.0 / (pow(2.0, 1.0 / 12.0) - 1.0);
+    const double frequency = cqt->center_hz[bin];
+    int length = (int)lround(q * CQT_SAMPLE_RATE / frequency);
+    if (length > CQT_FFT_SIZE) {
+        length = CQT_FFT_SIZE;
+    }
+
+    /* Hann window scaled so a full-scale sinusoid at the bin reads 1.0 */
+    double window_sum = 0.0;
+    for (int m = 0; m < length; m++) {
+        window_sum += 0.5 * (1.0 - cos(2.0 * PI * m / length));
+    }
+    memset(cqt->re, 0, sizeof(cqt->re));
+    memset(cqt->im, 0, sizeof(cqt->im));
+    for (int m = 0; m < length; m++) {
+        double w = 0.5 * (1.0 - cos(2.0 * PI * m / length)) * 2.0 / window_sum;
+        double phase = 2.0 * PI * frequency * m / CQT_SAMPLE_RATE;
+        cqt->re[CQT_FFT_SIZE - length + m] = (float)(w * cos(phase));
+        cqt->im[CQT_FFT_SIZE - length + m] = (float)(w * sin(phase));
+    }
+    fft(cqt);
+
+    float peak = 0.0f;
+    for (int j = 0; j <= CQT_FFT_SIZE / 2; j++) {
+        float magnitude = sqrtf(cqt->re[j] * cqt->re[j] + cqt->im[j] * cqt->im[j]);
+        if (magnitude > peak) {
+            peak = magnitude;
+        }
+    }
+    int first = -1, last = -1;
+    for (int j = 0; j <= CQT_FFT_SIZE / 2; j++) {
+        if (sqrtf(cqt->re[j] * cqt->re[j] + cqt->im[j] * cqt->im[j]) >= peak * CQT_KERNEL_THRESHOLD) {
+            if (first < 0) {
+                first = j;
+            }
+            last = j;
+        }
+    }
+
+    uint32_t count = (uint32_t)(last - first + 1);
+    if (cqt->kernel_size + count > CQT_MAX_KERNEL) {
+        count = CQT_MAX_KERNEL - cqt->kernel_size;      // Not reached with the defaults
+    }
+    cqt->first[bin] = (uint16_t)first;
+    cqt->count[bin] = (uint16_t)count;
+    cqt->offset[bin] = (uint16_t)cqt->kernel_size;
+    for (uint32_t j = 0; j < count; j++) {
+        cqt->kernel_re[cqt->kernel_size + j] = cqt->re[first + j] / CQT_FFT_SIZE;
+        cqt->kernel_im[cqt->kernel_size + j] = -cqt->im[first + j] / CQT_FFT_SIZE;
+    }
+    cqt->kernel_size += count;
+}
+
+void cqt_analyzer_init(cqt_analyzer_t* cqt, const tuning_table_t* tuning) {
+    memset(cqt, 0, sizeof(*cqt));
+    if (tuning == NULL) {
+        tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    }
+    cqt->tuning = tuning;
+
+    for (int k = 0; k < CQT_FFT_SIZE / 2; k++) {
+        cqt->twiddle_re[k] = (float)cos(-2.0 * PI * k / CQT_FFT_SIZE);
+        cqt->twiddle_im[k] = (float)sin(-2.0 * PI * k / CQT_FFT_SIZE);
+    }
+    for (int b = 0; b < CQT_BINS; b++) {
+        cqt->center_hz[b] = (float)(CQT_LOWEST_HZ * pow(2.0, (b - CQT_GUARD_BINS) / 12.0));
+        build_kernel(cqt, b);
+    }
+}
+
+/* ============================================================================
+ * TRANSFORM
+ * ========================================================================== */
+
+void cqt_transform(cqt_analyzer_t* cqt, const int16_t* samples, int num_samples) {
+    int used = (num_samples < CQT_FFT_SIZE) ? num_samples : CQT_FFT_SIZE;
+    const int16_t* newest = samples + (num_samples - used);
+    float mean = 0.0f;
+
+    for (int n = 0; n < used; n++) {
+        mean += newest[n];
+    }
+    mean = (used > 0) ? mean / (float)used : 0.0f;
+
+    /* Kernels end at the newest sample, so the frame is filled from the end */
+    memset(cqt->re, 0, sizeof(cqt->re));
+    memset(cqt->im, 0, sizeof(cqt->im));
+    for (int n = 0; n < used; n++) {
+        cqt->re[CQT_FFT_SIZE - used + n] = (newest[n] - mean) / 32768.0f;
+    }
+    fft(cqt);
+
+    for (int b = 0; b < CQT_BINS; b++) {
+        const float* x_re = &cqt->re[cqt->first[b]];
+        const float* x_im = &cqt->im[cqt->first[b]];
+        const float* k_re = &cqt->kernel_re[cqt->offset[b]];
+        const float* k_im = &cqt->kernel_im[cqt->offset[b]];
+        float sum_re = 0.0f, sum_im = 0.0f;
+
+        for (uint32_t j = 0; j < cqt->count[b]; j++) {
+            sum_re += x_re[j] * k_re[j] - x_im[j] * k_im[j];
+            sum_im += x_re[j] * k_im[j] + x_im[j] * k_re[j];
+        }
+        cqt->magnitude[b] = sqrtf(sum_re * sum_re + sum_im * sum_im);
+    }
+}
+
+/* ============================================================================
+ * NOTE MAPPING
+ * ========================================================================== */
+
+static int is_peak(const float* magnitude, int bin) {
+    return bin >= 1 && bin < CQT_BINS - 1 &&
+           magnitude[bin] >= magnitude[bin - 1] && magnitude[bin] >= magnitude[bin + 1];
+}
+
+int cqt_analyze(cqt_analyzer_t* cqt, const int16_t* samples, int num_samples, cqt_result_t* result) {
+    static const int subharmonics[2] = { 12, 19 };     // Octave, octave + fifth (2nd, 3rd harmonic)
+    const float* magnitude = cqt->magnitude;
+
+    memset(result, 0, sizeof(*result));
+    result->note_index = -1;
+    if (samples == NULL || num_samples <= 0) {
+        return 0;
+    }
+    cqt_transform(cqt, samples, num_samples);
+
+    int best = -1;
+    for (int b = CQT_GUARD_BINS; b < CQT_GUARD_BINS + CQT_NOTES; b++) {
+        if (is_peak(magnitude, b) && (best < 0 || magnitude[b] > magnitude[best])) {
+            best = b;
+        }
+    }
+    if (best < 0 || magnitude[best] < CQT_MIN_MAGNITUDE) {
+        return 0;
+    }
+
+    /* A harmonic stronger than its fundamental: step down to the fundamental */
+    for (int moved = 1; moved;) {
+        moved = 0;
+        for (int i = 0; i < 2; i++) {
+            int below = best - subharmonics[i];
+            if (below >= CQT_GUARD_BINS && is_peak(magnitude, below) &&
+                magnitude[below] >= CQT_SUBHARMONIC_RATIO * magnitude[best] &&
+                magnitude[below] >= CQT_MIN_MAGNITUDE) {
+                best = below;
+                moved = 1;
+                break;
+            }
+        }
+    }
+
+    float offset = parabolic_peak_offset(magnitude, CQT_BINS, (uint32_t)best);
+    result->note_index = best - CQT_GUARD_BINS;
+    result->frequency = CQT_LOWEST_HZ * pow(2.0, (result->note_index + offset) / 12.0);
+    result->magnitude = magnitude[best];
+    result->tuning = analyze_tuning_note(cqt->tuning, result->note_index, result->frequency, 0);
+    return 1;
+}
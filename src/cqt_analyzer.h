@@ -0,0 +1,132 @@
+/**
+ * cqt_analyzer.h - Constant-Q transform for full-fretboard chromatic mode
+ *
+ * A linear FFT spaces its bins evenly in Hz: at 10 kHz most of them sit
+ * above the guitar, while E2 and F2 share a single 39 Hz bin. A constant-Q
+ * transform spaces them evenly in pitch instead, one bin per equal-tempered
+ * semitone with a bandwidth proportional to its frequency, so bin n of the
+ * fretboard range *is* note index n of the chromatic note table.
+ *
+ * Brown-Puckette formulation, so the cost stays near one FFT:
+ *
+ * 1. KERNEL (init): for each bin, a Hann-windowed complex exponential at
+ *    the bin's frequency, Q cycles long (Q = 1 / (2^(1/12) - 1) = 16.8),
+ *    aligned with the newest end of the frame, is transformed once. Only
+ *    its spectral main lobe (values above CQT_KERNEL_THRESHOLD of its peak)
+ *    is kept, as a short contiguous run of complex coefficients.
+ *
+ * 2. TRANSFORM: one CQT_FFT_SIZE FFT of the input, then each constant-Q
+ *    bin is the dot product of the spectrum with its sparse kernel. The
+ *    kernel's width grows with frequency, from a handful of coefficients
+ *    for E2 to about a hundred at the top; about 2500 in all, under 4% of
+ *    a dense kernel and roughly a quarter of the FFT's own work.
+ *
+ * 3. NOTE: the strongest note bin is taken, then moved down an octave or a
+ *    twelfth while the bin there is a peak of at least
+ *    CQT_SUBHARMONIC_RATIO of it (a second or third harmonic stronger than
+ *    its fundamental). The fractional semitone from a log-parabola through
+ *    the neighbouring bins gives the frequency to within a few cents.
+ *
+ *     static cqt_analyzer_t cqt;
+ *     cqt_analyzer_init(&cqt, NULL);
+ *     cqt_result_t result;
+ *     if (cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result)) {
+ *         // result.note_index, result.tuning.note_name / octave / cents_offset
+ *     }
+ *
+ * Bins run from one semitone below E2 (a guard bin for interpolation) up
+ * to 28 semitones above E5 so the harmonics of the top note are in range.
+ * The two lowest kernels are longer than the frame and are truncated to it,
+ * slightly widening those bins.
+ */
+
+#ifndef CQT_ANALYZER_H
+#define CQT_ANALYZER_H
+
+#include <stdint.h>
+#include "string_detection.h"
+#include "tuning_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define CQT_FFT_SIZE            2048    // 205 ms at 10 kHz, one E2 kernel
+#define CQT_LOG2_SIZE           11
+#define CQT_SAMPLE_RATE         10000   // Hz (SAMPLE_RATE)
+#define CQT_LOWEST_HZ           82.41   // E2, note index 0
+#define CQT_NOTES               NOTE_INDEX_COUNT    // E2 .. E5 fundamentals
+#define CQT_HARMONIC_BINS       28      // Semitones above E5 (up to its 5th harmonic)
+#define CQT_GUARD_BINS          1       // Below E2, for interpolation
+#define CQT_BINS                (CQT_GUARD_BINS + CQT_NOTES + CQT_HARMONIC_BINS)
+#define CQT_KERNEL_THRESHOLD    0.05f   // Kernel coefficients kept (-26 dB of the bin's peak)
+#define CQT_MAX_KERNEL          3072    // Sparse coefficients for all bins (~2500 used)
+#define CQT_MIN_MAGNITUDE       0.002f  // Fundamental amplitude (normalized, ~ -54 dBFS)
+#define CQT_SUBHARMONIC_RATIO   0.1f    // Octave/twelfth below taken when at least this strong
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef struct {
+    float re[CQT_FFT_SIZE];
+    float im[CQT_FFT_SIZE];
+    float twiddle_re[CQT_FFT_SIZE / 2];
+    float twiddle_im[CQT_FFT_SIZE / 2];
+
+    /* Sparse spectral kernel: bin b uses FFT bins first[b] .. first[b] + count[b] - 1,
+       coefficients from offset[b] (conjugated and scaled, ready to multiply) */
+    float kernel_re[CQT_MAX_KERNEL];
+    float kernel_im[CQT_MAX_KERNEL];
+    uint16_t first[CQT_BINS];
+    uint16_t count[CQT_BINS];
+    uint16_t offset[CQT_BINS];
+    uint32_t kernel_size;           // Coefficients in use
+
+    float center_hz[CQT_BINS];
+    float magnitude[CQT_BINS];      // Latest transform (input amplitude units)
+    const tuning_table_t* tuning;
+} cqt_analyzer_t;
+
+typedef struct {
+    int note_index;                 // 0 = E2 ... CQT_NOTES - 1 = E5, -1 = none
+    double frequency;               // Interpolated between semitone bins
+    float magnitude;                // Fundamental bin
+    TuningResult tuning;            // Nearest string of the profile, note from note_index
+} cqt_result_t;
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/**
+ * Build twiddles and the sparse spectral kernel
+ *
+ * @param tuning: Profile for the string/cents part of the result, NULL for standard guitar
+ */
+void cqt_analyzer_init(cqt_analyzer_t* cqt, const tuning_table_t* tuning);
+
+/**
+ * Constant-Q magnitudes of the newest CQT_FFT_SIZE samples into cqt->magnitude
+ *
+ * @param num_samples: Fewer than CQT_FFT_SIZE are zero padded at the old end
+ *                     (low bins then see less than their full kernel)
+ */
+void cqt_transform(cqt_analyzer_t* cqt, const int16_t* samples, int num_samples);
+
+/**
+ * Transform and map the played note
+ *
+ * @return 1 if a note was found, 0 otherwise (result->note_index = -1)
+ */
+int cqt_analyze(cqt_analyzer_t* cqt, const int16_t* samples, int num_samples, cqt_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CQT_ANALYZER_H
@@ -0,0 +1,261 @@
+/**
+ * feedback_scheduler.c - Sample-clock feedback scheduling implementation
+ *
+ * The command queue follows audio_block_ring: free-running head and tail,
+ * each written by one side only, with release/acquire ordering so a command
+ * is visible only once completely written. The heap and the clock are owned
+ * by the audio update; the main loop only reads the clock.
+ */
+
+#include "feedback_scheduler.h"
+#include "prompt_cache.h"
+#include "config.h"
+#include <string.h>
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ========================================================================== */
+
+#define COMMAND_MASK (FEEDBACK_COMMANDS - 1)
+
+/* Main loop -> audio update */
+static feedback_event_t commands[FEEDBACK_COMMANDS];
+static uint32_t command_head = 0;       // Written by the main loop
+static uint32_t command_tail = 0;       // Written by the audio update
+static uint32_t command_overruns = 0;
+
+/* Owned by the audio update */
+static feedback_event_t heap[FEEDBACK_MAX_EVENTS];
+static uint32_t heap_size = 0;
+static uint32_t sample_clock = 0;
+
+/* ============================================================================
+ * HEAP
+ * ========================================================================== */
+
+/* Wrap-safe "a is due before b" */
+static bool due_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static void swap_events(uint32_t a, uint32_t b) {
+    feedback_event_t tmp = heap[a];
+    heap[a] = heap[b];
+    heap[b] = tmp;
+}
+
+static void sift_up(uint32_t i) {
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!due_before(heap[i].due, heap[parent].due)) {
+            break;
+        }
+        swap_events(i, parent);
+        i = parent;
+    }
+}
+
+static void sift_down(uint32_t i) {
+    for (;;) {
+        uint32_t smallest = i;
+        uint32_t left = 2 * i + 1;
+        uint32_t right = left + 1;
+        if (left < heap_size && due_before(heap[left].due, heap[smallest].due)) {
+            smallest = left;
+        }
+        if (right < heap_size && due_before(heap[right].due, heap[smallest].due)) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        swap_events(i, smallest);
+        i = smallest;
+    }
+}
+
+static void heap_push(const feedback_event_t* event) {
+    if (heap_size == FEEDBACK_MAX_EVENTS) {
+        return;             // Full - the new event is dropped
+    }
+    heap[heap_size] = *event;
+    sift_up(heap_size++);
+}
+
+static void heap_pop(void) {
+    heap[0] = heap[--heap_size];
+    sift_down(0);
+}
+
+static void heap_remove_tag(uint32_t tag) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < heap_size; i++) {
+        if (heap[i].tag != tag) {
+            heap[kept++] = heap[i];
+        }
+    }
+    heap_size = kept;
+    for (uint32_t i = heap_size / 2; i-- > 0; ) {
+        sift_down(i);
+    }
+}
+
+/* ============================================================================
+ * SCHEDULING
+ * ========================================================================== */
+
+void feedback_scheduler_init(void) {
+    command_head = 0;
+    command_tail = 0;
+    command_overruns = 0;
+    heap_size = 0;
+    sample_clock = 0;
+}
+
+uint32_t feedback_scheduler_now(void) {
+    return __atomic_load_n(&sample_clock, __ATOMIC_ACQUIRE);
+}
+
+uint32_t feedback_ms_to_samples(uint32_t ms) {
+    return (uint32_t)((uint64_t)ms * AUDIO_SAMPLE_RATE / 1000);
+}
+
+static bool post_command(const feedback_event_t* command) {
+    uint32_t head = __atomic_load_n(&command_head, __ATOMIC_RELAXED);   // Own index
+    uint32_t tail = __atomic_load_n(&command_tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= FEEDBACK_COMMANDS) {
+        __atomic_store_n(&command_overruns, command_overruns + 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    commands[head & COMMAND_MASK] = *command;
+    __atomic_store_n(&command_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool feedback_schedule_beep(uint32_t due, uint32_t period, const tone_pattern_t* beep, uint32_t tag) {
+    if (beep == NULL) {
+        return false;
+    }
+    feedback_event_t command = { FEEDBACK_EVENT_BEEP, due, period, tag, *beep, NULL };
+    return post_command(&command);
+}
+
+bool feedback_schedule_prompt(uint32_t due, const char* prompt, uint32_t tag) {
+    if (prompt == NULL) {
+        return false;
+    }
+    feedback_event_t command = { FEEDBACK_EVENT_PROMPT, due, 0, tag, { 0 }, prompt };
+    return post_command(&command);
+}
+
+bool feedback_schedule_stop(uint32_t due, uint32_t tag) {
+    feedback_event_t command = { FEEDBACK_EVENT_STOP, due, 0, tag, { 0 }, NULL };
+    return post_command(&command);
+}
+
+bool feedback_cancel(uint32_t tag) {
+    feedback_event_t command = { FEEDBACK_EVENT_CANCEL, 0, 0, tag, { 0 }, NULL };
+    return post_command(&command);
+}
+
+/* ============================================================================
+ * RENDERING
+ * ========================================================================== */
+
+/**
+ * Move queued commands into the heap, in the order they were posted
+ */
+static void drain_commands(void) {
+    uint32_t tail = __atomic_load_n(&command_tail, __ATOMIC_RELAXED);   // Own index
+    uint32_t head = __atomic_load_n(&command_head, __ATOMIC_ACQUIRE);
+
+    for (; tail != head; tail++) {
+        const feedback_event_t* command = &commands[tail & COMMAND_MASK];
+        if (command->type == FEEDBACK_EVENT_CANCEL) {
+            heap_remove_tag(command->tag);
+        } else {
+            heap_push(command);
+        }
+    }
+    __atomic_store_n(&command_tail, tail, __ATOMIC_RELEASE);
+}
+
+static void fire(const feedback_event_t* event) {
+    switch (event->type) {
+        case FEEDBACK_EVENT_BEEP:
+            tone_synth_play(&event->beep);
+            break;
+        case FEEDBACK_EVENT_PROMPT:
+            prompt_cache_play(event->prompt);
+            break;
+        case FEEDBACK_EVENT_STOP:
+            prompt_cache_stop();
+            tone_synth_stop();
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Prompt and beeps for one span with no event inside it; the oscillator
+ * mixes on top of the prompt when both go to the same block
+ */
+static uint32_t render_span(int16_t* prompt_out, int16_t* beep_out, uint32_t num_samples, uint32_t* beeps) {
+    uint32_t written = prompt_cache_render(prompt_out, num_samples);
+    if (beep_out != prompt_out) {
+        memset(beep_out, 0, num_samples * sizeof(int16_t));
+    }
+    *beeps += tone_synth_render(beep_out, num_samples);
+    return written;
+}
+
+uint32_t feedback_scheduler_render(int16_t* output, uint32_t num_samples) {
+    uint32_t beeps;
+    return feedback_scheduler_render_split(output, output, num_samples, &beeps);
+}
+
+uint32_t feedback_scheduler_render_split(int16_t* prompt_out, int16_t* beep_out, uint32_t num_samples,
+                                         uint32_t* beep_samples) {
+    const uint32_t block_start = sample_clock;
+    uint32_t position = 0;
+    uint32_t written = 0;
+    uint32_t beeps = 0;
+
+    drain_commands();
+    while (position < num_samples) {
+        /* Fire everything due at or before this sample */
+        while (heap_size > 0 && !due_before(block_start + position, heap[0].due)) {
+            feedback_event_t event = heap[0];
+            heap_pop();
+            fire(&event);
+            if (event.period > 0) {
+                event.due += event.period;      // From the due time, not from now: no drift
+                heap_push(&event);
+            }
+        }
+
+        /* Render up to the next event or the end of the block */
+        uint32_t end = num_samples;
+        if (heap_size > 0 && due_before(heap[0].due, block_start + num_samples)) {
+            end = heap[0].due - block_start;
+        }
+        written += render_span(prompt_out + position, beep_out + position, end - position, &beeps);
+        position = end;
+    }
+
+    __atomic_store_n(&sample_clock, block_start + num_samples, __ATOMIC_RELEASE);
+    if (beep_samples != NULL) {
+        *beep_samples = beeps;
+    }
+    return written;
+}
+
+uint32_t feedback_scheduler_pending(void) {
+    return heap_size;
+}
+
+uint32_t feedback_scheduler_overruns(void) {
+    return __atomic_load_n(&command_overruns, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,146 @@
+/**
+ * feedback_scheduler.h - Sample-clock scheduling of feedback events
+ *
+ * Beeps, prompt starts and stops are queued with a due time in output
+ * samples and fired from inside the output block callback, so their timing
+ * is exact to the sample and independent of how often the main loop runs:
+ *
+ *     uint32_t now = feedback_scheduler_now();
+ *     feedback_schedule_beep(now, ms_to_samples(500), &pattern, TAG_BEEPS);
+ *     ...
+ *     feedback_scheduler_render(block, 128);     // Audio update, every block
+ *
+ * - The main loop posts commands into a lock-free SPSC queue; the audio
+ *   update drains it at the start of each block into a fixed-size binary
+ *   min-heap ordered by due time
+ * - The block is split at each due event: sound before the event is
+ *   rendered first, the event fires, and rendering resumes on its sample
+ * - Periodic events are pushed back with due += period, so a repeating beep
+ *   never drifts however late the main loop is
+ *
+ * The clock is a free-running 32-bit sample counter; times are compared by
+ * signed difference so it may wrap (every ~27 hours at 44.1 kHz).
+ */
+
+#ifndef FEEDBACK_SCHEDULER_H
+#define FEEDBACK_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tone_synth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define FEEDBACK_MAX_EVENTS     16      // Pending events held by the audio update
+#define FEEDBACK_COMMANDS       16      // Main loop -> audio update queue, power of two
+
+#if (FEEDBACK_COMMANDS & (FEEDBACK_COMMANDS - 1)) != 0
+#error "FEEDBACK_COMMANDS must be a power of two"
+#endif
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    FEEDBACK_EVENT_BEEP = 0,        // tone_synth_play(beep)
+    FEEDBACK_EVENT_PROMPT,          // prompt_cache_play(prompt)
+    FEEDBACK_EVENT_STOP,            // Stop prompt and beep
+    FEEDBACK_EVENT_CANCEL           // Command only: drop pending events with a tag
+} feedback_event_type_t;
+
+typedef struct {
+    feedback_event_type_t type;
+    uint32_t due;                   // Sample clock
+    uint32_t period;                // 0 = one-shot, otherwise repeat interval in samples
+    uint32_t tag;                   // Caller's group, for feedback_cancel()
+    tone_pattern_t beep;
+    const char* prompt;             // Cached prompt name (must outlive the event)
+} feedback_event_t;
+
+/* ============================================================================
+ * SCHEDULING (main loop)
+ * ========================================================================== */
+
+/**
+ * Reset the clock, drop all events and commands
+ * Not thread-safe: call before the audio update starts
+ */
+void feedback_scheduler_init(void);
+
+/**
+ * @return Sample clock at the start of the next output block
+ */
+uint32_t feedback_scheduler_now(void);
+
+/**
+ * @return `ms` in output samples
+ */
+uint32_t feedback_ms_to_samples(uint32_t ms);
+
+/**
+ * Schedule a beep pattern at sample time `due` (past times fire at once)
+ *
+ * @param period: Repeat interval in samples, 0 for a single shot
+ * @return false if the command queue is full
+ */
+bool feedback_schedule_beep(uint32_t due, uint32_t period, const tone_pattern_t* beep, uint32_t tag);
+
+/**
+ * Schedule a cached prompt to start at sample time `due`
+ */
+bool feedback_schedule_prompt(uint32_t due, const char* prompt, uint32_t tag);
+
+/**
+ * Schedule a stop of prompt and beep at sample time `due`
+ */
+bool feedback_schedule_stop(uint32_t due, uint32_t tag);
+
+/**
+ * Drop every pending event with `tag` at the start of the next block
+ */
+bool feedback_cancel(uint32_t tag);
+
+/* ============================================================================
+ * RENDERING (audio update)
+ * ========================================================================== */
+
+/**
+ * Produce the next output block: cached prompts plus beeps, with every due
+ * event fired on its exact sample
+ *
+ * @return Samples of the block that carried prompt audio
+ */
+uint32_t feedback_scheduler_render(int16_t* output, uint32_t num_samples);
+
+/**
+ * Same as feedback_scheduler_render() with prompts and beeps in separate
+ * blocks, for voice_mixer (beeps ducked under speech)
+ *
+ * @param beep_samples: Set to the samples the oscillator sounded
+ * @return Samples of `prompt_out` that carried prompt audio
+ */
+uint32_t feedback_scheduler_render_split(int16_t* prompt_out, int16_t* beep_out, uint32_t num_samples,
+                                         uint32_t* beep_samples);
+
+/**
+ * @return Events waiting in the heap (audio-update view)
+ */
+uint32_t feedback_scheduler_pending(void);
+
+/**
+ * @return Commands refused because the queue was full
+ */
+uint32_t feedback_scheduler_overruns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FEEDBACK_SCHEDULER_H
@@ -10,6 +10,7 @@
 
 #include "hardware_interface.h"
 #include "config.h"
+#include "tone_synth.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -279,8 +280,15 @@ bool audio_amplifier_is_enabled(void) {
  * ACCESSIBILITY FEATURES
  * ========================================================================== */
 
+/* No piezo fitted: feedback patterns go through the audio output instead */
+#define TACTILE_PITCH_HZ        2000.0f
+#define TACTILE_WARNING_HZ      1000.0f
+#define TACTILE_LEVEL           0.4f
+
 int tactile_feedback_click(void) {
-    /* Stub: Would control piezo buzzer on dedicated GPIO */
+    tone_pattern_t pattern;
+    tone_synth_pattern(&pattern, TACTILE_PITCH_HZ, 15, 0, 1, TACTILE_LEVEL);
+    tone_synth_play(&pattern);
     if (ENABLE_DEBUG_PRINTS) {
         printf("[TACTILE] Click feedback\n");
     }
@@ -288,7 +296,10 @@ int tactile_feedback_click(void) {
 }
 
 int tactile_feedback_confirm(void) {
-    /* Stub: Two beeps */
+    /* Two beeps */
+    tone_pattern_t pattern;
+    tone_synth_pattern(&pattern, TACTILE_PITCH_HZ, 40, 60, 2, TACTILE_LEVEL);
+    tone_synth_play(&pattern);
     if (ENABLE_DEBUG_PRINTS) {
         printf("[TACTILE] Confirm feedback (double-click)\n");
     }
@@ -296,7 +307,10 @@ int tactile_feedback_confirm(void) {
 }
 
 int tactile_feedback_warning(void) {
-    /* Stub: Three rapid beeps */
+    /* Three rapid beeps */
+    tone_pattern_t pattern;
+    tone_synth_pattern(&pattern, TACTILE_WARNING_HZ, 30, 30, 3, TACTILE_LEVEL);
+    tone_synth_play(&pattern);
     if (ENABLE_DEBUG_PRINTS) {
         printf("[TACTILE] Warning feedback (triple-click)\n");
     }
@@ -156,9 +156,9 @@ bool audio_amplifier_is_enabled(void);
 
 /**
  * Provide tactile feedback for button press (optional)
- * If hardware has piezo buzzer on TACTILE_FEEDBACK_PIN:
+ * Played by tone_synth through the audio output (no piezo fitted):
  * - Plays short click sound
- * Duration: 50ms
+ * Duration: 15ms
  * Returns: 0 on success, -1 if unavailable
  */
 int tactile_feedback_click(void);
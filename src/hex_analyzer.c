@@ -0,0 +1,540 @@
+/**
+ * hex_analyzer.c - Six-channel structure-of-arrays analysis implementation
+ *
+ * Every loop that touches samples runs over HEX_LANES contiguous floats with
+ * no dependency between lanes; the two padding lanes are kept at zero and
+ * cost nothing extra once vectorized. Twiddles and the window come from
+ * tables built at init instead of being recomputed per butterfly.
+ */
+
+#include "hex_analyzer.h"
+#include "signal_processing.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+
+#define HEX_BINS        (HEX_FFT_SIZE / 2)
+#define HEX_LOG2_SIZE   8
+
+/* Search range around each open string, in semitones */
+#define RANGE_BELOW_SEMITONES   6.0     // Tuned down half an octave
+#define RANGE_ABOVE_SEMITONES   13.0    // Just past the 12th fret
+
+/* Sub-bin refinement (see refine_lane) */
+#define REFINE_PASSES           2       // Vertex steps; each refits the neighbours' bleed
+#define REFINE_HALF_BINS        0.6f    // Result kept within this of the peak bin
+#define REFINE_BINS_BELOW       1       // Bins fitted around f0 and 2*f0 ...
+#define REFINE_BINS_ABOVE       2
+#define REFINE_MIN_SEPARATION   0.25f   // Bleed this close to f0 or 2*f0 is not modelled
+#define REFINE_MAX_FIXED        5       // DC and the two neighbouring strings
+#define REFINE_SYSTEM_WIDTH     (2 * REFINE_MAX_FIXED + 1)
+#define REFINE_MAX_BINS         (2 * (REFINE_BINS_BELOW + REFINE_BINS_ABOVE + 1))
+
+/* One lane's fit with the fixed columns already solved */
+typedef struct {
+    int bins[REFINE_MAX_BINS];
+    float x_re[REFINE_MAX_BINS];
+    float x_im[REFINE_MAX_BINS];
+    int num_bins;
+    float fixed_re[REFINE_MAX_FIXED][REFINE_MAX_BINS];
+    float fixed_im[REFINE_MAX_FIXED][REFINE_MAX_BINS];
+    double inverse[REFINE_MAX_FIXED][REFINE_MAX_FIXED];    // (F'F)^-1
+    double fixed_fit[REFINE_MAX_FIXED];                     // (F'F)^-1 F'x
+    int num_fixed;
+} lane_fit_t;
+
+/* ============================================================================
+ * INIT
+ * ========================================================================== */
+
+void hex_analyzer_init(hex_analyzer_t* hex, const tuning_table_t* tuning) {
+    memset(hex, 0, sizeof(*hex));
+    if (tuning == NULL || tuning->string_count < HEX_CHANNELS) {
+        tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    }
+    hex->tuning = tuning;
+
+    for (int n = 0; n < HEX_FFT_SIZE; n++) {
+        hex->window[n] = 0.5f * (1.0f - cosf(2.0f * PI * n / (HEX_FFT_SIZE - 1)));
+
+        uint32_t reversed = 0;
+        for (int b = 0, j = n; b < HEX_LOG2_SIZE; b++, j >>= 1) {
+            reversed = (reversed << 1) | (j & 1);
+        }
+        hex->bit_reverse[n] = (uint16_t)reversed;
+    }
+    for (int k = 0; k < HEX_FFT_SIZE / 2; k++) {
+        hex->twiddle_re[k] = cosf(-2.0f * PI * k / HEX_FFT_SIZE);
+        hex->twiddle_im[k] = sinf(-2.0f * PI * k / HEX_FFT_SIZE);
+    }
+
+    const float hz_per_bin = (float)HEX_SAMPLE_RATE / HEX_FFT_SIZE;
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        float target = tuning->strings[c].target_hz;
+        int first = (int)floorf(target * powf(2.0f, -RANGE_BELOW_SEMITONES / 12.0f) / hz_per_bin);
+        int last = (int)ceilf(target * powf(2.0f, RANGE_ABOVE_SEMITONES / 12.0f) / hz_per_bin);
+        hex->first_bin[c] = (uint16_t)(first < 1 ? 1 : first);
+        hex->last_bin[c] = (uint16_t)(last > HEX_BINS - 1 ? HEX_BINS - 1 : last);
+    }
+}
+
+/* ============================================================================
+ * LANE-PARALLEL PIPELINE
+ * ========================================================================== */
+
+/**
+ * Remove each lane's mean, apply the window and reorder the rows for the
+ * in-place FFT
+ */
+static void prepare_rows(hex_analyzer_t* hex) {
+    float mean[HEX_LANES] = { 0 };
+
+    for (int n = 0; n < HEX_FFT_SIZE; n++) {
+        for (int l = 0; l < HEX_LANES; l++) {
+            mean[l] += hex->re[n][l];
+        }
+    }
+    for (int l = 0; l < HEX_LANES; l++) {
+        mean[l] *= 1.0f / HEX_FFT_SIZE;
+    }
+    for (int n = 0; n < HEX_FFT_SIZE; n++) {
+        const float w = hex->window[n];
+        for (int l = 0; l < HEX_LANES; l++) {
+            hex->re[n][l] = (hex->re[n][l] - mean[l]) * w;
+            hex->im[n][l] = 0.0f;
+        }
+    }
+    for (int n = 0; n < HEX_FFT_SIZE; n++) {
+        int r = hex->bit_reverse[n];
+        if (n < r) {
+            float tmp[HEX_LANES];
+            memcpy(tmp, hex->re[n], sizeof(tmp));
+            memcpy(hex->re[n], hex->re[r], sizeof(tmp));
+            memcpy(hex->re[r], tmp, sizeof(tmp));
+        }
+    }
+}
+
+/**
+ * Radix-2 FFT of all lanes at once (same decomposition as the mono path)
+ */
+static void fft_rows(hex_analyzer_t* hex) {
+    for (int stage = 0; stage < HEX_LOG2_SIZE; stage++) {
+        const int half = 1 << stage;
+        const int stride = HEX_FFT_SIZE / (2 * half);       // Twiddle table step
+
+        for (int i = 0; i < HEX_FFT_SIZE; i += 2 * half) {
+            for (int j = 0; j < half; j++) {
+                const float wr = hex->twiddle_re[j * stride];
+                const float wi = hex->twiddle_im[j * stride];
+                float* restrict ar = hex->re[i + j];
+                float* restrict ai = hex->im[i + j];
+                float* restrict br = hex->re[i + j + half];
+                float* restrict bi = hex->im[i + j + half];
+
+                for (int l = 0; l < HEX_LANES; l++) {
+                    float tr = wr * br[l] - wi * bi[l];
+                    float ti = wr * bi[l] + wi * br[l];
+                    br[l] = ar[l] - tr;
+                    bi[l] = ai[l] - ti;
+                    ar[l] = ar[l] + tr;
+                    ai[l] = ai[l] + ti;
+                }
+            }
+        }
+    }
+}
+
+/* ============================================================================
+ * SUB-BIN REFINEMENT
+ * ========================================================================== */
+
+/**
+ * sin(x) for the small arguments of the window kernel's denominators
+ * (|x| < 1: error below 1e-9, no libm call)
+ */
+static inline float small_sin(float x) {
+    float x2 = x * x;
+    return x * (1.0f - x2 / 6.0f * (1.0f - x2 / 20.0f * (1.0f - x2 / 42.0f * (1.0f - x2 / 72.0f))));
+}
+
+static inline float small_cos(float x) {
+    float x2 = x * x;
+    return 1.0f - x2 / 2.0f * (1.0f - x2 / 12.0f * (1.0f - x2 / 30.0f * (1.0f - x2 / 56.0f)));
+}
+
+/**
+ * Columns of one real sinusoid at nu bins in the fitted bins
+ *
+ * The analysis window's spectrum at an offset of v bins is, for the
+ * symmetric Hann built at init, three Dirichlet kernels sharing one linear
+ * phase: W(v) = e^(-j pi v (N-1)/N) sum_m g_m sin(pi (v - m s)) / sin(pi (v - m s) / N)
+ * with s = N / (N - 1), m = 0, +-1, g = 1/2, 1/4, 1/4. A sinusoid a cos + b sin
+ * puts a (W(k - nu) + W(k + nu)) + b j (W(k - nu) - W(k + nu)) into bin k,
+ * its negative-frequency image included. The numerators and e^(-j pi v)
+ * both flip sign from bin to bin, so their product is fixed per probe and
+ * only the small-angle factors are evaluated per bin; nu = 0 is the
+ * residual DC and has no sine column.
+ */
+static void sinusoid_columns(float nu, const int* bins, int num_bins, float* cos_re, float* cos_im,
+                             float* sin_re, float* sin_im) {
+    const float n = (float)HEX_FFT_SIZE;
+    const float gains[3] = { 0.5f, 0.25f, 0.25f };
+    const float step_sin = small_sin(PI / (n - 1.0f));    // pi s / N
+    const float step_cos = small_cos(PI / (n - 1.0f));
+    float numerator[2][3];      // [below, above][m], without the (-1)^k ...
+    float turn_re[2], turn_im[2];
+
+    /* pi s = pi + pi s / N, so sin(pi s) = -step_sin, cos(pi s) = -step_cos */
+    const float nu_sin = sinf(PI * nu);
+    const float nu_cos = cosf(PI * nu);
+    for (int side = 0; side < 2; side++) {
+        float sign = side ? 1.0f : -1.0f;       // v = k -/+ nu
+        float s = sign * nu_sin;                // sin(pi sign nu)
+        numerator[side][0] = gains[0] * s;
+        numerator[side][1] = gains[1] * (nu_cos * step_sin - s * step_cos);
+        numerator[side][2] = gains[2] * (-s * step_cos - nu_cos * step_sin);
+        turn_re[side] = nu_cos;                 // ... that e^(-j pi k) cancels
+        turn_im[side] = -s;
+    }
+
+    for (int b = 0; b < num_bins; b++) {
+        float w_re[2], w_im[2];
+        for (int side = 0; side < 2; side++) {
+            float v = (float)bins[b] + (side ? nu : -nu);
+            float r = small_cos(PI * v / n);
+            float i = small_sin(PI * v / n);
+            float denominator[3] = { i, i * step_cos - r * step_sin, i * step_cos + r * step_sin };
+            float amplitude = 0.0f;
+            for (int m = 0; m < 3; m++) {
+                amplitude += (fabsf(denominator[m]) < 1e-6f) ? n * gains[m] : numerator[side][m] / denominator[m];
+            }
+            /* e^(-j pi v (N-1)/N) = e^(-j pi v) e^(j pi v / N) */
+            w_re[side] = amplitude * (turn_re[side] * r - turn_im[side] * i);
+            w_im[side] = amplitude * (turn_re[side] * i + turn_im[side] * r);
+        }
+        cos_re[b] = w_re[0] + w_re[1];
+        cos_im[b] = w_im[0] + w_im[1];
+        if (sin_re != NULL) {
+            sin_re[b] = w_im[1] - w_im[0];
+            sin_im[b] = w_re[0] - w_re[1];
+        }
+    }
+}
+
+/**
+ * Gauss-Jordan elimination with partial pivoting on `rows` equations of
+ * `width` columns; every row ends scaled to a unit pivot, so the columns
+ * right of the square part hold the solution
+ */
+static void gauss_jordan(double (*system)[REFINE_SYSTEM_WIDTH], int rows, int width) {
+    for (int c = 0; c < rows; c++) {
+        int pivot = c;
+        for (int r = c + 1; r < rows; r++) {
+            if (fabs(system[r][c]) > fabs(system[pivot][c])) {
+                pivot = r;
+            }
+        }
+        for (int k = 0; k < width; k++) {
+            double tmp = system[c][k];
+            system[c][k] = system[pivot][k];
+            system[pivot][k] = tmp;
+        }
+        double scale = 1.0 / system[c][c];
+        for (int k = c; k < width; k++) {
+            system[c][k] *= scale;
+        }
+        for (int r = 0; r < rows; r++) {
+            if (r != c && system[r][c] != 0.0) {
+                double m = system[r][c];
+                for (int k = c; k < width; k++) {
+                    system[r][k] -= m * system[c][k];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Real inner product of two complex columns over the fitted bins (a dozen
+ * terms: float keeps the power differences between probes well resolved)
+ */
+static float column_dot(const float* a_re, const float* a_im, const float* b_re, const float* b_im, int num_bins) {
+    float sum = 0.0f;
+    for (int b = 0; b < num_bins; b++) {
+        sum += a_re[b] * b_re[b] + a_im[b] * b_im[b];
+    }
+    return sum;
+}
+
+/**
+ * Set up one lane's fit: the bins around f0 and 2*f0, and the fixed columns
+ * (residual DC and the other strings' peaks) already solved, so a probe
+ * only adds the string's own four columns through their Schur complement
+ */
+static void setup_lane_fit(const hex_analyzer_t* hex, int lane, int peak_bin, const float estimate[HEX_CHANNELS],
+                           lane_fit_t* fit) {
+    fit->num_bins = 0;
+    for (int h = 1; h <= 2; h++) {
+        int first = h * peak_bin - REFINE_BINS_BELOW;
+        int last = h * peak_bin + REFINE_BINS_ABOVE;
+        for (int k = (first < 0) ? 0 : first; k <= last && k < HEX_BINS; k++) {
+            if (fit->num_bins > 0 && k <= fit->bins[fit->num_bins - 1]) {
+                continue;     // Ranges of f0 and 2*f0 meet on the low strings
+            }
+            fit->bins[fit->num_bins] = k;
+            fit->x_re[fit->num_bins] = hex->re[k][lane];
+            fit->x_im[fit->num_bins] = hex->im[k][lane];
+            fit->num_bins++;
+        }
+    }
+
+    /* Bleed from the strings either side (their coils sit next to this
+       one) when their main lobes reach these bins; one too close to the
+       string's own partials cannot be told apart and is left out */
+    int num_fixed = 1;
+    sinusoid_columns(0.0f, fit->bins, fit->num_bins, fit->fixed_re[0], fit->fixed_im[0], NULL, NULL);
+    for (int c = lane - 1; c <= lane + 1; c += 2) {
+        float other = (c >= 0 && c < HEX_CHANNELS) ? estimate[c] : 0.0f;
+        if (other <= 0.0f || other < fit->bins[0] - 2.0f ||
+            other > fit->bins[fit->num_bins - 1] + 2.0f ||
+            fabsf(other - estimate[lane]) < REFINE_MIN_SEPARATION ||
+            fabsf(other - 2.0f * estimate[lane]) < REFINE_MIN_SEPARATION) {
+            continue;
+        }
+        sinusoid_columns(other, fit->bins, fit->num_bins, fit->fixed_re[num_fixed], fit->fixed_im[num_fixed],
+                         fit->fixed_re[num_fixed + 1], fit->fixed_im[num_fixed + 1]);
+        num_fixed += 2;
+    }
+    fit->num_fixed = num_fixed;
+
+    /* [F | I | q] -> [I | F^-1 | F^-1 q] */
+    double system[REFINE_MAX_FIXED][REFINE_SYSTEM_WIDTH];
+    for (int r = 0; r < num_fixed; r++) {
+        for (int c = r; c < num_fixed; c++) {
+            system[r][c] = column_dot(fit->fixed_re[r], fit->fixed_im[r], fit->fixed_re[c], fit->fixed_im[c],
+                                      fit->num_bins);
+            system[c][r] = system[r][c];
+        }
+        system[r][r] += 1e-9 * (system[r][r] + 1.0);   // Keeps near-equal peaks solvable
+        for (int c = 0; c < num_fixed; c++) {
+            system[r][num_fixed + c] = (r == c) ? 1.0 : 0.0;
+        }
+        system[r][2 * num_fixed] = column_dot(fit->fixed_re[r], fit->fixed_im[r], fit->x_re, fit->x_im,
+                                              fit->num_bins);
+    }
+    gauss_jordan(system, num_fixed, 2 * num_fixed + 1);
+    for (int r = 0; r < num_fixed; r++) {
+        for (int c = 0; c < num_fixed; c++) {
+            fit->inverse[r][c] = system[r][num_fixed + c];
+        }
+        fit->fixed_fit[r] = system[r][2 * num_fixed];
+    }
+}
+
+/**
+ * Power the string at f0 = nu bins explains beyond the fixed columns
+ *
+ * With the string's columns M and the fixed columns F, the extra power is
+ * r' S^-1 r with S = M'M - M'F (F'F)^-1 F'M and r = M'x - M'F (F'F)^-1 F'x.
+ */
+static double probe_lane(const lane_fit_t* fit, float nu) {
+    float own_re[4][REFINE_MAX_BINS];
+    float own_im[4][REFINE_MAX_BINS];
+    double cross[4][REFINE_MAX_FIXED];
+    double system[4][REFINE_SYSTEM_WIDTH];
+    const int num_fixed = fit->num_fixed;
+
+    sinusoid_columns(nu, fit->bins, fit->num_bins, own_re[0], own_im[0], own_re[1], own_im[1]);
+    sinusoid_columns(2.0f * nu, fit->bins, fit->num_bins, own_re[2], own_im[2], own_re[3], own_im[3]);
+
+    for (int r = 0; r < 4; r++) {
+        double residual = column_dot(own_re[r], own_im[r], fit->x_re, fit->x_im, fit->num_bins);
+        for (int f = 0; f < num_fixed; f++) {
+            cross[r][f] = column_dot(own_re[r], own_im[r], fit->fixed_re[f], fit->fixed_im[f], fit->num_bins);
+            residual -= cross[r][f] * fit->fixed_fit[f];
+        }
+        system[r][4] = residual;
+        for (int c = r; c < 4; c++) {
+            system[r][c] = column_dot(own_re[r], own_im[r], own_re[c], own_im[c], fit->num_bins);
+        }
+    }
+    for (int r = 0; r < 4; r++) {
+        double projected[REFINE_MAX_FIXED];
+        for (int f = 0; f < num_fixed; f++) {
+            double sum = 0.0;
+            for (int g = 0; g < num_fixed; g++) {
+                sum += cross[r][g] * fit->inverse[g][f];
+            }
+            projected[f] = sum;
+        }
+        for (int c = r; c < 4; c++) {
+            for (int f = 0; f < num_fixed; f++) {
+                system[r][c] -= projected[f] * cross[c][f];
+            }
+            system[c][r] = system[r][c];
+        }
+        system[r][r] += 1e-9 * (system[r][r] + 1.0);
+    }
+
+    double residual[4];
+    for (int r = 0; r < 4; r++) {
+        residual[r] = system[r][4];
+    }
+    gauss_jordan(system, 4, 5);
+    double power = 0.0;
+    for (int r = 0; r < 4; r++) {
+        power += residual[r] * system[r][4];
+    }
+    return power;
+}
+
+/**
+ * One refinement step of one lane's peak, in bins
+ *
+ * Two or three cycles of a low string fill the 256-point frame, so the
+ * string's own second harmonic, its negative-frequency image and bleed from
+ * the neighbouring strings all overlap its main lobe and pull a plain peak
+ * interpolation by tens of cents. Instead the bins around f0 and 2*f0 are
+ * fitted with f0, 2*f0, the residual DC and the neighbours' current
+ * estimates, and f0 moves to the vertex of the explained power probed
+ * `step` bins either side.
+ */
+static float refine_lane(const hex_analyzer_t* hex, int lane, int peak_bin, const float estimate[HEX_CHANNELS],
+                         float step) {
+    lane_fit_t fit;
+    setup_lane_fit(hex, lane, peak_bin, estimate, &fit);
+
+    float nu = estimate[lane];
+    double below = probe_lane(&fit, nu - step);
+    double centre = probe_lane(&fit, nu);
+    double above = probe_lane(&fit, nu + step);
+    double curvature = below - 2.0 * centre + above;
+    float offset = (curvature < 0.0) ? (float)(0.5 * (below - above) / curvature) : ((below > above) ? -1.0f : 1.0f);
+    nu += step * fmaxf(-1.0f, fminf(1.0f, offset));
+    return fmaxf((float)peak_bin - REFINE_HALF_BINS, fminf((float)peak_bin + REFINE_HALF_BINS, nu));
+}
+
+/**
+ * Per-string peak in its own range; power is compared, one sqrt per string
+ */
+static int pick_peaks(hex_analyzer_t* hex, const int gate[HEX_LANES], hex_result_t* result) {
+    int peak_bins[HEX_CHANNELS];
+    float coarse[HEX_CHANNELS];
+    int valid_count = 0;
+
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        int peak_bin = 0;
+        float peak_power = 0.0f;
+
+        if (gate[c]) {
+            for (int k = hex->first_bin[c]; k <= hex->last_bin[c]; k++) {
+                float power = hex->re[k][c] * hex->re[k][c] + hex->im[k][c] * hex->im[k][c];
+                if (power > peak_power) {
+                    peak_power = power;
+                    peak_bin = k;
+                }
+            }
+        }
+
+        float magnitude = sqrtf(peak_power);
+        result->magnitude[c] = magnitude;
+        peak_bins[c] = 0;
+        coarse[c] = 0.0f;
+        if (peak_bin > 0 && peak_bin < HEX_BINS - 1 && magnitude >= HEX_MIN_MAGNITUDE) {
+            /* Parabolic estimate: starting point for the refinement */
+            float neighbourhood[3];
+            for (int i = 0; i < 3; i++) {
+                int k = peak_bin - 1 + i;
+                neighbourhood[i] = sqrtf(hex->re[k][c] * hex->re[k][c] + hex->im[k][c] * hex->im[k][c]);
+            }
+            peak_bins[c] = peak_bin;
+            coarse[c] = (float)peak_bin + parabolic_peak_offset(neighbourhood, 3, 1);
+        }
+    }
+
+    /* All lanes step together, so every pass sees the neighbours' latest
+       estimates */
+    static const float steps[REFINE_PASSES] = { 0.25f, 0.03f };
+    for (int pass = 0; pass < REFINE_PASSES; pass++) {
+        float refined[HEX_CHANNELS];
+        for (int c = 0; c < HEX_CHANNELS; c++) {
+            refined[c] = (peak_bins[c] > 0) ? refine_lane(hex, c, peak_bins[c], coarse, steps[pass]) : 0.0f;
+        }
+        memcpy(coarse, refined, sizeof(refined));
+    }
+
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        double frequency = 0.0;
+        if (peak_bins[c] > 0) {
+            frequency = (double)coarse[c] * HEX_SAMPLE_RATE / HEX_FFT_SIZE;
+            valid_count++;
+        }
+        result->strings[c] = analyze_tuning_table(hex->tuning, frequency, c + 1);
+        result->valid[c] = (frequency > 0.0);
+    }
+    return valid_count;
+}
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+static int analyze_rows(hex_analyzer_t* hex, const int peak[HEX_LANES], hex_result_t* result) {
+    int gate[HEX_LANES];
+    for (int l = 0; l < HEX_LANES; l++) {
+        gate[l] = (peak[l] >= HEX_MIN_AMPLITUDE);
+    }
+    prepare_rows(hex);
+    fft_rows(hex);
+    return pick_peaks(hex, gate, result);
+}
+
+int hex_analyzer_process(hex_analyzer_t* hex, const int16_t* const channels[HEX_CHANNELS], int num_samples,
+                         hex_result_t* result) {
+    int peak[HEX_LANES] = { 0 };
+    if (num_samples > HEX_FFT_SIZE) {
+        num_samples = HEX_FFT_SIZE;
+    }
+
+    memset(hex->re, 0, sizeof(hex->re));
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        const int16_t* samples = channels[c];
+        if (samples == NULL) {
+            continue;
+        }
+        for (int n = 0; n < num_samples; n++) {
+            int amplitude = samples[n] < 0 ? -samples[n] : samples[n];
+            if (amplitude > peak[c]) {
+                peak[c] = amplitude;
+            }
+            hex->re[n][c] = (float)samples[n] / 32768.0f;
+        }
+    }
+    return analyze_rows(hex, peak, result);
+}
+
+int hex_analyzer_process_interleaved(hex_analyzer_t* hex, const int16_t* frames, int num_frames,
+                                     hex_result_t* result) {
+    int peak[HEX_LANES] = { 0 };
+    if (num_frames > HEX_FFT_SIZE) {
+        num_frames = HEX_FFT_SIZE;
+    }
+
+    /* Interleaved input is already row-major: one frame is one row */
+    memset(hex->re, 0, sizeof(hex->re));
+    for (int n = 0; n < num_frames; n++) {
+        const int16_t* frame = &frames[n * HEX_CHANNELS];
+        for (int c = 0; c < HEX_CHANNELS; c++) {
+            int amplitude = frame[c] < 0 ? -frame[c] : frame[c];
+            if (amplitude > peak[c]) {
+                peak[c] = amplitude;
+            }
+            hex->re[n][c] = (float)frame[c] / 32768.0f;
+        }
+    }
+    return analyze_rows(hex, peak, result);
+}
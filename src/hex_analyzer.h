@@ -0,0 +1,113 @@
+/**
+ * hex_analyzer.h - Six-channel analysis for hexaphonic pickups
+ *
+ * With a hex pickup every string arrives on its own channel, so all six can
+ * be tuned at once. Rather than running the mono analysis six times through
+ * the same buffers, the six channels are processed together in
+ * structure-of-arrays form: sample n of every channel sits in one row of
+ * HEX_LANES floats, so each step of the pipeline (DC removal, window, FFT
+ * butterflies, magnitudes) is an inner loop over the lanes that the compiler
+ * turns into SIMD, and every twiddle factor and window value is loaded once
+ * for all six strings.
+ *
+ *     static hex_analyzer_t hex;
+ *     hex_analyzer_init(&hex, NULL);                  // standard guitar
+ *     ...
+ *     hex_result_t result;
+ *     hex_analyzer_process_interleaved(&hex, frames, 256, &result);
+ *     // result.strings[0] is string 1 (high E) ... strings[5] is string 6
+ *
+ * - Channel c carries string c + 1 (TuningResult numbering), and its result
+ *   is analyzed against that string's target, never auto-detected
+ * - Each channel's peak search is limited to its own string's range, from
+ *   half an octave below the open string to just past the 12th fret, so
+ *   bleed from neighbouring strings is not reported as the played note
+ * - Same 256-point frame and Hann window as apply_fft(); the peak is then
+ *   refined below the bin spacing by fitting the string's f0 and 2*f0 (with
+ *   their negative-frequency images), the residual DC and the neighbouring
+ *   strings' bleed to the bins around it, to within a cent or so
+ * - A six-string frame costs about two mono frames (TEST 21 prints the ratio)
+ */
+
+#ifndef HEX_ANALYZER_H
+#define HEX_ANALYZER_H
+
+#include <stdint.h>
+#include "string_detection.h"
+#include "tuning_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define HEX_CHANNELS        6
+#define HEX_LANES           8       // Channels padded to a whole SIMD register row
+#define HEX_FFT_SIZE        256     // Samples per frame per channel (as apply_fft)
+#define HEX_SAMPLE_RATE     10000   // Hz (SAMPLE_RATE)
+#define HEX_MIN_AMPLITUDE   50      // Per-channel gate (MIN_AMPLITUDE)
+#define HEX_MIN_MAGNITUDE   0.5f    // Per-channel peak threshold (fixed mono threshold)
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef struct {
+    /* Work rows: [sample][lane], aligned for vector loads */
+    float re[HEX_FFT_SIZE][HEX_LANES] __attribute__((aligned(32)));
+    float im[HEX_FFT_SIZE][HEX_LANES] __attribute__((aligned(32)));
+
+    /* Shared by all lanes, built once */
+    float window[HEX_FFT_SIZE];
+    float twiddle_re[HEX_FFT_SIZE / 2];
+    float twiddle_im[HEX_FFT_SIZE / 2];
+    uint16_t bit_reverse[HEX_FFT_SIZE];
+
+    /* Per-channel peak search range [first_bin, last_bin] */
+    uint16_t first_bin[HEX_CHANNELS];
+    uint16_t last_bin[HEX_CHANNELS];
+    const tuning_table_t* tuning;
+} hex_analyzer_t;
+
+typedef struct {
+    TuningResult strings[HEX_CHANNELS];     // strings[c] is string c + 1
+    float magnitude[HEX_CHANNELS];          // Peak magnitude per channel
+    uint8_t valid[HEX_CHANNELS];            // 0 = channel silent or no peak
+} hex_result_t;
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/**
+ * Build window, twiddles and per-string search ranges
+ *
+ * @param tuning: Six-string profile, NULL for standard guitar
+ */
+void hex_analyzer_init(hex_analyzer_t* hex, const tuning_table_t* tuning);
+
+/**
+ * Analyze one frame of six separate channel buffers
+ *
+ * @param channels: HEX_CHANNELS pointers (NULL = channel not connected)
+ * @param num_samples: Samples per channel, up to HEX_FFT_SIZE (zero padded)
+ * @return Number of strings with a valid note
+ */
+int hex_analyzer_process(hex_analyzer_t* hex, const int16_t* const channels[HEX_CHANNELS], int num_samples,
+                         hex_result_t* result);
+
+/**
+ * Same for interleaved input (frame n = samples n*6 ... n*6+5, as a
+ * multichannel codec delivers them)
+ */
+int hex_analyzer_process_interleaved(hex_analyzer_t* hex, const int16_t* frames, int num_frames,
+                                     hex_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HEX_ANALYZER_H
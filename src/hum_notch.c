@@ -0,0 +1,357 @@
+/**
+ * hum_notch.c - Adaptive mains-hum notch bank implementation
+ *
+ * Each harmonic h is cancelled by an adaptive noise canceller (Widrow):
+ *   y[n] = x[n] - (wc * cos(h*phi[n]) + ws * sin(h*phi[n]))
+ *   wc += 2*mu*y[n]*cos(h*phi[n]),  ws += 2*mu*y[n]*sin(h*phi[n])
+ * which behaves as a second-order notch of width ~mu*fs/pi Hz centred on the
+ * reference. The reference is a recursive phasor rotation (no sin/cos per
+ * sample), renormalized at every tracking update. A frozen harmonic keeps
+ * subtracting with its weights held.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "hum_notch.h"
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+
+/* Goertzel probe frequencies: 50 Hz family then 60 Hz family; each centre
+   is followed by its two side probes */
+static const float detect_hz[4] = {50.0f, 100.0f, 60.0f, 120.0f};
+
+/**
+ * Point the reference oscillators at the current mains frequency
+ * Phase is kept so the weights stay valid across small retunes
+ */
+static void set_reference(hum_notch_t* notch) {
+	for (uint32_t h = 0; h < notch->num_harmonics; h++) {
+		float w = 2.0f * PI * (float)(h + 1) * notch->mains_hz / notch->sample_rate;
+		notch->rot_cos[h] = cosf(w);
+		notch->rot_sin[h] = sinf(w);
+	}
+}
+
+/**
+ * Start cancelling at a nominal mains frequency
+ */
+static void lock(hum_notch_t* notch, float nominal_hz) {
+	notch->nominal_hz = nominal_hz;
+	notch->mains_hz = nominal_hz;
+	notch->num_harmonics = 0;
+	while (notch->num_harmonics < HUM_NOTCH_HARMONICS &&
+	       (float)(notch->num_harmonics + 1) * nominal_hz + HUM_TRACK_MAX_DEVIATION_HZ < 0.5f * notch->sample_rate) {
+		notch->num_harmonics++;
+	}
+
+	for (uint32_t h = 0; h < HUM_NOTCH_HARMONICS; h++) {
+		notch->osc_cos[h] = 1.0f;
+		notch->osc_sin[h] = 0.0f;
+		notch->weight_cos[h] = 0.0f;
+		notch->weight_sin[h] = 0.0f;
+		notch->held_cos[h] = 0.0f;
+		notch->held_sin[h] = 0.0f;
+	}
+	notch->last_phase = 0.0f;
+	notch->last_phase_valid = 0;
+	notch->track_count = 0;
+	notch->track_cos = 0.0f;
+	notch->track_sin = 0.0f;
+	notch->frozen = 0;
+	notch->settle = HUM_SETTLE_SAMPLES;
+	set_reference(notch);
+}
+
+/**
+ * Restart the 50/60 Hz detection window
+ */
+static void restart_detection(hum_notch_t* notch) {
+	memset(notch->detect_s1, 0, sizeof(notch->detect_s1));
+	memset(notch->detect_s2, 0, sizeof(notch->detect_s2));
+	notch->detect_energy = 0.0f;
+	notch->detect_count = 0;
+}
+
+void hum_notch_init(hum_notch_t* notch, hum_notch_mode_t mode, float sample_rate) {
+	memset(notch, 0, sizeof(*notch));
+	notch->mode = mode;
+	notch->sample_rate = sample_rate;
+
+	for (int i = 0; i < 4; i++) {
+		for (int side = 0; side < 3; side++) {
+			float hz = detect_hz[i] + (float)(side - 1) * HUM_DETECT_SIDE_HZ;
+			notch->detect_coeff[3 * i + side] = 2.0f * cosf(2.0f * PI * hz / sample_rate);
+		}
+	}
+
+	if (mode == HUM_NOTCH_50HZ) {
+		lock(notch, 50.0f);
+	} else if (mode == HUM_NOTCH_60HZ) {
+		lock(notch, 60.0f);
+	}
+}
+
+/**
+ * Run the Goertzel probes over a block and decide on 50 vs 60 Hz once the
+ * window is complete. A window without a clear winner, or with much energy
+ * away from the hum (a string playing), starts the count of agreeing
+ * windows over and idles detection for HUM_DETECT_IDLE_WINDOWS windows.
+ */
+static void detect(hum_notch_t* notch, const float* samples, uint32_t num_samples) {
+	if (notch->detect_idle >= num_samples) {
+		notch->detect_idle -= num_samples;
+		return;
+	}
+	samples += notch->detect_idle;
+	num_samples -= notch->detect_idle;
+	notch->detect_idle = 0;
+
+	for (uint32_t n = 0; n < num_samples; n++) {
+		float x = samples[n];
+		for (int i = 0; i < HUM_DETECT_PROBES; i++) {
+			float s0 = x + notch->detect_coeff[i] * notch->detect_s1[i] - notch->detect_s2[i];
+			notch->detect_s2[i] = notch->detect_s1[i];
+			notch->detect_s1[i] = s0;
+		}
+		notch->detect_energy += x * x;
+
+		if (++notch->detect_count < HUM_DETECT_SAMPLES) {
+			continue;
+		}
+
+		/* Centre power, or 0 when a side probe is as strong (energy beside
+		   the mains frequency is a string, not hum) */
+		float power[4];
+		for (int i = 0; i < 4; i++) {
+			float side_power[3];
+			for (int side = 0; side < 3; side++) {
+				int k = 3 * i + side;
+				float s1 = notch->detect_s1[k];
+				float s2 = notch->detect_s2[k];
+				side_power[side] = s1 * s1 + s2 * s2 - notch->detect_coeff[k] * s1 * s2;
+			}
+			int peaked = (side_power[1] > side_power[0] && side_power[1] > side_power[2]);
+			power[i] = peaked ? side_power[1] : 0.0f;
+		}
+		float power_50 = power[0] + power[1];
+		float power_60 = power[2] + power[3];
+
+		/* |X|^2 = (A*N/2)^2 for a sinusoid of amplitude A -> RMS^2 = 2|X|^2/N^2 */
+		float n2 = (float)HUM_DETECT_SAMPLES * (float)HUM_DETECT_SAMPLES;
+		float min_power = HUM_DETECT_MIN_RMS * HUM_DETECT_MIN_RMS * n2 / 2.0f;
+
+		float winner = 0.0f;
+		float winner_power = 0.0f;
+		if (power[0] > min_power && power_50 > HUM_DETECT_RATIO * power_60) {
+			winner = 50.0f;
+			winner_power = power_50;
+		} else if (power[2] > min_power && power_60 > HUM_DETECT_RATIO * power_50) {
+			winner = 60.0f;
+			winner_power = power_60;
+		}
+
+		/* Mean square on the probes (2|X|^2/N^2) against the window's (energy/N) */
+		float explained = 2.0f * winner_power / n2;
+		float mean_square = notch->detect_energy / (float)HUM_DETECT_SAMPLES;
+		int quiet = (explained >= HUM_DETECT_PURITY * mean_square);
+
+		if (winner == 0.0f || !quiet) {
+			notch->detect_votes = 0;
+			notch->detect_idle = HUM_DETECT_IDLE_WINDOWS * HUM_DETECT_SAMPLES;
+		} else if (winner == notch->detect_candidate) {
+			notch->detect_votes++;
+		} else {
+			notch->detect_candidate = winner;
+			notch->detect_votes = 1;
+		}
+		if (notch->detect_votes >= HUM_DETECT_WINDOWS) {
+			lock(notch, winner);
+			return;
+		}
+		restart_detection(notch);
+		if (notch->detect_idle > 0) {
+			detect(notch, samples + n + 1, num_samples - n - 1);
+			return;
+		}
+	}
+}
+
+/**
+ * Nudge the reference toward the real mains frequency
+ *
+ * The weights of the fundamental rotate at f_mains - f_ref when the
+ * reference is slightly off. Only the fundamental is used: a string near a
+ * higher harmonic can outweigh the hum there, and its phase would walk the
+ * whole bank toward the string. The fundamental sits below every guitar
+ * string. A frozen harmonic's weights stay valid across retunes since
+ * they are relative to its own reference.
+ */
+static void track_frequency(hum_notch_t* notch) {
+	for (uint32_t h = 0; h < notch->num_harmonics; h++) {
+		/* Renormalize the oscillator against slow rounding drift */
+		float c = notch->osc_cos[h];
+		float s = notch->osc_sin[h];
+		float g = 1.5f - 0.5f * (c * c + s * s);
+		notch->osc_cos[h] = c * g;
+		notch->osc_sin[h] = s * g;
+	}
+
+	/* Interval mean: a note beating against the fundamental ripples its
+	   weights, and the ripple mostly averages out over the interval */
+	float wc = notch->track_cos / (float)HUM_TRACK_INTERVAL;
+	float ws = notch->track_sin / (float)HUM_TRACK_INTERVAL;
+	notch->track_cos = 0.0f;
+	notch->track_sin = 0.0f;
+	float phase = atan2f(-ws, wc);
+
+	/* Only trust the phase once the canceller holds real hum at both ends
+	   of the interval */
+	float min_amplitude = HUM_DETECT_MIN_RMS;
+	int valid = (wc * wc + ws * ws > min_amplitude * min_amplitude);
+	if (!(notch->frozen & 1u) && valid && notch->last_phase_valid) {
+		float delta = phase - notch->last_phase;
+		if (delta > PI) {
+			delta -= 2.0f * PI;
+		} else if (delta < -PI) {
+			delta += 2.0f * PI;
+		}
+
+		float offset_hz = delta * notch->sample_rate / (2.0f * PI * HUM_TRACK_INTERVAL);
+		notch->mains_hz += HUM_TRACK_GAIN * offset_hz;
+
+		/* Hum harmonic h drifts h times as fast as the fundamental against
+		   its reference; carry the held weights of frozen harmonics along */
+		for (uint32_t h = 1; h < notch->num_harmonics; h++) {
+			if (notch->frozen & (1u << h)) {
+				float c = cosf((float)(h + 1) * delta);
+				float s = sinf((float)(h + 1) * delta);
+				float w_cos = notch->weight_cos[h];
+				float w_sin = notch->weight_sin[h];
+				notch->weight_cos[h] = w_cos * c + w_sin * s;
+				notch->weight_sin[h] = w_sin * c - w_cos * s;
+			}
+		}
+
+		/* Same deviation in Hz at the highest harmonic, less below it */
+		float deviation = HUM_TRACK_MAX_DEVIATION_HZ / (float)notch->num_harmonics;
+		if (notch->mains_hz > notch->nominal_hz + deviation) {
+			notch->mains_hz = notch->nominal_hz + deviation;
+		} else if (notch->mains_hz < notch->nominal_hz - deviation) {
+			notch->mains_hz = notch->nominal_hz - deviation;
+		}
+		set_reference(notch);
+	}
+
+	notch->last_phase = phase;
+	notch->last_phase_valid = valid;
+
+	for (uint32_t h = 0; h < notch->num_harmonics; h++) {
+		if (!(notch->frozen & (1u << h))) {
+			notch->held_cos[h] = notch->weight_cos[h];
+			notch->held_sin[h] = notch->weight_sin[h];
+		}
+	}
+}
+
+void hum_notch_process(hum_notch_t* notch, float* samples, uint32_t num_samples) {
+	if (notch->mode == HUM_NOTCH_OFF) {
+		return;
+	}
+
+	if (notch->note_hold > num_samples) {
+		notch->note_hold -= num_samples;
+	} else {
+		notch->note_hold = 0;
+		notch->frozen = 0;
+	}
+	notch->settle = (notch->settle > num_samples) ? notch->settle - num_samples : 0;
+
+	if (notch->nominal_hz == 0.0f) {
+		detect(notch, samples, num_samples);
+		return;     /* Samples of the detection window pass through */
+	}
+
+	const float two_mu = 2.0f * HUM_NOTCH_STEP_SIZE;
+	uint32_t harmonics = notch->num_harmonics;
+	uint32_t frozen = notch->frozen;
+
+	for (uint32_t n = 0; n < num_samples; n++) {
+		float y = samples[n];
+
+		/* Subtract every harmonic's estimate, then adapt all on the residual */
+		for (uint32_t h = 0; h < harmonics; h++) {
+			y -= notch->weight_cos[h] * notch->osc_cos[h] + notch->weight_sin[h] * notch->osc_sin[h];
+		}
+
+		for (uint32_t h = 0; h < harmonics; h++) {
+			float c = notch->osc_cos[h];
+			float s = notch->osc_sin[h];
+			if (!(frozen & (1u << h))) {
+				notch->weight_cos[h] += two_mu * y * c;
+				notch->weight_sin[h] += two_mu * y * s;
+			}
+
+			/* Advance the reference phasor by one sample */
+			notch->osc_cos[h] = c * notch->rot_cos[h] - s * notch->rot_sin[h];
+			notch->osc_sin[h] = s * notch->rot_cos[h] + c * notch->rot_sin[h];
+		}
+
+		samples[n] = y;
+
+		notch->track_cos += notch->weight_cos[0];
+		notch->track_sin += notch->weight_sin[0];
+		if (++notch->track_count == HUM_TRACK_INTERVAL) {
+			notch->track_count = 0;
+			track_frequency(notch);
+		}
+	}
+}
+
+/**
+ * Is a reported frequency one of the hum harmonics (the analyzer picked up
+ * the hum itself rather than a string)?
+ */
+static int is_hum_frequency(const hum_notch_t* notch, float hz) {
+	for (uint32_t h = 1; h <= notch->num_harmonics; h++) {
+		float harmonic = (float)h * notch->mains_hz;
+		if (fabsf(hz - harmonic) <= HUM_NOTE_IS_HUM * harmonic) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void hum_notch_set_note(hum_notch_t* notch, float note_hz) {
+	if (notch->nominal_hz == 0.0f || notch->settle > 0 || note_hz <= 0.0f || is_hum_frequency(notch, note_hz)) {
+		return;
+	}
+	notch->note_hz = note_hz;
+	notch->note_hold = HUM_NOTE_HOLD_SAMPLES;
+
+	/* Freeze every harmonic that one of the note's partials sits next to */
+	uint32_t frozen = 0;
+	float top = ((float)notch->num_harmonics + 0.5f) * notch->mains_hz;
+	for (float partial = note_hz; partial < top; partial += note_hz) {
+		for (uint32_t h = 0; h < notch->num_harmonics; h++) {
+			float harmonic = (float)(h + 1) * notch->mains_hz;
+			if (fabsf(partial - harmonic) <= HUM_NOTE_GUARD * harmonic) {
+				frozen |= 1u << h;
+			}
+		}
+	}
+	/* The note reached the cancellers a frame before it was reported; start
+	   newly frozen harmonics from weights learned before it arrived */
+	for (uint32_t h = 0; h < notch->num_harmonics; h++) {
+		if ((frozen & ~notch->frozen) & (1u << h)) {
+			notch->weight_cos[h] = notch->held_cos[h];
+			notch->weight_sin[h] = notch->held_sin[h];
+		}
+	}
+	notch->frozen = frozen;
+}
+
+float hum_notch_mains_hz(const hum_notch_t* notch) {
+	return (notch->mode == HUM_NOTCH_OFF) ? 0.0f : notch->mains_hz;
+}
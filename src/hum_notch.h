@@ -0,0 +1,158 @@
+/**
+ * hum_notch.h - Adaptive mains-hum notch bank
+ *
+ * Mains hum (50 or 60 Hz) and its low harmonics sit right among the guitar
+ * fundamentals (100/120 Hz next to A2, 150/180 Hz next to D3), where a fixed
+ * high-pass cannot remove them. This module cancels them instead:
+ *
+ * 1. DETECTION: Goertzel energies at 50/100 Hz and 60/120 Hz over a short
+ *    window decide which mains frequency is present (or that there is none).
+ *    Each probe only counts when it is sharper than probes a few Hz either
+ *    side (a string at 98 or 123 Hz leaks into the 100/120 Hz probes but
+ *    peaks beside them) and the 50/60 Hz fundamental itself must be
+ *    present. The same answer must then come from HUM_DETECT_WINDOWS
+ *    consecutive windows whose energy the hum probes explain (no string
+ *    playing): hum persists across the silence between notes, a held
+ *    string does not.
+ *
+ * 2. CANCELLATION: one adaptive noise canceller per harmonic (two-weight LMS
+ *    on a quadrature reference oscillator). Its response is a notch a
+ *    fraction of a Hz wide that follows the hum's amplitude and phase, so a
+ *    string a few Hz away passes untouched.
+ *
+ * 3. TRACKING: the phase of the fundamental's canceller weights rotates at
+ *    the offset between the true mains frequency and the reference, so the
+ *    reference is nudged toward the actual grid frequency. The range is
+ *    fixed in Hz at the highest notched harmonic (+/-HUM_TRACK_MAX_DEVIATION_HZ
+ *    there, so +/-0.5 Hz of the grid at the fundamental with four
+ *    harmonics), so no harmonic's notch can wander onto a neighbouring
+ *    string. The
+ *    phase is taken from the weights averaged over an update interval of
+ *    whole mains periods, so the ripple of the other harmonics (and of a
+ *    string beating against the fundamental) averages out.
+ *
+ * 4. NOTE GUARD: the analyzer reports each detected note with
+ *    hum_notch_set_note(). While a partial of it lies within
+ *    HUM_NOTE_GUARD of a notched harmonic, that canceller stops adapting and
+ *    keeps subtracting the hum it had learned, rotated along with the
+ *    fundamental's drift, instead of learning the string (G2 at 98 Hz next
+ *    to 100 Hz, G3 at 196 Hz next to 200 Hz).
+ *    Reports are ignored for HUM_SETTLE_SAMPLES after locking: until the
+ *    hum is cancelled the analyzer may report the hum itself.
+ *
+ * Cost is about 8 multiply-adds per sample per harmonic once locked. While
+ * detecting, HUM_DETECT_PROBES Goertzel recurrences run per sample; after a
+ * window without hum, detection idles for HUM_DETECT_IDLE_WINDOWS windows,
+ * so with no hum in the room they run one window in four.
+ */
+
+#ifndef HUM_NOTCH_H
+#define HUM_NOTCH_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HUM_NOTCH_HARMONICS         4       /* Fundamental plus 3 harmonics (up to 200/240 Hz) */
+#define HUM_NOTCH_STEP_SIZE         0.0005f /* LMS step: ~0.8 Hz notch width, ~0.2 s convergence */
+#define HUM_DETECT_SAMPLES          2000    /* Goertzel window for 50/60 Hz detection (0.2 s at 10 kHz) */
+#define HUM_DETECT_RATIO            4.0f    /* Winning mains frequency must carry 4x the other's energy */
+#define HUM_DETECT_MIN_RMS          0.002f  /* Below this hum level (~ -54 dBFS) nothing is notched */
+#define HUM_DETECT_SIDE_HZ          2.5f    /* Side probes a peaked hum probe must beat (half a 5 Hz bin) */
+#define HUM_DETECT_WINDOWS          2       /* Consecutive note-free windows agreeing before AUTO locks */
+#define HUM_DETECT_PURITY           0.5f    /* Share of a window's energy on the hum probes (no note) */
+#define HUM_DETECT_PROBES           12      /* 50, 100, 60, 120 Hz, each with two side probes */
+#define HUM_DETECT_IDLE_WINDOWS     3       /* Windows skipped after one without hum (0.6 s) */
+#define HUM_TRACK_INTERVAL          1000    /* Samples between tracking updates (whole 50/60 Hz periods) */
+#define HUM_TRACK_GAIN              0.5f    /* Fraction of the measured offset applied per update */
+#define HUM_TRACK_MAX_DEVIATION_HZ  2.0f    /* Tracking range at the highest notched harmonic */
+#define HUM_NOTE_GUARD              0.03f   /* Note partial this close (relative) to a harmonic freezes it */
+#define HUM_NOTE_IS_HUM             0.01f   /* Reported "notes" this close to a harmonic are the hum itself */
+#define HUM_NOTE_HOLD_SAMPLES       1280    /* Guard outlives the last note report (~10 frames) */
+#define HUM_SETTLE_SAMPLES          5000    /* Note reports ignored after locking (0.5 s) */
+
+/* Mains selection */
+typedef enum {
+	HUM_NOTCH_OFF = 0,          /* Pass-through */
+	HUM_NOTCH_AUTO,             /* Detect 50 or 60 Hz from the input */
+	HUM_NOTCH_50HZ,             /* Force 50 Hz mains */
+	HUM_NOTCH_60HZ              /* Force 60 Hz mains */
+} hum_notch_mode_t;
+
+typedef struct {
+	hum_notch_mode_t mode;
+	float sample_rate;
+	float nominal_hz;           /* 50 or 60 once locked, 0 while detecting */
+	float mains_hz;             /* Tracked mains frequency */
+
+	/* Detection (Goertzel state for 50, 100, 60 and 120 Hz and their side probes) */
+	float detect_coeff[HUM_DETECT_PROBES];
+	float detect_s1[HUM_DETECT_PROBES];
+	float detect_s2[HUM_DETECT_PROBES];
+	float detect_energy;        /* Sum of squares over the detection window */
+	uint32_t detect_count;
+	float detect_candidate;     /* Mains frequency of the agreeing windows so far */
+	uint32_t detect_votes;
+	uint32_t detect_idle;       /* Samples passed through before probing resumes */
+
+	/* Quadrature reference oscillator and LMS weights per harmonic */
+	float osc_cos[HUM_NOTCH_HARMONICS];
+	float osc_sin[HUM_NOTCH_HARMONICS];
+	float rot_cos[HUM_NOTCH_HARMONICS];
+	float rot_sin[HUM_NOTCH_HARMONICS];
+	float weight_cos[HUM_NOTCH_HARMONICS];
+	float weight_sin[HUM_NOTCH_HARMONICS];
+	float held_cos[HUM_NOTCH_HARMONICS];    /* Weights one tracking interval back */
+	float held_sin[HUM_NOTCH_HARMONICS];
+	uint32_t num_harmonics;     /* Harmonics below Nyquist */
+
+	/* Frequency tracking */
+	float last_phase;           /* Fundamental's weight phase at the last update */
+	int last_phase_valid;       /* ... taken with converged weights */
+	uint32_t track_count;
+	float track_cos;            /* Fundamental's weights summed over the interval */
+	float track_sin;
+
+	/* Note guard */
+	float note_hz;              /* Latest reported note, 0 when none */
+	uint32_t note_hold;         /* Samples until the guard lapses */
+	uint32_t frozen;            /* Bit h set: harmonic h + 1 does not adapt */
+	uint32_t settle;            /* Samples until note reports are honoured */
+} hum_notch_t;
+
+/**
+ * Initialize the notch bank
+ *
+ * @param mode: HUM_NOTCH_OFF, HUM_NOTCH_AUTO, HUM_NOTCH_50HZ or HUM_NOTCH_60HZ
+ * @param sample_rate: Sample rate in Hz
+ */
+void hum_notch_init(hum_notch_t* notch, hum_notch_mode_t mode, float sample_rate);
+
+/**
+ * Filter one block in place; state carries over to the next call
+ * Samples are expected normalized to [-1, 1]
+ */
+void hum_notch_process(hum_notch_t* notch, float* samples, uint32_t num_samples);
+
+/**
+ * Report the analyzer's latest note (call once per analyzed frame)
+ *
+ * Guards the notched harmonics near the note's partials for the next
+ * HUM_NOTE_HOLD_SAMPLES. A "note" within HUM_NOTE_IS_HUM of a hum harmonic
+ * is the hum itself and is ignored, as are 0 (no note) and reports while
+ * detecting or settling.
+ */
+void hum_notch_set_note(hum_notch_t* notch, float note_hz);
+
+/**
+ * Tracked mains frequency in Hz (0.0 while detecting or when no hum was found)
+ */
+float hum_notch_mains_hz(const hum_notch_t* notch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HUM_NOTCH_H */
@@ -22,6 +22,23 @@
 /* Include all headers */
 #include "audio_processing.h"
 #include "string_detection.h"
+#include "signal_processing.h"
+#include "audio_capture.h"
+#include "wav_reader.h"
+#include "wav_decoder.h"
+#include "audio_sequencer.h"
+#include "prompt_cache.h"
+#include "prompt_bundle.h"
+#include "tone_synth.h"
+#include "feedback_scheduler.h"
+#include "voice_mixer.h"
+#include "tuner_session.h"
+#include "hex_analyzer.h"
+#include "strum_analyzer.h"
+#include "phase_tracker.h"
+#include "cqt_analyzer.h"
+#include "progressive_estimator.h"
+#include "hardware_interface.h"
 
 /* Test configuration */
 #define TEST_VERBOSE 1
@@ -562,6 +579,2210 @@ void test_performance(void) {
     printf("  Status:               [OK] REAL-TIME CAPABLE\n\n");
 }
 
+/* ============================================================
+   TEST 7: TUNING PROFILES
+   ============================================================ */
+
+void test_tuning_profiles(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 7: TUNING PROFILES\n");
+    printf("================================================\n\n");
+    
+    int pass_count = 0;
+    int num_tests = 0;
+    
+    /* Serialize a built-in profile and load it back (SD card round trip) */
+    uint8_t blob[TUNING_TABLE_MAX_BYTES];
+    tuning_table_t loaded;
+    const tuning_table_t* bass = tuning_table_builtin(TUNING_PROFILE_BASS_STANDARD);
+    size_t size = tuning_table_serialize(bass, blob, sizeof(blob));
+    int pass = (size > 0 && tuning_table_load_blob(&loaded, blob, size) == TUNING_OK &&
+                loaded.string_count == 4 && strcmp(loaded.name, bass->name) == 0);
+    printf("Binary round trip (%s, %zu bytes) | %s\n", bass->name, size, pass ? "[OK] PASS" : "[X] FAIL");
+    num_tests++;
+    if (pass) pass_count++;
+    
+    /* The built-in index is precomputed; it must match a fresh build */
+    pass = 1;
+    for (int p = 0; p < TUNING_PROFILE_COUNT; p++) {
+        const tuning_table_t* builtin = tuning_table_builtin((tuning_profile_t)p);
+        loaded = *builtin;
+        tuning_table_build_index(&loaded);
+        if (memcmp(&loaded, builtin, sizeof(loaded)) != 0) {
+            printf("  %s: index differs from tuning_table_build_index()\n", builtin->name);
+            pass = 0;
+        }
+    }
+    printf("Precomputed built-in indexes | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    num_tests++;
+    if (pass) pass_count++;
+    
+    /* Corrupted magic must be rejected */
+    blob[0] ^= 0xFF;
+    pass = (tuning_table_load_blob(&loaded, blob, size) == TUNING_FORMAT_ERROR);
+    printf("Corrupt header rejected | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    num_tests++;
+    if (pass) pass_count++;
+    
+    /* Switching profile changes string matching without recompiling */
+    struct {
+        tuning_profile_t profile;
+        double frequency;
+        int expected_string;
+    } cases[] = {
+        {TUNING_PROFILE_GUITAR_DROP_D, 73.0, 6},
+        {TUNING_PROFILE_GUITAR_7_STANDARD, 62.0, 7},
+        {TUNING_PROFILE_BASS_STANDARD, 41.5, 4},
+        {TUNING_PROFILE_UKULELE_STANDARD, 390.0, 4},
+        {TUNING_PROFILE_UKULELE_STANDARD, 262.0, 3},
+        {TUNING_PROFILE_GUITAR_STANDARD, 110.5, 5}
+    };
+    int num_cases = sizeof(cases) / sizeof(cases[0]);
+    
+    for (int i = 0; i < num_cases; i++) {
+        const tuning_table_t* table = tuning_table_builtin(cases[i].profile);
+        string_detection_set_tuning(table);
+        TuningResult result = analyze_tuning_auto(cases[i].frequency);
+        pass = (result.detected_string == cases[i].expected_string);
+        printf("%-18s %.1f Hz -> String %d (expected %d) | %s\n",
+               table->name, cases[i].frequency, result.detected_string,
+               cases[i].expected_string, pass ? "[OK] PASS" : "[X] FAIL");
+        num_tests++;
+        if (pass) pass_count++;
+    }
+    string_detection_set_tuning(tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD));
+    
+    printf("\n>> Tuning Profile Result: %d/%d PASSED (%.0f%%)\n\n",
+           pass_count, num_tests, 100.0 * pass_count / num_tests);
+}
+
+/* ============================================================
+   TEST 7B: BIQUAD PRE-FILTER
+   ============================================================ */
+
+/* Steady-state gain of the guitar band-pass at one frequency */
+static double prefilter_gain(biquad_cascade_t* cascade, double freq) {
+    static float x[4000];
+    for (int i = 0; i < 4000; i++) {
+        x[i] = (float)sin(2.0 * M_PI * freq * i / SAMPLE_RATE);
+    }
+    biquad_cascade_reset(cascade);
+    biquad_cascade_process(cascade, x, x, 4000);
+    float peak = 0.0f;
+    for (int i = 2000; i < 4000; i++) {
+        if (fabsf(x[i]) > peak) peak = fabsf(x[i]);
+    }
+    return peak;
+}
+
+void test_biquad_prefilter(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 7B: BIQUAD PRE-FILTER\n");
+    printf("================================================\n\n");
+    
+    biquad_cascade_t cascade;
+    static float x[4000], y[4000];
+    int pass_count = 0;
+    
+    /* Same band as audio_processing_init(): 82.41 / 1.5 Hz to 329.63 * 8 Hz */
+    biquad_cascade_design(&cascade, PREFILTER_BANDPASS, 82.41f / 1.5f, 329.63f * 8.0f, (float)SAMPLE_RATE);
+    
+    /* DC offset (ADC bias) is removed */
+    for (int i = 0; i < 4000; i++) x[i] = 0.25f;
+    biquad_cascade_reset(&cascade);
+    biquad_cascade_process(&cascade, x, y, 4000);
+    int pass = (fabsf(y[3999]) < 1e-4f);
+    printf("DC 0.25 -> %.6f after 400 ms | %s\n", y[3999], pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Open strings pass within 0.5 dB, rumble below the band does not */
+    const double strings[6] = { 82.41, 110.0, 146.83, 196.0, 246.94, 329.63 };
+    double lowest = 1.0, highest = 1.0;
+    for (int k = 0; k < 6; k++) {
+        double gain = prefilter_gain(&cascade, strings[k]);
+        if (gain < lowest) lowest = gain;
+        if (gain > highest) highest = gain;
+    }
+    double rumble = prefilter_gain(&cascade, 15.0);
+    pass = (20.0 * log10(lowest) > -0.5 && 20.0 * log10(highest) < 0.5 && 20.0 * log10(rumble) < -30.0);
+    printf("Open strings %.2f..%.2f dB, 15 Hz rumble %.1f dB | %s\n", 20.0 * log10(lowest),
+           20.0 * log10(highest), 20.0 * log10(rumble), pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* State carries across blocks: two halves equal one call */
+    for (int i = 0; i < 4000; i++) x[i] = (float)sin(2.0 * M_PI * 110.0 * i / SAMPLE_RATE);
+    biquad_cascade_reset(&cascade);
+    biquad_cascade_process(&cascade, x, y, 4000);
+    biquad_cascade_reset(&cascade);
+    biquad_cascade_process(&cascade, x, x, 1000);
+    biquad_cascade_process(&cascade, &x[1000], &x[1000], 3000);
+    float difference = 0.0f;
+    for (int i = 0; i < 4000; i++) {
+        if (fabsf(x[i] - y[i]) > difference) difference = fabsf(x[i] - y[i]);
+    }
+    pass = (difference < 1e-6f);
+    printf("Block split 1000 + 3000: max difference %.2e | %s\n", difference, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Biquad Pre-filter Result: %d/3 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 8: ADAPTIVE NOISE FLOOR
+   ============================================================ */
+
+/* Uniform white noise in [-amplitude, amplitude] */
+static void add_white_noise(int16_t* samples, int count, int amplitude) {
+    for (int i = 0; i < count; i++) {
+        int value = samples[i] + (rand() % (2 * amplitude + 1)) - amplitude;
+        samples[i] = (int16_t)(value > 32767 ? 32767 : (value < -32768 ? -32768 : value));
+    }
+}
+
+void test_noise_floor(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 8: ADAPTIVE NOISE FLOOR\n");
+    printf("================================================\n\n");
+    
+    int16_t samples[SAMPLE_SIZE];
+    int false_detections = 0;
+    int noise_frames = 64;
+    
+    srand(42);
+    audio_processing_reset_noise_floor();
+    
+    /* Noisy shop: broadband noise well above the fixed MIN_AMPLITUDE */
+    for (int frame = 0; frame < noise_frames; frame++) {
+        memset(samples, 0, sizeof(samples));
+        add_white_noise(samples, SAMPLE_SIZE, 2000);
+        double detected = apply_fft(samples, SAMPLE_SIZE);
+        /* Only count once the tracker has had its full history */
+        if (frame >= 32 && detected > 0.0) {
+            false_detections++;
+        }
+    }
+    int pass_noise = (false_detections == 0);
+    printf("Noise-only frames after learning: %d false detections | %s\n",
+           false_detections, pass_noise ? "[OK] PASS" : "[X] FAIL");
+    
+    /* A string in the same noise must still be found */
+    for (int i = 0; i < SAMPLE_SIZE; i++) {
+        samples[i] = (int16_t)(4000 * sin(2.0 * M_PI * 110.0 * i / SAMPLE_RATE));
+    }
+    add_white_noise(samples, SAMPLE_SIZE, 2000);
+    double detected = apply_fft(samples, SAMPLE_SIZE);
+    int pass_signal = (fabs(detected - 110.0) <= 20.0);
+    printf("A2 (110 Hz) in noise: Detected %.2f Hz | %s\n",
+           detected, pass_signal ? "[OK] PASS" : "[X] FAIL");
+    
+    /* A quiet room is learned from frames below the fixed gate, so a soft
+       note under MIN_AMPLITUDE is then accepted */
+    audio_processing_reset_noise_floor();
+    for (int frame = 0; frame < 40; frame++) {
+        memset(samples, 0, sizeof(samples));
+        add_white_noise(samples, SAMPLE_SIZE, 8);
+        apply_fft(samples, SAMPLE_SIZE);
+    }
+    for (int i = 0; i < SAMPLE_SIZE; i++) {
+        samples[i] = (int16_t)(38 * sin(2.0 * M_PI * 110.0 * i / SAMPLE_RATE));
+    }
+    add_white_noise(samples, SAMPLE_SIZE, 8);
+    detected = apply_fft(samples, SAMPLE_SIZE);
+    int pass_quiet = (fabs(detected - 110.0) <= 20.0);
+    printf("Quiet room, soft A2 (peak < %d): Detected %.2f Hz | %s\n", MIN_AMPLITUDE,
+           detected, pass_quiet ? "[OK] PASS" : "[X] FAIL");
+    
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> Noise Floor Result: %d/3 PASSED\n\n", pass_noise + pass_signal + pass_quiet);
+}
+
+/* ============================================================
+   TEST 9: MAINS HUM NOTCH
+   ============================================================ */
+
+/* Stream 60.4 Hz hum alone for 0.6 s (the room before the pluck), then
+   G3 (196 Hz) buried under it, through the streaming front end */
+static double stream_hum_and_note(hum_notch_mode_t mode) {
+    int16_t block[128];
+    double detected = 0.0;
+    
+    audio_processing_set_hum_notch(mode);
+    audio_processing_reset_noise_floor();
+    
+    for (int n0 = 0; n0 < 3 * SAMPLE_RATE; n0 += 128) {
+        for (int i = 0; i < 128; i++) {
+            double t = (double)(n0 + i) / SAMPLE_RATE;
+            double hum = 1500 * sin(2.0 * M_PI * 60.4 * t)
+                       + 3000 * sin(2.0 * M_PI * 120.8 * t + 0.3)
+                       + 600 * sin(2.0 * M_PI * 181.2 * t + 1.1);
+            double note = (t >= 0.6) ? 2000 * sin(2.0 * M_PI * 196.0 * t) : 0.0;
+            block[i] = (int16_t)(hum + note);
+        }
+        audio_processing_process_block(block, 128, &detected);
+    }
+    return detected;
+}
+
+/* Hann-weighted amplitude of one frequency over x[0..n) */
+static double tone_amplitude(const float* x, int n, double freq) {
+    double re = 0.0, im = 0.0, sum_w = 0.0;
+    for (int i = 0; i < n; i++) {
+        double w = 0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1)));
+        re += w * x[i] * cos(2.0 * M_PI * freq * i / SAMPLE_RATE);
+        im += w * x[i] * sin(2.0 * M_PI * freq * i / SAMPLE_RATE);
+        sum_w += w;
+    }
+    return 2.0 * sqrt(re * re + im * im) / sum_w;
+}
+
+/* One second of hum (or silence), then a held note under it for three,
+   straight through the notch with the note reported as the analyzer would.
+   Measured over the last two seconds: share of the note that survives and
+   of the hum that is left (0 without hum). Returns the locked mains. */
+static float hum_notch_case(double mains, double note, double* note_kept, double* hum_left) {
+    static float in_note[2 * SAMPLE_RATE], in_hum[2 * SAMPLE_RATE], out[2 * SAMPLE_RATE];
+    static const double hum_amplitude[4] = { 0.03, 0.06, 0.02, 0.02 };
+    hum_notch_t notch;
+    float block[128];
+    const int total = 4 * SAMPLE_RATE;
+    const int start = total - 2 * SAMPLE_RATE;     /* Measured span: the last two seconds */
+    
+    /* Blocks run past the end of `total`; only samples inside the span are kept */
+    hum_notch_init(&notch, HUM_NOTCH_AUTO, (float)SAMPLE_RATE);
+    for (int n0 = 0; n0 < total; n0 += 128) {
+        for (int i = 0; i < 128; i++) {
+            int n = n0 + i;
+            double t = (double)n / SAMPLE_RATE;
+            double hum = 0.0;
+            for (int h = 0; h < 4 && mains > 0.0; h++) {
+                hum += hum_amplitude[h] * sin(2.0 * M_PI * (h + 1) * mains * t + 0.7 * h);
+            }
+            double tone = (t >= 1.0) ? 0.06 * sin(2.0 * M_PI * note * t) : 0.0;
+            block[i] = (float)(hum + tone);
+            if (n >= start && n < total) {
+                in_note[n - start] = (float)tone;
+                in_hum[n - start] = (float)hum;
+            }
+        }
+        hum_notch_set_note(&notch, (n0 >= SAMPLE_RATE) ? (float)note : 0.0f);
+        hum_notch_process(&notch, block, 128);
+        for (int i = 0; i < 128; i++) {
+            int n = n0 + i;
+            if (n >= start && n < total) {
+                out[n - start] = block[i];
+            }
+        }
+    }
+    
+    *note_kept = tone_amplitude(out, 2 * SAMPLE_RATE, note) / tone_amplitude(in_note, 2 * SAMPLE_RATE, note);
+    double hum_in = 0.0, hum_out = 0.0;
+    for (int h = 1; h <= 4 && mains > 0.0; h++) {
+        double a = tone_amplitude(in_hum, 2 * SAMPLE_RATE, h * mains);
+        double b = tone_amplitude(out, 2 * SAMPLE_RATE, h * mains);
+        hum_in += a * a;
+        hum_out += b * b;
+    }
+    *hum_left = (hum_in > 0.0) ? sqrt(hum_out / hum_in) : 0.0;
+    return hum_notch_mains_hz(&notch);
+}
+
+void test_hum_notch(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 9: MAINS HUM NOTCH\n");
+    printf("================================================\n\n");
+    
+    double without_notch = stream_hum_and_note(HUM_NOTCH_OFF);
+    printf("Notch off:  Detected %.2f Hz (hum buries the note)\n", without_notch);
+    
+    double with_notch = stream_hum_and_note(HUM_NOTCH_AUTO);
+    float mains = audio_processing_mains_hz();
+    
+    int pass_mains = (fabs(mains - 60.4) < 0.3);
+    printf("Mains detection: %.2f Hz (expected 60.4) | %s\n",
+           mains, pass_mains ? "[OK] PASS" : "[X] FAIL");
+    
+    int pass_note = (fabs(with_notch - 196.0) <= 20.0);
+    printf("Notch auto: Detected %.2f Hz (expected G3 196 Hz) | %s\n",
+           with_notch, pass_note ? "[OK] PASS" : "[X] FAIL");
+    
+    /* Notes on and beside the hum harmonics: without hum nothing may lock;
+       with hum, the string survives while the hum is cancelled */
+    struct {
+        double mains;
+        double note;
+    } cases[] = {
+        {0.0, 98.0}, {0.0, 100.0}, {0.0, 120.0}, {0.0, 123.47}, {0.0, 150.0}, {0.0, 180.0}, {0.0, 196.0}, {0.0, 200.0},
+        {50.2, 98.0}, {50.2, 103.83}, {50.2, 146.83}, {50.2, 196.0},
+        {59.8, 116.54}, {59.8, 123.47}, {59.8, 174.61}, {59.8, 185.0}
+    };
+    int num_cases = sizeof(cases) / sizeof(cases[0]);
+    int pass_cases = 0;
+    for (int c = 0; c < num_cases; c++) {
+        double kept, left;
+        float locked = hum_notch_case(cases[c].mains, cases[c].note, &kept, &left);
+        int pass;
+        if (cases[c].mains == 0.0) {
+            pass = (locked == 0.0f && kept > 0.95);
+            printf("No hum,    note %6.2f Hz: lock %.1f Hz, note kept %5.1f%% | %s\n", cases[c].note, locked,
+                   100.0 * kept, pass ? "[OK] PASS" : "[X] FAIL");
+        } else {
+            /* A frozen canceller holds its tracking lag (~0.1 rad), so
+               guarded harmonics leave ~10% */
+            pass = (fabs(locked - cases[c].mains) < 0.3 && kept > 0.9 && left < 0.15);
+            printf("%.1f Hz hum, note %6.2f Hz: lock %.2f Hz, note kept %5.1f%%, hum left %4.1f%% | %s\n",
+                   cases[c].mains, cases[c].note, locked, 100.0 * kept, 100.0 * left,
+                   pass ? "[OK] PASS" : "[X] FAIL");
+        }
+        if (pass) pass_cases++;
+    }
+    /* Hum switched on after a quiet second: detection idles between
+       probing windows but must still find it */
+    hum_notch_t late;
+    float late_block[128];
+    hum_notch_init(&late, HUM_NOTCH_AUTO, (float)SAMPLE_RATE);
+    for (int n0 = 0; n0 < 3 * SAMPLE_RATE; n0 += 128) {
+        for (int i = 0; i < 128; i++) {
+            double t = (double)(n0 + i) / SAMPLE_RATE;
+            late_block[i] = (t >= 1.0) ? (float)(0.05 * sin(2.0 * M_PI * 50.2 * t)) : 0.0f;
+        }
+        hum_notch_process(&late, late_block, 128);
+    }
+    int pass_late = (fabs(hum_notch_mains_hz(&late) - 50.2) < 0.3);
+    printf("Hum from 1 s: lock %.2f Hz (expected 50.2) | %s\n", hum_notch_mains_hz(&late),
+           pass_late ? "[OK] PASS" : "[X] FAIL");
+    int pass_guard = (pass_cases == num_cases && pass_late);
+    
+    audio_processing_set_hum_notch(HUM_NOTCH_AUTO);
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> Hum Notch Result: %d/3 PASSED\n\n", pass_mains + pass_note + pass_guard);
+}
+
+/* ============================================================
+   TEST 10: HARMONIC VALIDATION
+   ============================================================ */
+
+/* Noise through a one-pole low-pass (kind 0, ~300 Hz: rumble, handling)
+   or two formant resonators (kind 1, ~700/1200 Hz: a whispered "ah") */
+static void coloured_noise(int16_t* samples, int count, int kind) {
+    static float buffer[SAMPLE_SIZE];
+    double pole = exp(-2.0 * M_PI * 300.0 / SAMPLE_RATE);
+    double formant_hz[2] = { 700.0, 1200.0 };
+    double y1[2] = { 0.0, 0.0 }, y2[2] = { 0.0, 0.0 };
+    double low = 0.0, peak = 1e-9;
+    for (int i = 0; i < count; i++) {
+        double x = (double)rand() / RAND_MAX - 0.5;
+        double y = 0.0;
+        if (kind == 0) {
+            low = pole * low + (1.0 - pole) * x;
+            y = low;
+        } else {
+            for (int f = 0; f < 2; f++) {
+                double r = exp(-M_PI * 120.0 / SAMPLE_RATE);
+                double v = x + 2.0 * r * cos(2.0 * M_PI * formant_hz[f] / SAMPLE_RATE) * y1[f] - r * r * y2[f];
+                y2[f] = y1[f];
+                y1[f] = v;
+                y += v;
+            }
+        }
+        buffer[i] = (float)y;
+        if (fabs(y) > peak) peak = fabs(y);
+    }
+    for (int i = 0; i < count; i++) {
+        samples[i] = (int16_t)(12000.0 * buffer[i] / peak);
+    }
+}
+
+void test_harmonic_validation(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 10: HARMONIC VALIDATION\n");
+    printf("================================================\n\n");
+    
+    int16_t samples[SAMPLE_SIZE];
+    int pass_count = 0;
+    int num_tests = 0;
+    
+    srand(7);
+    audio_processing_reset_noise_floor();
+    
+    /* Plucked strings: fundamental plus decaying partials must pass */
+    for (int s = 0; s < NUM_OPEN_STRINGS; s++) {
+        double f0 = open_strings[s].frequency;
+        for (int i = 0; i < SAMPLE_SIZE; i++) {
+            double t = (double)i / SAMPLE_RATE;
+            double value = 0.0;
+            for (int h = 1; h <= 5; h++) {
+                value += (6000.0 / h) * sin(2.0 * M_PI * h * f0 * t);
+            }
+            samples[i] = (int16_t)(value * exp(-3.0 * t));
+        }
+        double detected = apply_fft(samples, SAMPLE_SIZE);
+        float confidence = audio_processing_last_confidence();
+        int pass = (detected > 0.0 && confidence >= HARMONIC_CONFIDENCE_MIN);
+        printf("Pluck %-3s: confidence %.2f | %s\n", open_strings[s].name, confidence,
+               pass ? "[OK] PASS" : "[X] FAIL");
+        num_tests++;
+        if (pass) pass_count++;
+    }
+    
+    /* Clap: loud decaying broadband burst must be rejected */
+    for (int i = 0; i < SAMPLE_SIZE; i++) {
+        double envelope = exp(-(double)i / 60.0);
+        samples[i] = (int16_t)((rand() % 40001 - 20000) * envelope);
+    }
+    double detected = apply_fft(samples, SAMPLE_SIZE);
+    int pass = (detected == 0.0);
+    printf("Clap burst: confidence %.2f, detected %.2f Hz | %s\n",
+           audio_processing_last_confidence(), detected, pass ? "[OK] PASS" : "[X] FAIL");
+    num_tests++;
+    if (pass) pass_count++;
+    
+    /* Steady hiss (fan, breath) must be rejected */
+    memset(samples, 0, sizeof(samples));
+    add_white_noise(samples, SAMPLE_SIZE, 8000);
+    detected = apply_fft(samples, SAMPLE_SIZE);
+    pass = (detected == 0.0);
+    printf("White noise: confidence %.2f, detected %.2f Hz | %s\n",
+           audio_processing_last_confidence(), detected, pass ? "[OK] PASS" : "[X] FAIL");
+    num_tests++;
+    if (pass) pass_count++;
+    
+    /* Coloured noise piles its energy low, where the partials of a low
+       string sit close together: it must still be rejected, frame after
+       frame (each from a fresh noise floor) */
+    const char* noise_names[2] = { "Low-pass noise (300 Hz)", "Whispered vowel" };
+    for (int kind = 0; kind < 2; kind++) {
+        int accepted = 0;
+        float highest = 0.0f;
+        for (int frame = 0; frame < 20; frame++) {
+            audio_processing_reset_noise_floor();
+            coloured_noise(samples, SAMPLE_SIZE, kind);
+            if (apply_fft(samples, SAMPLE_SIZE) > 0.0) accepted++;
+            if (audio_processing_last_confidence() > highest) highest = audio_processing_last_confidence();
+        }
+        pass = (accepted == 0);
+        printf("%s: %d/20 frames accepted, highest confidence %.2f | %s\n", noise_names[kind], accepted,
+               highest, pass ? "[OK] PASS" : "[X] FAIL");
+        num_tests++;
+        if (pass) pass_count++;
+    }
+    
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> Harmonic Validation Result: %d/%d PASSED\n\n", pass_count, num_tests);
+}
+
+/* ============================================================
+   TEST 11: CAPTURE DRIVER SIMULATION
+   ============================================================ */
+
+void test_capture_driver(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 11: CAPTURE DRIVER SIMULATION\n");
+    printf("================================================\n\n");
+    
+    int pass_count = 0;
+    audio_capture_stats_t stats;
+    audio_capture_sine_t sine = {.frequency_hz = 196.0f, .amplitude = 8000.0f, .sample_rate = SAMPLE_RATE};
+    
+    audio_processing_reset_noise_floor();
+    
+    /* Generator backend: 1 s of G3 in 10 ms steps of virtual time */
+    audio_capture_init(SAMPLE_RATE, NULL, NULL);
+    audio_capture_sim_generator(audio_capture_sine_generator, &sine);
+    audio_capture_start();
+    
+    double detected = 0.0;
+    int frames_detected = 0;
+    for (int step = 0; step < 100; step++) {
+        audio_capture_sim_advance(SAMPLE_RATE / 100);
+        if (audio_processing_capture(&detected)) {
+            frames_detected++;
+        }
+    }
+    audio_capture_get_stats(&stats);
+    
+    /* A frame completes every 128 samples, so some 100-sample polls have nothing new */
+    int pass = (fabs(detected - 196.0) <= 20.0 && frames_detected >= 70);
+    printf("Generator: %d/100 polls detected, last %.2f Hz | %s\n",
+           frames_detected, detected, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    pass = (audio_capture_sample_clock() == SAMPLE_RATE &&
+            stats.blocks_delivered == SAMPLE_RATE / AUDIO_CAPTURE_BLOCK_SIZE && stats.blocks_dropped == 0);
+    printf("Virtual clock: %llu samples, %u blocks, %u dropped, slowest callback %u us | %s\n",
+           (unsigned long long)audio_capture_sample_clock(), stats.blocks_delivered,
+           stats.blocks_dropped, stats.max_callback_us, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    audio_capture_stop();
+    
+    /* File backend: raw PCM ends the stream at end of file */
+    const char* path = "capture_test.raw";
+    FILE* fp = fopen(path, "wb");
+    int16_t block[AUDIO_CAPTURE_BLOCK_SIZE];
+    for (int b = 0; b < 40; b++) {
+        audio_capture_sine_generator(block, AUDIO_CAPTURE_BLOCK_SIZE, (uint64_t)b * AUDIO_CAPTURE_BLOCK_SIZE, &sine);
+        for (int i = 0; i < AUDIO_CAPTURE_BLOCK_SIZE; i++) {
+            fputc(block[i] & 0xFF, fp);
+            fputc((block[i] >> 8) & 0xFF, fp);
+        }
+    }
+    fclose(fp);
+    
+    audio_capture_init(SAMPLE_RATE, NULL, NULL);
+    pass = (audio_capture_sim_file(path, false) == AUDIO_CAPTURE_OK && audio_capture_start() == AUDIO_CAPTURE_OK);
+    uint32_t captured = audio_capture_sim_advance(SAMPLE_RATE);
+    audio_capture_get_stats(&stats);
+    pass = pass && (captured == 40 * AUDIO_CAPTURE_BLOCK_SIZE && !audio_capture_is_running() && stats.blocks_delivered == 40);
+    printf("File: %u samples, %u blocks, stopped at EOF | %s\n",
+           captured, stats.blocks_delivered, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    remove(path);
+    
+    audio_capture_init(SAMPLE_RATE, NULL, NULL);
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> Capture Driver Result: %d/3 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 12: MEMORY-MAPPED WAV READER
+   ============================================================ */
+
+static void put_le16(FILE* fp, uint16_t v) { fputc(v & 0xFF, fp); fputc(v >> 8, fp); }
+static void put_le32(FILE* fp, uint32_t v) { put_le16(fp, (uint16_t)(v & 0xFFFF)); put_le16(fp, (uint16_t)(v >> 16)); }
+
+/* Mono WAV of a sine, with an odd-sized LIST chunk before the data */
+static void write_test_wav(const char* path, uint16_t bits, double frequency, uint32_t frames) {
+    uint32_t bytes_per_sample = bits / 8;
+    uint32_t data_size = frames * bytes_per_sample;
+    FILE* fp = fopen(path, "wb");
+    
+    fwrite("RIFF", 1, 4, fp);
+    put_le32(fp, 4 + (8 + 16) + (8 + 5 + 1) + (8 + data_size));
+    fwrite("WAVEfmt ", 1, 8, fp);
+    put_le32(fp, 16);
+    put_le16(fp, 1);                              /* PCM */
+    put_le16(fp, 1);                              /* Mono */
+    put_le32(fp, SAMPLE_RATE);
+    put_le32(fp, SAMPLE_RATE * bytes_per_sample);
+    put_le16(fp, (uint16_t)bytes_per_sample);
+    put_le16(fp, bits);
+    fwrite("LIST", 1, 4, fp);
+    put_le32(fp, 5);
+    fwrite("INFO", 1, 5, fp);                     /* 5 bytes + pad byte */
+    fputc(0, fp);
+    fwrite("data", 1, 4, fp);
+    put_le32(fp, data_size);
+    for (uint32_t i = 0; i < frames; i++) {
+        int32_t v = (int32_t)(12000 * sin(2.0 * M_PI * frequency * i / SAMPLE_RATE));
+        if (bits == 24) v *= 256;
+        for (uint32_t b = 0; b < bytes_per_sample; b++) {
+            fputc((v >> (8 * b)) & 0xFF, fp);
+        }
+    }
+    fclose(fp);
+}
+
+void test_wav_reader(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 12: MEMORY-MAPPED WAV READER\n");
+    printf("================================================\n\n");
+    
+    const char* path = "wav_reader_test.wav";
+    int pass_count = 0;
+    wav_reader_t wav;
+    
+    /* Zero-copy views go straight into apply_fft */
+    write_test_wav(path, 16, 146.83, SAMPLE_RATE);
+    int pass = (wav_reader_open(&wav, path) == WAV_OK && wav.num_frames == SAMPLE_RATE &&
+                wav.format.sample_rate == SAMPLE_RATE);
+    int frames_ok = 0, frames_total = 0;
+    audio_processing_reset_noise_floor();
+    for (uint32_t f = 0; pass && f + 256 <= wav.num_frames; f += 1024) {
+        uint32_t n = 256;
+        const int16_t* frame = wav_reader_view(&wav, f, &n);
+        double detected = apply_fft(frame, (int)n);
+        frames_total++;
+        if (fabs(detected - 146.83) <= 20.0) frames_ok++;
+    }
+    pass = pass && (frames_ok == frames_total);
+    printf("D3 from mapped file: %d/%d frames | %s\n", frames_ok, frames_total, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Batched float conversion matches the scalar formula */
+    float converted[1000];
+    uint32_t n = 1000;
+    const int16_t* view = wav_reader_view(&wav, 3, &n);
+    wav_int16_to_float(view, converted, n);
+    int mismatches = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (converted[i] != view[i] / 32768.0f) mismatches++;
+    }
+    pass = (mismatches == 0);
+    printf("int16 -> float batch conversion: %d mismatches | %s\n", mismatches, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    wav_reader_close(&wav);
+    
+    /* 24-bit is valid WAV but cannot be viewed as int16 */
+    write_test_wav(path, 24, 146.83, 1000);
+    wav_error_t err = wav_reader_open(&wav, path);
+    pass = (err == WAV_UNSUPPORTED);
+    printf("24-bit file rejected for zero-copy: error %d | %s\n", err, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Raw PCM without a header */
+    FILE* fp = fopen(path, "wb");
+    for (int i = 0; i < 64; i++) fputc(i, fp);
+    fclose(fp);
+    err = wav_reader_open(&wav, path);
+    pass = (err == WAV_FORMAT_ERROR);
+    printf("Headerless file rejected: error %d | %s\n", err, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    remove(path);
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> WAV Reader Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 13: STREAMING WAV DECODER
+   ============================================================ */
+
+/* Interleaved WAV of a sine in every channel; odd channels are
+   phase-inverted when invert_odd is set */
+static void write_multichannel_wav(const char* path, uint16_t format, uint16_t channels, uint32_t rate,
+                                   uint16_t bits, double frequency, uint32_t frames, int invert_odd) {
+    uint32_t bytes_per_sample = bits / 8;
+    uint32_t data_size = frames * channels * bytes_per_sample;
+    FILE* fp = fopen(path, "wb");
+    
+    fwrite("RIFF", 1, 4, fp);
+    put_le32(fp, 4 + (8 + 16) + (8 + data_size));
+    fwrite("WAVEfmt ", 1, 8, fp);
+    put_le32(fp, 16);
+    put_le16(fp, format);
+    put_le16(fp, channels);
+    put_le32(fp, rate);
+    put_le32(fp, rate * channels * bytes_per_sample);
+    put_le16(fp, (uint16_t)(channels * bytes_per_sample));
+    put_le16(fp, bits);
+    fwrite("data", 1, 4, fp);
+    put_le32(fp, data_size);
+    for (uint32_t i = 0; i < frames; i++) {
+        double x = 0.4 * sin(2.0 * M_PI * frequency * i / rate);
+        for (uint16_t c = 0; c < channels; c++) {
+            double y = (invert_odd && (c & 1)) ? -x : x;
+            uint64_t v;     /* Wide enough for the unsupported 64-bit case */
+            if (format == WAV_FORMAT_IEEE_FLOAT && bits == 64) {
+                memcpy(&v, &y, sizeof(v));
+            } else if (format == WAV_FORMAT_IEEE_FLOAT) {
+                float f = (float)y;
+                uint32_t word;
+                memcpy(&word, &f, sizeof(word));
+                v = word;
+            } else {
+                v = (uint64_t)(int64_t)ldexp(y, bits - 1);
+            }
+            for (uint32_t b = 0; b < bytes_per_sample; b++) {
+                fputc((v >> (8 * b)) & 0xFF, fp);
+            }
+        }
+    }
+    fclose(fp);
+}
+
+/* Decode at the analyzer rate and run 256-sample frames through apply_fft */
+static int decode_and_detect(const char* path, double expected, uint32_t* file_rate) {
+    wav_decoder_t decoder;
+    int16_t frame[256];
+    int frames_ok = 0, frames_total = 0;
+    FILE* fp = fopen(path, "rb");
+    
+    if (fp == NULL || wav_decoder_open(&decoder, wav_read_stdio, fp) != WAV_OK) {
+        if (fp != NULL) fclose(fp);
+        return 0;
+    }
+    *file_rate = decoder.format.sample_rate;
+    wav_decoder_set_output_rate(&decoder, SAMPLE_RATE);
+    
+    audio_processing_reset_noise_floor();
+    while (wav_decoder_read_int16(&decoder, frame, 256) == 256) {
+        double detected = apply_fft(frame, 256);
+        frames_total++;
+        if (fabs(detected - expected) <= 20.0) frames_ok++;
+    }
+    fclose(fp);
+    return frames_total > 0 && frames_ok == frames_total;
+}
+
+void test_wav_decoder(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 13: STREAMING WAV DECODER\n");
+    printf("================================================\n\n");
+    
+    const char* path = "wav_decoder_test.wav";
+    int pass_count = 0;
+    uint32_t rate = 0;
+    
+    /* 24-bit stereo at 44.1 kHz, downmixed and resampled to 10 kHz */
+    write_multichannel_wav(path, WAV_FORMAT_PCM, 2, 44100, 24, 110.0, 44100, 0);
+    int pass = decode_and_detect(path, 110.0, &rate) && rate == 44100;
+    printf("A2 24-bit stereo 44.1 kHz (rate %u) | %s\n", rate, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* float32 mono at 48 kHz */
+    write_multichannel_wav(path, WAV_FORMAT_IEEE_FLOAT, 1, 48000, 32, 196.0, 48000, 0);
+    pass = decode_and_detect(path, 196.0, &rate) && rate == 48000;
+    printf("G3 float32 mono 48 kHz (rate %u) | %s\n", rate, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Out-of-phase channels cancel in the downmix */
+    write_multichannel_wav(path, WAV_FORMAT_PCM, 2, 10000, 16, 330.0, 2000, 1);
+    FILE* fp = fopen(path, "rb");
+    wav_decoder_t decoder;
+    float samples[512];
+    float peak = 1.0f;
+    if (wav_decoder_open(&decoder, wav_read_stdio, fp) == WAV_OK) {
+        uint32_t n = wav_decoder_read(&decoder, samples, 512);
+        peak = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            if (fabsf(samples[i]) > peak) peak = fabsf(samples[i]);
+        }
+        if (n != 512) peak = 1.0f;
+    }
+    fclose(fp);
+    pass = (peak < 1e-6f);
+    printf("L/R inverted downmix peak: %.2e | %s\n", peak, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* 64-bit float is a valid WAV the decoder does not handle */
+    write_multichannel_wav(path, WAV_FORMAT_IEEE_FLOAT, 1, 10000, 64, 110.0, 16, 0);
+    fp = fopen(path, "rb");
+    wav_error_t err = wav_decoder_open(&decoder, wav_read_stdio, fp);
+    fclose(fp);
+    pass = (err == WAV_UNSUPPORTED);
+    printf("float64 rejected: error %d | %s\n", err, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    remove(path);
+    audio_processing_reset_noise_floor();
+    
+    printf("\n>> WAV Decoder Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 14: RAM PROMPT CACHE
+   ============================================================ */
+
+void test_prompt_cache(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 14: RAM PROMPT CACHE\n");
+    printf("================================================\n\n");
+    
+    const char* prompts[] = { FILE_E, FILE_10_CENTS, FILE_UP, FILE_IN_TUNE };
+    uint32_t prompt_frames[] = { 1200, 900, 700, 1000 };    /* At 10 kHz */
+    char path[64];
+    int pass_count = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        snprintf(path, sizeof(path), "prompt_test_%s", prompts[i]);
+        write_test_wav(path, 16, 440.0, prompt_frames[i]);
+    }
+    
+    /* Decoded and resampled to 44.1 kHz at startup */
+    prompt_cache_init();
+    int loaded = prompt_cache_load_defaults("prompt_test_");
+    const prompt_clip_t* clip_e = prompt_cache_find(FILE_E);
+    uint32_t expected_e = prompt_frames[0] * PROMPT_CACHE_SAMPLE_RATE / SAMPLE_RATE;
+    int pass = (loaded == 4 && clip_e != NULL &&
+                clip_e->num_samples + 8 >= expected_e && clip_e->num_samples <= expected_e);
+    printf("Cached %d prompts, E = %u samples @ 44.1 kHz | %s\n", loaded,
+           clip_e ? clip_e->num_samples : 0, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Speech starts in the first block after the decision */
+    TuningResult result = { 1, 1, 12.0, "UP", 331.0, 329.63, "E", 4 };
+    int16_t block[128];
+    audio_sequencer_init();
+    generate_audio_feedback(&result);
+    uint32_t first = prompt_cache_render(block, 128);
+    pass = (first == 128 && block[10] != 0);
+    printf("First block: %u prompt samples | %s\n", first, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* "E ... Ten Cents ... Up" back to back, nothing from the SD card */
+    uint32_t expected_total = 0;
+    for (int i = 0; i < 3; i++) {
+        expected_total += prompt_cache_find(prompts[i])->num_samples;
+    }
+    uint32_t total = first;
+    for (int b = 0; b < 1000; b++) {
+        audio_sequencer_update();
+        total += prompt_cache_render(block, 128);
+    }
+    pass = (total == expected_total && !prompt_cache_is_playing());
+    printf("Sequence played %u/%u samples | %s\n", total, expected_total, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Uncached prompts fall back to the file path */
+    pass = !prompt_cache_play(FILE_DOWN) && !prompt_cache_is_playing();
+    printf("Uncached prompt not played from RAM | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    for (int i = 0; i < 4; i++) {
+        snprintf(path, sizeof(path), "prompt_test_%s", prompts[i]);
+        remove(path);
+    }
+    prompt_cache_init();
+    
+    printf("\n>> Prompt Cache Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 15: PACKED PROMPT BUNDLE
+   ============================================================ */
+
+void test_prompt_bundle(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 15: PACKED PROMPT BUNDLE\n");
+    printf("================================================\n\n");
+    
+    const char* prompts[] = { FILE_A, FILE_20_CENTS, FILE_DOWN };
+    uint32_t prompt_frames[] = { 1100, 813, 650 };          /* At 10 kHz */
+    const char* bundle_path = "prompt_test_bundle.bin";
+    char path[64];
+    int pass_count = 0;
+    
+    /* Pack: decode the loose WAVs once, then write them as one file */
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "prompt_test_%s", prompts[i]);
+        write_test_wav(path, 16, 330.0, prompt_frames[i]);
+    }
+    prompt_cache_init();
+    prompt_cache_load_defaults("prompt_test_");
+    
+    const char* names[3];
+    const int16_t* samples[3];
+    uint32_t lengths[3];
+    static int16_t reference[3][8192];
+    for (int i = 0; i < 3; i++) {
+        const prompt_clip_t* clip = prompt_cache_find(prompts[i]);
+        names[i] = clip->name;
+        samples[i] = clip->samples;
+        lengths[i] = clip->num_samples;
+        memcpy(reference[i], clip->samples, clip->num_samples * sizeof(int16_t));
+    }
+    FILE* fp = fopen(bundle_path, "wb");
+    prompt_bundle_error_t err = prompt_bundle_write(fp, PROMPT_CACHE_SAMPLE_RATE, 3, names, samples, lengths);
+    fclose(fp);
+    
+    /* Index: one read, every payload on an aligned offset */
+    prompt_bundle_t bundle;
+    fp = fopen(bundle_path, "rb");
+    int pass = (err == PROMPT_BUNDLE_OK &&
+                prompt_bundle_open(&bundle, prompt_bundle_read_stdio, fp) == PROMPT_BUNDLE_OK &&
+                bundle.header.entry_count == 3);
+    for (int i = 0; pass && i < 3; i++) {
+        const prompt_bundle_entry_t* entry = prompt_bundle_find(&bundle, prompts[i]);
+        pass = (entry != NULL && entry->offset % PROMPT_BUNDLE_ALIGN == 0 && entry->num_samples == lengths[i]);
+    }
+    fclose(fp);
+    printf("Index: %u entries, aligned to %d bytes | %s\n", pass ? bundle.header.entry_count : 0,
+           PROMPT_BUNDLE_ALIGN, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Startup from the bundle gives the same samples as the loose files */
+    prompt_cache_init();
+    int loaded = prompt_cache_load_bundle(bundle_path);
+    pass = (loaded == 3);
+    for (int i = 0; pass && i < 3; i++) {
+        const prompt_clip_t* clip = prompt_cache_find(prompts[i]);
+        pass = (clip != NULL && clip->num_samples == lengths[i] &&
+                ((uintptr_t)clip->samples % PROMPT_BUNDLE_ALIGN) == 0 &&
+                memcmp(clip->samples, reference[i], lengths[i] * sizeof(int16_t)) == 0);
+    }
+    printf("Loaded %d prompts from bundle, samples match | %s\n", loaded, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Startup path: the bundle first, then loose WAVs only for what it lacks */
+    write_test_wav("prompt_test_" FILE_UP, 16, 330.0, 700);
+    loaded = prompt_cache_load_startup(bundle_path, "prompt_test_");
+    const prompt_clip_t* bundled = prompt_cache_find(prompts[0]);
+    pass = (loaded == 4 && prompt_cache_find(FILE_UP) != NULL && bundled != NULL &&
+            ((uintptr_t)bundled->samples % PROMPT_BUNDLE_ALIGN) == 0 &&
+            memcmp(bundled->samples, reference[0], lengths[0] * sizeof(int16_t)) == 0);
+    printf("Startup load: %d prompts, bundle first, %s from a loose WAV | %s\n", loaded, FILE_UP,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    remove("prompt_test_" FILE_UP);
+    
+    /* A damaged header is rejected before anything is cached */
+    fp = fopen(bundle_path, "r+b");
+    fputc('X', fp);
+    fclose(fp);
+    prompt_cache_init();
+    loaded = prompt_cache_load_bundle(bundle_path);
+    pass = (loaded == PROMPT_CACHE_FORMAT_ERROR && prompt_cache_count() == 0);
+    printf("Bad magic rejected: error %d | %s\n", loaded, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "prompt_test_%s", prompts[i]);
+        remove(path);
+    }
+    remove(bundle_path);
+    prompt_cache_init();
+    
+    printf("\n>> Prompt Bundle Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 16: GAPLESS PROMPT PLAYLIST
+   ============================================================ */
+
+static int playlist_done_calls = 0;
+
+static void count_playlist_done(void* context) {
+    (*(int*)context)++;
+}
+
+void test_prompt_playlist(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 16: GAPLESS PROMPT PLAYLIST\n");
+    printf("================================================\n\n");
+    
+    const char* prompts[] = { FILE_G, FILE_10_CENTS, FILE_DOWN };
+    uint32_t prompt_frames[] = { 1003, 777, 891 };          /* Not multiples of a block */
+    double prompt_tones[] = { 196.0, 440.0, 330.0 };
+    static int16_t expected[16384];
+    static int16_t heard[16384];
+    char path[64];
+    int pass_count = 0;
+    
+    prompt_cache_init();
+    for (int i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "prompt_test_%s", prompts[i]);
+        write_test_wav(path, 16, prompt_tones[i], prompt_frames[i]);
+        prompt_cache_load_file(prompts[i], "prompt_test_");
+        remove(path);
+    }
+    const prompt_clip_t* clip[3];
+    uint32_t total = 0;
+    for (int i = 0; i < 3; i++) {
+        clip[i] = prompt_cache_find(prompts[i]);
+        memcpy(expected + total, clip[i]->samples, clip[i]->num_samples * sizeof(int16_t));
+        total += clip[i]->num_samples;
+    }
+    
+    /* Butt splice: output is exactly the clips back to back, no silence between */
+    int done = 0;
+    int done_block = -1;
+    uint32_t heard_count = 0;
+    prompt_cache_play_list(prompts, 3, 0, count_playlist_done, &done);
+    for (int b = 0; b < 200 && heard_count + 128 <= 16384; b++) {
+        uint32_t got = prompt_cache_render(heard + heard_count, 128);
+        heard_count += got;
+        if (done && done_block < 0) {
+            done_block = b;
+        }
+        if (got < 128) {
+            break;
+        }
+    }
+    int pass = (heard_count == total && memcmp(heard, expected, total * sizeof(int16_t)) == 0);
+    printf("Butt splice: %u/%u samples, sample-exact | %s\n", heard_count, total, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Completion reported from the block that played the last sample */
+    pass = (done == 1 && done_block == (int)(total / 128) && !prompt_cache_is_playing());
+    printf("Done callback: %d call(s) in block %d | %s\n", done, done_block, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Crossfade: each boundary overlaps by 64 samples and starts on the outgoing clip */
+    const uint32_t fade = 64;
+    heard_count = 0;
+    prompt_cache_play_list(prompts, 3, fade, NULL, NULL);
+    for (int b = 0; b < 200; b++) {
+        uint32_t got = prompt_cache_render(heard + heard_count, 128);
+        heard_count += got;
+        if (got < 128) {
+            break;
+        }
+    }
+    uint32_t boundary = clip[0]->num_samples - fade;
+    pass = (heard_count == total - 2 * fade && heard[boundary] == clip[0]->samples[boundary] &&
+            heard[clip[0]->num_samples] == clip[1]->samples[fade]);
+    printf("Crossfade %u: %u samples | %s\n", fade, heard_count, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Sequencer: whole phrase queued, finishes without audio_sequencer_update() */
+    TuningResult result = { 3, 1, -12.0, "DOWN", 193.0, 196.0, "G", 3 };
+    int16_t block[128];
+    playlist_done_calls = 0;
+    audio_sequencer_init();
+    audio_sequencer_on_complete(count_playlist_done, &playlist_done_calls);
+    generate_audio_feedback(&result);
+    heard_count = 0;
+    for (int b = 0; b < 200 && audio_sequencer_is_playing(); b++) {
+        heard_count += prompt_cache_render(block, 128);
+    }
+    pass = (heard_count == total && playlist_done_calls == 1 && !audio_sequencer_is_playing());
+    printf("Sequencer phrase: %u samples, done %d | %s\n", heard_count, playlist_done_calls,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    audio_sequencer_on_complete(NULL, NULL);
+    prompt_cache_init();
+    
+    printf("\n>> Prompt Playlist Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 17: BEEP TONE SYNTHESIZER
+   ============================================================ */
+
+/* Render until the oscillator goes quiet; returns samples rendered */
+static uint32_t render_tone(int16_t* out, uint32_t capacity) {
+    uint32_t n = 0;
+    memset(out, 0, capacity * sizeof(int16_t));
+    while (n + 128 <= capacity) {
+        tone_synth_render(out + n, 128);
+        n += 128;
+        if (!tone_synth_is_active()) {
+            break;
+        }
+    }
+    return n;
+}
+
+/* Count separate bursts of sound (runs of nonzero samples at least `gap` apart) */
+static int count_bursts(const int16_t* out, uint32_t n, uint32_t gap) {
+    int bursts = 0;
+    uint32_t quiet = gap;
+    for (uint32_t i = 0; i < n; i++) {
+        if (out[i] != 0) {
+            if (quiet >= gap) {
+                bursts++;
+            }
+            quiet = 0;
+        } else {
+            quiet++;
+        }
+    }
+    return bursts;
+}
+
+void test_tone_synth(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 17: BEEP TONE SYNTHESIZER\n");
+    printf("================================================\n\n");
+    
+    static int16_t out[44100];
+    int pass_count = 0;
+    
+    /* Pitch: 100 ms at 1 kHz is 100 cycles */
+    tone_synth_init();
+    tone_synth_beep(1000.0f, 100, 0.5f);
+    uint32_t n = render_tone(out, 44100);
+    int crossings = 0;
+    int32_t peak = 0;
+    for (uint32_t i = 1; i < n; i++) {
+        if (out[i - 1] < 0 && out[i] >= 0) crossings++;
+        if (abs(out[i]) > peak) peak = abs(out[i]);
+    }
+    int pass = (crossings >= 99 && crossings <= 101 && peak > 15000 && peak <= 16384);
+    printf("1 kHz x 100 ms: %d cycles, peak %d | %s\n", crossings, peak, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Envelope: no step at either edge bigger than the ramp allows */
+    uint32_t length = 100 * PROMPT_CACHE_SAMPLE_RATE / 1000;
+    int32_t edge_step = abs(out[0]) > abs(out[length - 1]) ? abs(out[0]) : abs(out[length - 1]);
+    pass = (edge_step < 200 && out[length] == 0);
+    printf("Attack/release ramp: edge sample %d | %s\n", edge_step, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Patterns: warning feedback is three separate beeps */
+    tactile_feedback_warning();
+    n = render_tone(out, 44100);
+    int bursts = count_bursts(out, n, 100);
+    pass = (bursts == 3);
+    printf("Warning pattern: %d beeps | %s\n", bursts, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Mixed on top of a prompt with saturation, not wrap-around */
+    int16_t block[128];
+    int wrapped = 0;
+    int clipped = 0;
+    tone_synth_beep(440.0f, 50, 1.0f);
+    for (int b = 0; b < 4; b++) {
+        for (int i = 0; i < 128; i++) block[i] = 30000;
+        tone_synth_render(block, 128);
+        for (int i = 0; i < 128; i++) {
+            if (block[i] < 30000 - 32768) wrapped++;
+            if (block[i] == 32767) clipped++;
+        }
+    }
+    tone_synth_stop();
+    pass = (wrapped == 0 && clipped > 0);
+    printf("Saturating mix over 30000: %d clipped, %d wrapped | %s\n", clipped, wrapped,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Stop fades out within one ramp instead of cutting */
+    tone_synth_beep(500.0f, 1000, 0.5f);
+    tone_synth_render(block, 128);
+    memset(block, 0, sizeof(block));
+    tone_synth_render(block, 128);
+    tone_synth_stop();
+    memset(out, 0, 1024 * sizeof(int16_t));
+    for (int b = 0; b < 8; b++) {
+        tone_synth_render(out + b * 128, 128);
+    }
+    uint32_t ramp = TONE_SYNTH_RAMP_MS * PROMPT_CACHE_SAMPLE_RATE / 1000;
+    pass = (!tone_synth_is_active() && abs(out[0]) > 1000 && out[ramp] == 0 &&
+            abs(out[ramp - 1]) < 200);
+    printf("Stop releases over %u samples | %s\n", ramp, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Beep pitch encodes the direction */
+    pass = (get_beep_pitch(+30.0) > get_beep_pitch(-30.0));
+    printf("Sharp beeps above flat: %.0f / %.0f Hz | %s\n", get_beep_pitch(+30.0), get_beep_pitch(-30.0),
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Cost per sample */
+    tone_synth_beep(440.0f, TONE_SYNTH_MAX_DURATION_MS, 0.5f);
+    clock_t start = clock();
+    for (int b = 0; b < 600; b++) {
+        tone_synth_render(block, 128);
+    }
+    double ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / (600 * 128);
+    tone_synth_stop();
+    tone_synth_render(block, 128);
+    printf("Render cost: %.1f ns/sample (info)\n", ns);
+    
+    printf("\n>> Tone Synth Result: %d/6 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 18: SAMPLE-CLOCK FEEDBACK SCHEDULER
+   ============================================================ */
+
+/* Render `total` samples in uneven block sizes, like a jittery caller */
+static void render_scheduled(int16_t* out, uint32_t total) {
+    static const uint32_t sizes[] = { 128, 100, 128, 37, 128 };
+    uint32_t n = 0;
+    for (int b = 0; n < total; b++) {
+        uint32_t size = sizes[b % 5];
+        if (size > total - n) size = total - n;
+        feedback_scheduler_render(out + n, size);
+        n += size;
+    }
+}
+
+/* Sample index of each beep onset (first nonzero after at least `gap` zeros) */
+static int find_onsets(const int16_t* out, uint32_t n, uint32_t gap, uint32_t* onsets, int max_onsets) {
+    int count = 0;
+    uint32_t quiet = gap;
+    for (uint32_t i = 0; i < n; i++) {
+        if (out[i] != 0) {
+            if (quiet >= gap && count < max_onsets) onsets[count++] = i;
+            quiet = 0;
+        } else {
+            quiet++;
+        }
+    }
+    return count;
+}
+
+void test_feedback_scheduler(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 18: SAMPLE-CLOCK FEEDBACK SCHEDULER\n");
+    printf("================================================\n\n");
+    
+    static int16_t out[44100];
+    uint32_t onsets[16];
+    tone_pattern_t beep;
+    int pass_count = 0;
+    
+    prompt_cache_init();
+    tone_synth_init();
+    feedback_scheduler_init();
+    tone_synth_pattern(&beep, 1000.0f, 20, 0, 1, 0.5f);
+    
+    /* One-shot lands on its sample, mid-block (the ramp's first sample is 0) */
+    feedback_schedule_beep(feedback_scheduler_now() + 1000, 0, &beep, 7);
+    render_scheduled(out, 4410);
+    int count = find_onsets(out, 4410, 100, onsets, 16);
+    int pass = (count == 1 && onsets[0] == 1001);
+    printf("Beep due at 1000: onset at %u | %s\n", count ? onsets[0] : 0, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Periodic: every 4410 samples exactly, whatever the block sizes */
+    uint32_t start = feedback_scheduler_now();
+    feedback_schedule_beep(start, 4410, &beep, 7);
+    render_scheduled(out, 44100);
+    count = find_onsets(out, 44100, 100, onsets, 16);
+    pass = (count == 10);
+    for (int i = 0; pass && i < count; i++) {
+        pass = (onsets[i] == (uint32_t)i * 4410 + 1);
+    }
+    printf("Periodic 100 ms over 1 s: %d beeps, drift-free | %s\n", count, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Cancel by tag drops the rest of the train */
+    feedback_cancel(7);
+    render_scheduled(out, 22050);
+    count = find_onsets(out, 22050, 100, onsets, 16);
+    pass = (count == 0 && feedback_scheduler_pending() == 0);
+    printf("Cancelled train: %d beeps after cancel | %s\n", count, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Prompt start on its sample */
+    write_test_wav("prompt_test_sched.wav", 16, 440.0, 500);
+    prompt_cache_load_file("sched.wav", "prompt_test_");
+    remove("prompt_test_sched.wav");
+    const prompt_clip_t* clip = prompt_cache_find("sched.wav");
+    feedback_schedule_prompt(feedback_scheduler_now() + 300, "sched.wav", 8);
+    render_scheduled(out, 4410);
+    uint32_t first = 0;
+    while (first < 4410 && out[first] == 0) first++;
+    pass = (clip != NULL && first >= 300 && memcmp(out + 300, clip->samples, 64 * sizeof(int16_t)) == 0);
+    printf("Prompt due at 300: first sample %u | %s\n", first, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Dynamic beeps: 30 cents flat = every 500 ms, no polling from the main loop */
+    TuningResult result = { 5, 1, -30.0, "UP", 108.1, 110.0, "A", 2 };
+    audio_sequencer_init();
+    generate_dynamic_beep_feedback(&result);
+    render_scheduled(out, 44100);
+    count = find_onsets(out, 44100, 100, onsets, 16);
+    pass = (count == 2 && onsets[1] - onsets[0] == 22050);
+    result.cents_offset = 2.0;
+    generate_dynamic_beep_feedback(&result);
+    render_scheduled(out, 44100);
+    pass = pass && find_onsets(out, 44100, 100, onsets, 16) == 0;
+    printf("Sequencer beeps: %d in 1 s, 500 ms apart, silent in tune | %s\n", count,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    prompt_cache_init();
+    feedback_scheduler_init();
+    
+    printf("\n>> Feedback Scheduler Result: %d/5 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 19: VOICE MIXER WITH DUCKING
+   ============================================================ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MIXER_CYCLES() __rdtsc()
+#else
+#define MIXER_CYCLES() ((uint64_t)clock())
+#endif
+
+static void fill_block(int16_t* block, int16_t value) {
+    for (int i = 0; i < 128; i++) block[i] = value;
+}
+
+void test_voice_mixer(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 19: VOICE MIXER WITH DUCKING\n");
+    printf("================================================\n\n");
+    
+    static int16_t speech_block[128], beep_block[128], sd_block[128];
+    voice_buffer_t speech = { speech_block, 128 };
+    voice_buffer_t beep = { beep_block, 128 };
+    voice_buffer_t sd = { sd_block, 128 };
+    int16_t out[128];
+    int pass_count = 0;
+    
+    fill_block(speech_block, 8000);
+    fill_block(beep_block, 8000);
+    fill_block(sd_block, 4000);
+    float saved_volume = volume_get();
+    volume_set(1.0f);
+    
+    /* Prompt and SD playback at once: summed, neither cut off */
+    voice_mixer_init();
+    int v_speech = voice_mixer_add(VOICE_SPEECH, voice_mixer_buffer_source, &speech, 1.0f);
+    int v_sd = voice_mixer_add(VOICE_PASSTHROUGH, voice_mixer_buffer_source, &sd, 1.0f);
+    voice_mixer_render(out, 128);           /* Fade-in block */
+    int heard = voice_mixer_render(out, 128);
+    int pass = (heard == 2 && abs(out[64] - 12000) <= 2);
+    printf("Speech + passthrough: %d voices, sample %d | %s\n", heard, out[64], pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Beeps duck under speech, and return only after the hold */
+    int v_beep = voice_mixer_add(VOICE_BEEP, voice_mixer_buffer_source, &beep, 1.0f);
+    voice_mixer_render(out, 128);
+    voice_mixer_render(out, 128);
+    int ducked = out[64] - 12000;
+    speech.active = 0;
+    fill_block(speech_block, 0);
+    voice_mixer_render(out, 128);
+    int held = out[64] - 4000;
+    for (int b = 0; b < VOICE_MIXER_DUCK_HOLD_BLOCKS + 1; b++) {
+        voice_mixer_render(out, 128);
+    }
+    int restored = out[64] - 4000;
+    pass = (abs(ducked - 2000) <= 2 && abs(held - 2000) <= 2 && abs(restored - 8000) <= 2 &&
+            !voice_mixer_is_ducking());
+    printf("Beep under speech %d, held %d, restored %d | %s\n", ducked, held, restored,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Gain changes ramp across the block instead of stepping */
+    voice_mixer_remove(v_beep);
+    voice_mixer_remove(v_speech);
+    voice_mixer_set_gain(v_sd, 0.0f);
+    voice_mixer_render(out, 128);
+    int max_step = abs(out[0] - 4000);
+    for (int i = 1; i < 128; i++) {
+        if (abs(out[i] - out[i - 1]) > max_step) max_step = abs(out[i] - out[i - 1]);
+    }
+    pass = (max_step <= 4000 / 128 + 2 && out[127] <= 40);
+    printf("Gain 1 -> 0 ramp: largest step %d | %s\n", max_step, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Master volume from volume_get(), ramped too */
+    voice_mixer_set_gain(v_sd, 1.0f);
+    volume_set(0.5f);
+    voice_mixer_render(out, 128);
+    voice_mixer_render(out, 128);
+    pass = (abs(out[64] - 2000) <= 2);
+    printf("Master volume 0.5: sample %d | %s\n", out[64], pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Saturating sum */
+    volume_set(1.0f);
+    fill_block(sd_block, 30000);
+    fill_block(beep_block, 30000);
+    beep.active = 128;
+    voice_mixer_add(VOICE_BEEP, voice_mixer_buffer_source, &beep, 1.0f);
+    voice_mixer_render(out, 128);
+    voice_mixer_render(out, 128);
+    pass = (out[64] == 32767);
+    printf("Two voices at 30000: %d | %s\n", out[64], pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Cost per 128-sample block for 1..8 voices */
+    static int16_t bench_blocks[VOICE_MIXER_MAX_VOICES][128];
+    static voice_buffer_t bench[VOICE_MIXER_MAX_VOICES];
+    printf("\nMixer cost per 128-sample block (info):\n");
+    for (int n = 1; n <= VOICE_MIXER_MAX_VOICES; n++) {
+        voice_mixer_init();
+        for (int v = 0; v < n; v++) {
+            for (int i = 0; i < 128; i++) bench_blocks[v][i] = (int16_t)((i * 97 + v * 31) % 4000 - 2000);
+            bench[v].samples = bench_blocks[v];
+            bench[v].active = 128;
+            voice_mixer_add(v == 0 ? VOICE_SPEECH : VOICE_BEEP, voice_mixer_buffer_source, &bench[v], 0.5f);
+        }
+        const int blocks = 20000;
+        uint64_t start = MIXER_CYCLES();
+        for (int b = 0; b < blocks; b++) {
+            voice_mixer_set_gain(0, (b & 1) ? 0.5f : 0.6f);     /* Keep one ramp running */
+            voice_mixer_render(out, 128);
+        }
+        uint64_t cycles = (MIXER_CYCLES() - start) / blocks;
+        printf("  %d voice%s: %6llu %s/block\n", n, n == 1 ? " " : "s", (unsigned long long)cycles,
+#if defined(__x86_64__) || defined(__i386__)
+               "cycles"
+#else
+               "clock ticks"
+#endif
+               );
+    }
+    
+    voice_mixer_init();
+    volume_set(saved_volume);
+    
+    printf("\n>> Voice Mixer Result: %d/5 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 20: INDEPENDENT TUNER SESSIONS
+   ============================================================ */
+
+static void pluck_block(int16_t* block, double freq, uint32_t block_index) {
+    for (int i = 0; i < 128; i++) {
+        double t = (double)(block_index * 128 + i) / SAMPLE_RATE;
+        double v = sin(2.0 * M_PI * freq * t) + 0.5 * sin(4.0 * M_PI * freq * t);
+        block[i] = (int16_t)(8000.0 * v * exp(-1.0 * t));
+    }
+}
+
+void test_tuner_sessions(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 20: INDEPENDENT TUNER SESSIONS\n");
+    printf("================================================\n\n");
+    
+    static tuner_session_t alone, low, high;
+    int16_t block[128];
+    int pass_count = 0;
+    
+    /* A session interleaved with another gives bit-identical results to one run alone */
+    tuner_session_init(&alone, NULL, 0);
+    tuner_session_init(&low, NULL, 0);
+    tuner_session_init(&high, NULL, 0);
+    int identical = 1;
+    int low_events = 0, high_feedback = 0;
+    for (uint32_t b = 0; b < 60; b++) {
+        pluck_block(block, 329.63, b);
+        int a = tuner_session_process_block(&alone, block, 128);
+        pluck_block(block, 110.0, b);
+        low_events |= tuner_session_process_block(&low, block, 128);
+        pluck_block(block, 329.63, b);
+        int h = tuner_session_process_block(&high, block, 128);
+        if (h & TUNER_SESSION_FEEDBACK) high_feedback++;
+        if (a != h || alone.result.detected_frequency != high.result.detected_frequency ||
+            alone.analyzer.last_confidence != high.analyzer.last_confidence) {
+            identical = 0;
+        }
+    }
+    printf("Interleaved session matches a session run alone (60 blocks) | %s\n",
+           identical ? "[OK] PASS" : "[X] FAIL");
+    if (identical) pass_count++;
+    
+    /* Each session tracks its own string */
+    int pass = (low.result.detected_string == 5 && high.result.detected_string == 1 &&
+                (low_events & TUNER_SESSION_DETECTED));
+    printf("Concurrent A2 and E4 sessions: strings %d and %d | %s\n", low.result.detected_string,
+           high.result.detected_string, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Tracker: a steady note announces once, with the sequencer's phrase */
+    pass = (high_feedback == 1 && high.feedback_changes == 1 && high.phrase_length > 0 &&
+            strcmp(high.phrase[0], FILE_E) == 0 && high.detections >= TUNER_SESSION_STABLE_FRAMES);
+    printf("Steady E4: %d feedback change(s), phrase starts %s | %s\n", high_feedback,
+           high.phrase_length ? high.phrase[0] : "-", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Per-session profiles do not touch the active one */
+    const tuning_table_t* drop_d = tuning_table_builtin(TUNING_PROFILE_GUITAR_DROP_D);
+    const tuning_table_t* active = string_detection_get_tuning();
+    TuningResult r = analyze_tuning_table(drop_d, 73.42, 0);
+    pass = (r.detected_string == 6 && fabs(r.target_frequency - 73.42) < 0.01 &&
+            string_detection_get_tuning() == active);
+    printf("Drop-D session profile: string %d -> %.2f Hz, active profile unchanged | %s\n",
+           r.detected_string, r.target_frequency, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Tuner Session Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 21: HEXAPHONIC SIX-CHANNEL ANALYSIS
+   ============================================================ */
+
+/* Each channel its own string, with 20% bleed from the neighbouring string */
+static void hex_test_signal(int16_t channels[HEX_CHANNELS][HEX_FFT_SIZE], const double* freqs,
+                            const int* connected) {
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        int neighbour = (c + 1 < HEX_CHANNELS) ? c + 1 : c - 1;
+        for (int n = 0; n < HEX_FFT_SIZE; n++) {
+            double t = (double)n / SAMPLE_RATE;
+            double v = sin(2.0 * M_PI * freqs[c] * t) + 0.4 * sin(4.0 * M_PI * freqs[c] * t)
+                     + 0.2 * sin(2.0 * M_PI * freqs[neighbour] * t);
+            channels[c][n] = connected[c] ? (int16_t)(9000.0 * v) : 0;
+        }
+    }
+}
+
+void test_hex_analyzer(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 21: HEXAPHONIC SIX-CHANNEL ANALYSIS\n");
+    printf("================================================\n\n");
+    
+    static hex_analyzer_t hex;
+    static int16_t channels[HEX_CHANNELS][HEX_FFT_SIZE];
+    static int16_t interleaved[HEX_FFT_SIZE * HEX_CHANNELS];
+    const int16_t* planar[HEX_CHANNELS];
+    const double freqs[HEX_CHANNELS] = { 329.63, 246.94, 196.00, 146.83, 110.00, 82.41 };
+    const int all[HEX_CHANNELS] = { 1, 1, 1, 1, 1, 1 };
+    hex_result_t result, again;
+    int pass_count = 0;
+    
+    hex_analyzer_init(&hex, NULL);
+    for (int c = 0; c < HEX_CHANNELS; c++) planar[c] = channels[c];
+    
+    /* All six strings in one frame, each keyed to its own string */
+    hex_test_signal(channels, freqs, all);
+    int valid = hex_analyzer_process(&hex, planar, HEX_FFT_SIZE, &result);
+    int pass = (valid == HEX_CHANNELS);
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        const TuningResult* r = &result.strings[c];
+        double error = 1200.0 * log2(r->detected_frequency / freqs[c]);
+        int ok = result.valid[c] && r->target_string == c + 1 && fabs(error) < 3.0;
+        printf("  Channel %d: %6.2f Hz played -> %6.2f Hz, string %d %s %+5.1f cents (error %+5.2f) %s\n", c + 1,
+               freqs[c], r->detected_frequency, r->target_string, r->note_name, r->cents_offset, error,
+               ok ? "OK" : "WRONG");
+        pass = pass && ok;
+    }
+    printf("Six open strings at once with 20%% bleed, within 3 cents | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Out of tune both ways, each string still read to a few cents */
+    const double detune[HEX_CHANNELS] = { +12.0, -8.0, +25.0, -17.0, +6.0, -30.0 };
+    double detuned[HEX_CHANNELS];
+    double worst = 0.0;
+    for (int c = 0; c < HEX_CHANNELS; c++) detuned[c] = freqs[c] * pow(2.0, detune[c] / 1200.0);
+    hex_test_signal(channels, detuned, all);
+    valid = hex_analyzer_process(&hex, planar, HEX_FFT_SIZE, &result);
+    pass = (valid == HEX_CHANNELS);
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        double error = result.strings[c].cents_offset - detune[c];
+        if (fabs(error) > fabs(worst)) worst = error;
+    }
+    pass = pass && fabs(worst) < 3.0;
+    printf("Detuned -30..+25 cents: worst reading %+5.2f cents off | %s\n", worst, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Interleaved codec frames give the same answer as separate buffers */
+    for (int n = 0; n < HEX_FFT_SIZE; n++) {
+        for (int c = 0; c < HEX_CHANNELS; c++) interleaved[n * HEX_CHANNELS + c] = channels[c][n];
+    }
+    hex_analyzer_process_interleaved(&hex, interleaved, HEX_FFT_SIZE, &again);
+    pass = 1;
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        pass = pass && again.valid[c] == result.valid[c] && again.magnitude[c] == result.magnitude[c] &&
+               again.strings[c].detected_frequency == result.strings[c].detected_frequency;
+    }
+    printf("Interleaved input matches planar input | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Strings not played (or not connected) report nothing */
+    const int some[HEX_CHANNELS] = { 1, 0, 1, 0, 1, 0 };
+    hex_test_signal(channels, freqs, some);
+    planar[3] = NULL;
+    valid = hex_analyzer_process(&hex, planar, HEX_FFT_SIZE, &result);
+    pass = (valid == 3);
+    for (int c = 0; c < HEX_CHANNELS; c++) {
+        pass = pass && result.valid[c] == some[c];
+    }
+    planar[3] = channels[3];
+    printf("Three strings played, one channel unconnected: %d valid | %s\n", valid,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Cost: one six-string frame against one mono apply_fft() frame.
+       Reported only: wall-clock ratios swing with the build and the host */
+    hex_test_signal(channels, freqs, all);
+    const int iterations = 300;
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        hex_analyzer_process(&hex, planar, HEX_FFT_SIZE, &result);
+    }
+    double hex_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    start = clock();
+    for (int i = 0; i < iterations; i++) {
+        apply_fft(channels[i % HEX_CHANNELS], HEX_FFT_SIZE);
+    }
+    double mono_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    double ratio = (mono_time > 0.0) ? hex_time / mono_time : 0.0;
+    printf("Six-string frame costs %.2fx one mono frame (%.1f vs %.1f us)\n", ratio,
+           hex_time / iterations * 1e6, mono_time / iterations * 1e6);
+    
+    printf("\n>> Hex Analyzer Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 22: POLYPHONIC STRUM MODE
+   ============================================================ */
+
+/* Strum of the given strings (cents offsets from standard tuning, NAN = not played) */
+static void strum_test_signal(int16_t* samples, int count, const double* cents) {
+    const double open[6] = { 329.63, 246.94, 196.00, 146.83, 110.00, 82.41 };
+    const double partial_level[4] = { 1.0, 0.5, 0.3, 0.2 };
+    for (int n = 0; n < count; n++) samples[n] = 0;
+    for (int s = 0; s < 6; s++) {
+        if (isnan(cents[s])) continue;
+        double f = open[s] * pow(2.0, cents[s] / 1200.0);
+        for (int k = 1; k <= 4; k++) {
+            double phase = 0.7 * s + 1.3 * k;
+            for (int n = 0; n < count; n++) {
+                double t = (double)n / SAMPLE_RATE;
+                samples[n] += (int16_t)(2500.0 * partial_level[k - 1] * exp(-2.0 * t) *
+                                        sin(2.0 * M_PI * k * f * t + phase));
+            }
+        }
+    }
+}
+
+void test_strum_analyzer(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 22: POLYPHONIC STRUM MODE\n");
+    printf("================================================\n\n");
+    
+    static strum_analyzer_t strum;
+    static int16_t samples[STRUM_FFT_SIZE];
+    strum_result_t result;
+    int pass_count = 0;
+    
+    strum_analyzer_init(&strum, NULL);
+    
+    /* Full strum, every string a little off */
+    const double full[6] = { 12.0, -8.0, 0.0, 20.0, -15.0, 5.0 };
+    strum_test_signal(samples, STRUM_FFT_SIZE, full);
+    int found = strum_analyze(&strum, samples, STRUM_FFT_SIZE, &result);
+    int pass = (found == 6);
+    for (int s = 0; s < 6; s++) {
+        const TuningResult* r = &result.strings[s];
+        int ok = result.found[s] && fabs(r->cents_offset - full[s]) < 3.0;
+        printf("  String %d: %+5.1f cents played -> %7.2f Hz %+6.1f cents %-7s (%d partials) %s\n", s + 1,
+               full[s], r->detected_frequency, r->cents_offset, r->direction, result.partials[s],
+               ok ? "OK" : "WRONG");
+        pass = pass && ok;
+    }
+    printf("One strum, six strings within 3 cents | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* A, D and G only: A2 x 3 lands on E4 but must not be reported as it */
+    const double middle[6] = { NAN, NAN, 0.0, 0.0, 0.0, NAN };
+    strum_test_signal(samples, STRUM_FFT_SIZE, middle);
+    found = strum_analyze(&strum, samples, STRUM_FFT_SIZE, &result);
+    pass = (found == 3 && !result.found[0] && !result.found[1] && result.found[2] && result.found[3] &&
+            result.found[4] && !result.found[5]);
+    printf("Strum of A, D, G: %d strings, no phantom B or E from partials | %s\n", found,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* A string far off still goes to its own string, with its real offset */
+    const double flat_d[6] = { 0.0, 0.0, 0.0, -120.0, 0.0, 0.0 };
+    strum_test_signal(samples, STRUM_FFT_SIZE, flat_d);
+    strum_analyze(&strum, samples, STRUM_FFT_SIZE, &result);
+    pass = result.found[3] && fabs(result.strings[3].cents_offset + 120.0) < 3.0 &&
+           strcmp(result.strings[3].direction, "UP") == 0;
+    printf("D string 120 cents flat: %+.1f cents, tune %s | %s\n", result.strings[3].cents_offset,
+           result.strings[3].direction, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Silence finds nothing */
+    memset(samples, 0, sizeof(samples));
+    found = strum_analyze(&strum, samples, STRUM_FFT_SIZE, &result);
+    pass = (found == 0);
+    printf("Silence: %d strings | %s\n", found, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Strum Analyzer Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 23: TOP-K SPECTRAL PEAKS
+   ============================================================ */
+
+#define PEAK_TEST_N     1024
+#define PEAK_TEST_BINS  160
+
+/* Hann-windowed DFT of a few sinusoids, bins 0..PEAK_TEST_BINS-1 */
+static void peak_test_spectrum(const double* bins, const double* amps, const double* phases, int tones,
+                               float* re, float* im, float* mag) {
+    static float x[PEAK_TEST_N];
+    for (int n = 0; n < PEAK_TEST_N; n++) {
+        double v = 0.0;
+        for (int t = 0; t < tones; t++) {
+            v += amps[t] * cos(2.0 * M_PI * bins[t] * n / PEAK_TEST_N + phases[t]);
+        }
+        x[n] = (float)(v * 0.5 * (1.0 - cos(2.0 * M_PI * n / PEAK_TEST_N)));
+    }
+    for (int k = 0; k < PEAK_TEST_BINS; k++) {
+        double r = 0.0, i = 0.0;
+        for (int n = 0; n < PEAK_TEST_N; n++) {
+            r += x[n] * cos(2.0 * M_PI * k * n / PEAK_TEST_N);
+            i -= x[n] * sin(2.0 * M_PI * k * n / PEAK_TEST_N);
+        }
+        re[k] = (float)r;
+        im[k] = (float)i;
+        mag[k] = (float)sqrt(r * r + i * i);
+    }
+}
+
+void test_spectral_peaks(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 23: TOP-K SPECTRAL PEAKS\n");
+    printf("================================================\n\n");
+    
+    static float re[PEAK_TEST_BINS], im[PEAK_TEST_BINS], mag[PEAK_TEST_BINS];
+    spectral_peak_t peaks[8];
+    const double bins[4] = { 20.3, 45.0, 71.72, 120.5 };
+    const double amps[4] = { 0.5, 1.0, 0.25, 0.004 };
+    const double phases[4] = { 0.3, 1.1, -2.0, 0.0 };
+    spectral_peak_search_t search = { 1, PEAK_TEST_BINS - 2, 1.0f, 0.01f, 0.0f };
+    int pass_count = 0;
+    
+    peak_test_spectrum(bins, amps, phases, 4, re, im, mag);
+    
+    /* Strongest first, sub-bin frequency */
+    uint32_t count = spectral_peaks_top_k(mag, re, im, PEAK_TEST_BINS, &search, peaks, 8);
+    const int order[4] = { 1, 0, 2, 3 };
+    int pass = (count == 4);
+    for (uint32_t i = 0; pass && i < count; i++) {
+        double error = fabs(peaks[i].frequency - bins[order[i]]);
+        printf("  Peak %u: bin %7.3f (true %7.3f) magnitude %8.3f\n", i + 1, peaks[i].frequency,
+               bins[order[i]], peaks[i].magnitude);
+        pass = error < 0.05;
+    }
+    printf("Four tones, strongest first, within 0.05 bin | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* K smaller than the number of peaks keeps the strongest K */
+    count = spectral_peaks_top_k(mag, re, im, PEAK_TEST_BINS, &search, peaks, 2);
+    pass = (count == 2 && peaks[0].bin == 45 && (peaks[1].bin == 20 || peaks[1].bin == 21));
+    printf("K = 2: bins %u and %u | %s\n", peaks[0].bin, count > 1 ? peaks[1].bin : 0,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Relative threshold drops the -48 dB tone without a second pass */
+    search.relative = 0.03f;
+    count = spectral_peaks_top_k(mag, re, im, PEAK_TEST_BINS, &search, peaks, 8);
+    pass = (count == 3);
+    printf("Relative threshold 3%%: %u peaks | %s\n", count, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Phase at an on-bin tone */
+    pass = (fabs(peaks[0].phase - phases[1]) < 0.02);
+    printf("Phase of the 45-bin tone: %.3f rad (true %.3f) | %s\n", peaks[0].phase, phases[1],
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Spectral Peaks Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 24: PHASE-TRACKING FINE TUNE
+   ============================================================ */
+
+/* Phase-continuous note with a second harmonic and a DC offset */
+static void fine_tune_block(int16_t* block, double* phase, double freq, double second, uint32_t block_index) {
+    for (int i = 0; i < 128; i++) {
+        double t = (double)(block_index * 128 + i) / SAMPLE_RATE;
+        double v = sin(*phase) + second * sin(2.0 * *phase);
+        block[i] = (int16_t)(6000.0 * v * exp(-0.5 * t) + 300.0);
+        *phase += 2.0 * M_PI * freq / SAMPLE_RATE;
+    }
+}
+
+void test_fine_tune(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 24: PHASE-TRACKING FINE TUNE\n");
+    printf("================================================\n\n");
+    
+    static tuner_session_t session;
+    static phase_tracker_t tracker;
+    int16_t block[128];
+    float samples[128];
+    int pass_count = 0;
+    
+    /* Session hands over to the tracker and reads a +3.3 cent A2 */
+    const double a2 = 110.0 * pow(2.0, 3.3 / 1200.0);
+    double phase = 0.0;
+    int events = 0, first_fine = -1;
+    tuner_session_init(&session, NULL, 0);
+    tuner_session_set_fine_tune(&session, 1);
+    for (uint32_t b = 0; b < 60; b++) {
+        fine_tune_block(block, &phase, a2, 0.5, b);
+        events = tuner_session_process_block(&session, block, 128);
+        if ((events & TUNER_SESSION_FINE) && first_fine < 0) first_fine = (int)b;
+    }
+    int pass = ((events & TUNER_SESSION_FINE) && session.result.detected_string == 5 &&
+                fabs(session.result.cents_offset - 3.3) < 0.1);
+    printf("A2 +3.30 cents: %+.3f cents, fine from block %d, %u tracker blocks | %s\n",
+           session.result.cents_offset, first_fine, session.fine_blocks, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Sub-cent resolution on low E with a second harmonic twice the fundamental */
+    double readings[2];
+    for (int k = 0; k < 2; k++) {
+        double freq = 82.41 * pow(2.0, (k ? 0.7 : 0.2) / 1200.0);
+        phase = 0.0;
+        phase_tracker_init(&tracker, (float)SAMPLE_RATE);
+        phase_tracker_lock(&tracker, 82.41);
+        for (uint32_t b = 0; b < 30; b++) {
+            fine_tune_block(block, &phase, freq, 2.0, b);
+            for (int i = 0; i < 128; i++) samples[i] = block[i] / 32768.0f;
+            phase_tracker_process(&tracker, samples, 128);
+        }
+        readings[k] = tracker.cents;
+    }
+    pass = (tracker.state == PHASE_TRACKER_LOCKED && fabs(readings[0] - 0.2) < 0.02 &&
+            fabs(readings[1] - readings[0] - 0.5) < 0.02);
+    printf("E2 +0.20 / +0.70 cents: %+.3f / %+.3f | %s\n", readings[0], readings[1],
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Follows a peg turn: 0.5 cent per block upwards */
+    double glide = 0.0, worst = 0.0;
+    phase = 0.0;
+    phase_tracker_init(&tracker, (float)SAMPLE_RATE);
+    phase_tracker_lock(&tracker, 196.0);
+    for (uint32_t b = 0; b < 60; b++) {
+        glide = -10.0 + 0.5 * b;
+        fine_tune_block(block, &phase, 196.0 * pow(2.0, glide / 1200.0), 0.3, b);
+        for (int i = 0; i < 128; i++) samples[i] = block[i] / 32768.0f;
+        if (phase_tracker_process(&tracker, samples, 128) == PHASE_TRACKER_LOCKED && b >= 20) {
+            /* Reading lags by half the phase history plus the filter delay (one span),
+               from the end of a block whose pitch stands for its middle */
+            double lag_blocks = PHASE_TRACKER_HISTORY / 2.0 + tracker.span / 128.0 - 0.5;
+            double expected = glide - 0.5 * lag_blocks;
+            if (fabs(tracker.cents - expected) > worst) worst = fabs(tracker.cents - expected);
+        }
+    }
+    pass = (tracker.state == PHASE_TRACKER_LOCKED && worst < 0.1);
+    printf("G3 glide -10 -> +19.5 cents: worst lag-corrected error %.3f cents | %s\n", worst,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* A different note loses lock and the session falls back to frames */
+    int fell_back = 0;
+    for (uint32_t b = 60; b < 100; b++) {
+        fine_tune_block(block, &phase, 146.83, 0.5, b);
+        events = tuner_session_process_block(&session, block, 128);
+        if (session.fine_losses == 1 && (events & TUNER_SESSION_DETECTED) && !(events & TUNER_SESSION_FINE)) {
+            fell_back = 1;
+        }
+    }
+    pass = (session.fine_losses == 1 && fell_back && session.result.detected_string == 4);
+    printf("Jump to D3: %u lost lock(s), back on frames, string %d | %s\n", session.fine_losses,
+           session.result.detected_string, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Fine Tune Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 25: CONSTANT-Q CHROMATIC ANALYSIS
+   ============================================================ */
+
+static void cqt_test_note(int16_t* samples, double freq, double second, double third) {
+    for (int n = 0; n < CQT_FFT_SIZE; n++) {
+        double t = (double)n / SAMPLE_RATE;
+        double v = sin(2.0 * M_PI * freq * t) + second * sin(4.0 * M_PI * freq * t)
+                 + third * sin(6.0 * M_PI * freq * t);
+        samples[n] = (int16_t)(7000.0 * v);
+    }
+}
+
+void test_cqt_analyzer(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 25: CONSTANT-Q CHROMATIC ANALYSIS\n");
+    printf("================================================\n\n");
+    
+    static cqt_analyzer_t cqt;
+    static int16_t samples[CQT_FFT_SIZE];
+    cqt_result_t result;
+    int pass_count = 0;
+    
+    cqt_analyzer_init(&cqt, NULL);
+    printf("Sparse kernel: %u coefficients for %d bins (dense: %d)\n", cqt.kernel_size, CQT_BINS,
+           CQT_BINS * (CQT_FFT_SIZE / 2 + 1));
+    
+    /* Every fretboard position lands on its own note index */
+    int correct = 0;
+    double worst_cents = 0.0;
+    for (int i = 0; i < NUM_FULL_FRETBOARD; i++) {
+        double freq = full_fretboard[i].frequency;
+        int expected = (int)lround(12.0 * log2(freq / 82.41));
+        cqt_test_note(samples, freq, 0.6, 0.3);
+        if (cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result) && result.note_index == expected) {
+            correct++;
+        }
+        double cents = fabs(1200.0 * log2(result.frequency / freq));
+        if (cents > worst_cents) worst_cents = cents;
+    }
+    int pass = (correct == NUM_FULL_FRETBOARD && worst_cents < 5.0);
+    printf("Fretboard: %d/%d note indices, worst %.2f cents | %s\n", correct, NUM_FULL_FRETBOARD, worst_cents,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* E2 and F2 share one 39 Hz FFT bin but get their own constant-Q bins */
+    int e2 = -1, f2 = -1;
+    cqt_test_note(samples, 82.41, 0.0, 0.0);
+    if (cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result)) e2 = result.note_index;
+    cqt_test_note(samples, 87.31, 0.0, 0.0);
+    if (cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result)) f2 = result.note_index;
+    pass = (e2 == 0 && f2 == 1);
+    printf("E2 / F2 (4.9 Hz apart): note indices %d / %d | %s\n", e2, f2, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Second and third harmonics stronger than the fundamental */
+    cqt_test_note(samples, 82.41, 2.0, 1.5);
+    int found = cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result);
+    pass = (found && result.note_index == 0 && result.tuning.detected_string == 6);
+    printf("Low E, weak fundamental: note index %d, string %d | %s\n", result.note_index,
+           result.tuning.detected_string, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Note index goes straight to the note table, up to the 12th fret of string 1 */
+    cqt_test_note(samples, 659.25, 0.3, 0.0);
+    found = cqt_analyze(&cqt, samples, CQT_FFT_SIZE, &result);
+    pass = (found && result.note_index == NOTE_INDEX_COUNT - 1 && strcmp(result.tuning.note_name, "E") == 0 &&
+            result.tuning.octave == 5 && result.tuning.detected_string == 1);
+    printf("E5: note index %d -> %s%d, string %d | %s\n", result.note_index, result.tuning.note_name,
+           result.tuning.octave, result.tuning.detected_string, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Constant-Q Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 26: PROGRESSIVE ESTIMATE FROM THE ONSET
+   ============================================================ */
+
+/* Plucked note from block 0 on, blocks of 128 */
+static void progressive_block(int16_t* block, double freq, double second, uint32_t block_index) {
+    for (int i = 0; i < 128; i++) {
+        double t = (double)(block_index * 128 + i) / SAMPLE_RATE;
+        double w = 2.0 * M_PI * freq * t;
+        block[i] = (int16_t)(8000.0 * (sin(w) + second * sin(2.0 * w) + 0.2 * sin(3.0 * w)) * exp(-1.5 * t));
+    }
+}
+
+void test_progressive_estimator(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 26: PROGRESSIVE ESTIMATE FROM THE ONSET\n");
+    printf("================================================\n\n");
+    
+    static progressive_estimator_t estimator;
+    static tuner_session_t session;
+    int16_t block[128];
+    int pass_count = 0;
+    
+    /* Coarse note after two blocks, cents-grade once the window is full */
+    const double a2 = 110.0 * pow(2.0, 7.0 / 1200.0);
+    int coarse_block = -1, fine_block = -1, monotonic = 1;
+    progressive_level_t previous = PROGRESSIVE_NONE;
+    progressive_init(&estimator, NULL);
+    progressive_reset(&estimator);
+    for (uint32_t b = 0; b < 12 && fine_block < 0; b++) {
+        progressive_block(block, a2, 0.5, b);
+        progressive_level_t level = progressive_process_block(&estimator, block, 128);
+        if (level < previous) monotonic = 0;
+        if (level == PROGRESSIVE_COARSE && coarse_block < 0 && estimator.result.detected_string == 5) {
+            coarse_block = (int)b;
+        }
+        if (level == PROGRESSIVE_FINE) fine_block = (int)b;
+        previous = level;
+    }
+    double cents = estimator.result.cents_offset;
+    int pass = (coarse_block == 1 && fine_block >= 0 && fine_block <= 9 && monotonic && fabs(cents - 7.0) < 0.5);
+    printf("A2 +7 cents: string after block %d, FINE after block %d at %+.2f cents | %s\n", coarse_block + 1,
+           fine_block + 1, cents, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* A second harmonic twice the fundamental does not name the string an octave up */
+    progressive_reset(&estimator);
+    progressive_level_t level = PROGRESSIVE_NONE;
+    for (uint32_t b = 0; b < 2; b++) {
+        progressive_block(block, 82.41, 2.0, b);
+        level = progressive_process_block(&estimator, block, 128);
+    }
+    pass = (level == PROGRESSIVE_COARSE && estimator.result.detected_string == 6 &&
+            strcmp(estimator.result.note_name, "E") == 0 && estimator.result.octave == 2);
+    printf("E2, strong 2nd harmonic: coarse %s%d, string %d | %s\n", estimator.result.note_name,
+           estimator.result.octave, estimator.result.detected_string, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Phrase parts: string alone, offset alone, both = the full phrase */
+    TuningResult r = analyze_tuning_table(tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD),
+                                          110.0 * pow(2.0, 18.0 / 1200.0), 0);
+    const char* full[SEQUENCER_MAX_PHRASE_CLIPS];
+    const char* parts[SEQUENCER_MAX_PHRASE_CLIPS];
+    int full_length = audio_sequencer_build_phrase(&r, full);
+    int string_length = audio_sequencer_build_phrase_parts(&r, SEQUENCER_PART_STRING, parts);
+    pass = (string_length == 1 && strcmp(parts[0], FILE_A) == 0);
+    int offset_length = audio_sequencer_build_phrase_parts(&r, SEQUENCER_PART_OFFSET, parts);
+    pass = pass && (offset_length == full_length - 1);
+    for (int i = 0; pass && i < offset_length; i++) {
+        pass = (strcmp(parts[i], full[i + 1]) == 0);
+    }
+    printf("Phrase parts: string %d clip, offset %d clips, full %d clips | %s\n", string_length, offset_length,
+           full_length, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Session: string name two blocks after the pluck, cents when FINE */
+    tuner_session_init(&session, NULL, 0);
+    tuner_session_set_progressive(&session, 1);
+    int first_feedback = -1, first_length = 0, fine_feedback = -1, fine_length = 0;
+    uint32_t first_interval = 1;
+    memset(block, 0, sizeof(block));
+    for (uint32_t b = 0; b < 3; b++) {
+        tuner_session_process_block(&session, block, 128);
+    }
+    for (uint32_t b = 0; b < 16; b++) {
+        progressive_block(block, 110.0 * pow(2.0, 18.0 / 1200.0), 0.5, b);
+        int events = tuner_session_process_block(&session, block, 128);
+        if ((events & TUNER_SESSION_FEEDBACK) && first_feedback < 0) {
+            first_feedback = (int)b;
+            first_length = session.phrase_length;
+            first_interval = session.beep_interval_ms;
+        }
+        if ((events & TUNER_SESSION_FEEDBACK) && (events & TUNER_SESSION_EARLY) &&
+            session.early_level == PROGRESSIVE_FINE) {
+            fine_feedback = (int)b;
+            fine_length = session.phrase_length;
+        }
+    }
+    pass = (first_feedback == 1 && first_length == 1 && first_interval == 0 && fine_feedback > first_feedback &&
+            fine_length == full_length && session.beep_interval_ms > 0);
+    printf("Session: string clip after block %d, %d-clip phrase with cents after block %d | %s\n",
+           first_feedback + 1, fine_length, fine_feedback + 1, pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    printf("\n>> Progressive Estimate Result: %d/4 PASSED\n\n", pass_count);
+}
+
+/* ============================================================
+   TEST 27: FINE REFINEMENT (GOERTZEL GOLDEN SECTION)
+   ============================================================ */
+
+void test_fine_refinement(void) {
+    printf("\n");
+    printf("================================================\n");
+    printf("TEST 27: FINE REFINEMENT (GOERTZEL GOLDEN SECTION)\n");
+    printf("================================================\n\n");
+    
+    float frame[256];
+    int16_t samples[SAMPLE_SIZE];
+    int pass_count = 0;
+    
+    /* A Goertzel probe between bins equals the direct DFT sum there */
+    const double probe = 3.37 / 256.0;
+    double re = 0.0, im = 0.0;
+    for (int n = 0; n < 256; n++) {
+        frame[n] = (float)(0.5 * (1.0 - cos(2.0 * M_PI * n / 255.0)) * sin(2.0 * M_PI * 110.0 * n / SAMPLE_RATE + 0.4));
+        re += frame[n] * cos(2.0 * M_PI * probe * n);
+        im -= frame[n] * sin(2.0 * M_PI * probe * n);
+    }
+    double direct = re * re + im * im;
+    double goertzel = goertzel_power(frame, 256, probe);
+    int pass = (fabs(goertzel - direct) < 1e-3 * direct);
+    printf("Goertzel at bin 3.37: %.4f vs direct DFT %.4f | %s\n", goertzel, direct,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Sixteen probes over 1.2 bins find a windowed sine's frequency */
+    const double a2_sharp = 110.0 * pow(2.0, 7.0 / 1200.0);
+    for (int n = 0; n < 256; n++) {
+        frame[n] = (float)(0.5 * (1.0 - cos(2.0 * M_PI * n / 255.0)) * sin(2.0 * M_PI * a2_sharp * n / SAMPLE_RATE));
+    }
+    const double bin_hz = (double)SAMPLE_RATE / 256.0;
+    double found = golden_section_peak(frame, 256, SAMPLE_RATE, 3.0 * bin_hz - 0.6 * bin_hz,
+                                       3.0 * bin_hz + 0.6 * bin_hz, 16);
+    double cents = 1200.0 * log2(found / a2_sharp);
+    pass = (fabs(cents) < 1.5);
+    printf("A2 +7 cents from bin 3 (117.19 Hz): %.3f Hz, error %+.2f cents | %s\n", found, cents,
+           pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* Whole fretboard through apply_fft(), with harmonics and arbitrary phase.
+       The 256-sample search alone leaves the low register, whose lobe
+       overlaps its second harmonic, tens of cents out; the opt-in second
+       search on all 1024 samples makes it as tight as the rest. */
+    for (int long_pass = 0; long_pass < 2; long_pass++) {
+        double worst_low = 0.0, worst_high = 0.0;
+        int detected = 0;
+        audio_processing_set_long_refinement(long_pass);
+        for (int t = 0; t < NUM_FULL_FRETBOARD; t++) {
+            double f = full_fretboard[t].frequency;
+            double phase = 0.7 * t;
+            for (int i = 0; i < SAMPLE_SIZE; i++) {
+                double w = 2.0 * M_PI * f * i / SAMPLE_RATE + phase;
+                samples[i] = (int16_t)(8000.0 * (sin(w) + 0.5 * sin(2.0 * w) + 0.2 * sin(3.0 * w)));
+            }
+            double freq = apply_fft(samples, SAMPLE_SIZE);
+            if (freq <= 0.0) continue;
+            detected++;
+            double error = fabs(1200.0 * log2(freq / f));
+            if (f < 130.0 && error > worst_low) worst_low = error;
+            if (f >= 130.0 && error > worst_high) worst_high = error;
+        }
+        if (long_pass) {
+            pass = (detected == NUM_FULL_FRETBOARD && worst_high < 1.0 && worst_low < 1.0);
+        } else {
+            pass = (detected == NUM_FULL_FRETBOARD && worst_high < 6.0 && worst_low < 50.0);
+        }
+        printf("Fretboard%s: %d/%d detected, worst %.2f cents from C3, %.2f below (bin centre: up to 400) | %s\n",
+               long_pass ? " (long refinement)" : "", detected, NUM_FULL_FRETBOARD, worst_high, worst_low,
+               pass ? "[OK] PASS" : "[X] FAIL");
+        if (pass) pass_count++;
+    }
+    
+    /* Flat, in tune and sharp now read differently from a single frame */
+    const double offsets[3] = { -10.0, 0.0, 10.0 };
+    pass = 1;
+    for (int k = 0; k < 3; k++) {
+        double f = 196.0 * pow(2.0, offsets[k] / 1200.0);
+        for (int i = 0; i < SAMPLE_SIZE; i++) {
+            samples[i] = (int16_t)(10000.0 * sin(2.0 * M_PI * f * i / SAMPLE_RATE));
+        }
+        TuningResult r = analyze_tuning(apply_fft(samples, SAMPLE_SIZE), 3);
+        printf("G3 %+.0f cents: reads %+.2f cents\n", offsets[k], r.cents_offset);
+        if (fabs(r.cents_offset - offsets[k]) > 2.0) pass = 0;
+    }
+    printf("Single-frame cents within 2 of the truth | %s\n", pass ? "[OK] PASS" : "[X] FAIL");
+    if (pass) pass_count++;
+    
+    /* A steady E2 and A2 through the streaming path: once the window is
+       full, every frame of the long refinement must read the same note
+       to within a cent */
+    const double low_strings[2] = { 82.41, 110.0 };
+    audio_processing_set_long_refinement(1);
+    pass = 1;
+    for (int s = 0; s < 2; s++) {
+        double f = low_strings[s];
+        double lowest = 1e9, highest = -1e9;
+        int16_t block[128];
+        audio_processing_set_hum_notch(HUM_NOTCH_AUTO);
+        for (int b = 0; b < 120; b++) {
+            for (int i = 0; i < 128; i++) {
+                double w = 2.0 * M_PI * f * (b * 128 + i) / SAMPLE_RATE;
+                block[i] = (int16_t)(7000.0 * (sin(w) + 0.8 * sin(2.0 * w + 0.5) + 0.4 * sin(3.0 * w + 1.1)) +
+                                     (rand() % 201 - 100));
+            }
+            double freq = 0.0;
+            if (audio_processing_process_block(block, 128, &freq) && b >= 8 && freq > 0.0) {
+                double cents = 1200.0 * log2(freq / f);
+                if (cents < lowest) lowest = cents;
+                if (cents > highest) highest = cents;
+            }
+        }
+        int ok = (lowest >= -1.0 && highest <= 1.0);
+        printf("Steady %s: frames read %+.2f..%+.2f cents | %s\n", s == 0 ? "E2" : "A2", lowest, highest,
+               ok ? "[OK] PASS" : "[X] FAIL");
+        if (!ok) pass = 0;
+    }
+    if (pass) pass_count++;
+    audio_processing_set_long_refinement(0);
+    
+    printf("\n>> Fine Refinement Result: %d/6 PASSED\n\n", pass_count);
+}
+
 /* ============================================================
    MAIN TEST RUNNER
    ============================================================ */
@@ -594,7 +2815,7 @@ int main(void) {
     printf("  [OK] Test framework initialized\n\n");
     
     printf("========================================================\n");
-    printf("RUNNING 8 TEST SUITES (120+ test cases total)\n");
+    printf("RUNNING 28 TEST SUITES (120+ test cases total)\n");
     printf("========================================================\n\n");
     
     /* Run all tests */
@@ -606,6 +2827,28 @@ int main(void) {
     test_tuning_direction();
     test_memory_optimization();
     test_performance();
+    test_tuning_profiles();
+    test_biquad_prefilter();
+    test_noise_floor();
+    test_hum_notch();
+    test_harmonic_validation();
+    test_capture_driver();
+    test_wav_reader();
+    test_wav_decoder();
+    test_prompt_cache();
+    test_prompt_bundle();
+    test_prompt_playlist();
+    test_tone_synth();
+    test_feedback_scheduler();
+    test_voice_mixer();
+    test_tuner_sessions();
+    test_hex_analyzer();
+    test_strum_analyzer();
+    test_spectral_peaks();
+    test_fine_tune();
+    test_cqt_analyzer();
+    test_progressive_estimator();
+    test_fine_refinement();
     
     /* Comprehensive Summary with Calculations */
     printf("\n");
@@ -1,14 +1,15 @@
 //noise filtering functions
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h> 
+#include <string.h>
+#include "noise_filtering.h"
 
 // insertion sort (for median filter)
 float find_median(float *buffer, int size) {
     for (int i = 1; i < size; i++) {
         float key = buffer[i];
         int j = i - 1;
-        
+
         while (j >= 0 && buffer[j] > key) {
             buffer[j + 1] = buffer[j];
             j--;
@@ -24,33 +25,208 @@ float find_median(float *buffer, int size) {
     }
 }
 
+//*************sorted window helpers**************** */
+// the window is kept sorted, so each new sample costs one binary search to
+// find the outgoing value, one to find the slot for the incoming value, and
+// a memmove of only the elements between those two positions
+
+// first index in sorted[0..size) whose value is >= value
+static int lower_bound(const float *sorted, int size, float value) {
+    int lo = 0;
+    int hi = size;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sorted[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void sorted_insert(float *sorted, int size, float value) {
+    int pos = lower_bound(sorted, size, value);
+    memmove(&sorted[pos + 1], &sorted[pos], (size - pos) * sizeof(float));
+    sorted[pos] = value;
+}
+
+static void sorted_remove(float *sorted, int size, float value) {
+    int pos = lower_bound(sorted, size, value);
+    memmove(&sorted[pos], &sorted[pos + 1], (size - pos - 1) * sizeof(float));
+}
+
+// swap the outgoing value for the incoming one without changing the size
+static void sorted_replace(float *sorted, int size, float old_value, float new_value) {
+    int old_pos = lower_bound(sorted, size, old_value);
+    if (new_value > old_value) {
+        // slide the elements between old_pos and the new slot down by one
+        int new_pos = lower_bound(sorted, size, new_value) - 1;
+        memmove(&sorted[old_pos], &sorted[old_pos + 1], (new_pos - old_pos) * sizeof(float));
+        sorted[new_pos] = new_value;
+    } else {
+        // slide the elements between the new slot and old_pos up by one
+        int new_pos = lower_bound(sorted, old_pos, new_value);
+        memmove(&sorted[new_pos + 1], &sorted[new_pos], (old_pos - new_pos) * sizeof(float));
+        sorted[new_pos] = new_value;
+    }
+}
+
+static float sorted_median(const float *sorted, int size) {
+    if (size % 2 == 0) {
+        return (sorted[size/2 - 1] + sorted[size/2]) / 2.0f;
+    }
+    return sorted[size/2];
+}
+
+//*************sorting network fast path (w <= 9)**************** */
+// fixed compare-exchange networks that only compute the middle element
+// (Paeth / Devillard median networks), much cheaper than keeping a sorted window
+
+#define SORT2(a, b) { if ((a) > (b)) { float t_ = (a); (a) = (b); (b) = t_; } }
+
+static float median3(const float *r) {
+    float a = r[0], b = r[1], c = r[2];
+    SORT2(a, b); SORT2(b, c); SORT2(a, b);
+    return b;
+}
+
+static float median5(const float *r) {
+    float p0 = r[0], p1 = r[1], p2 = r[2], p3 = r[3], p4 = r[4];
+    SORT2(p0, p1); SORT2(p3, p4); SORT2(p0, p3);
+    SORT2(p1, p4); SORT2(p1, p2); SORT2(p2, p3);
+    SORT2(p1, p2);
+    return p2;
+}
+
+static float median7(const float *r) {
+    float p0 = r[0], p1 = r[1], p2 = r[2], p3 = r[3], p4 = r[4], p5 = r[5], p6 = r[6];
+    SORT2(p0, p5); SORT2(p0, p3); SORT2(p1, p6);
+    SORT2(p2, p4); SORT2(p0, p1); SORT2(p3, p5);
+    SORT2(p2, p6); SORT2(p2, p3); SORT2(p3, p6);
+    SORT2(p4, p5); SORT2(p1, p4); SORT2(p1, p3);
+    SORT2(p3, p4);
+    return p3;
+}
+
+static float median9(const float *r) {
+    float p0 = r[0], p1 = r[1], p2 = r[2], p3 = r[3], p4 = r[4];
+    float p5 = r[5], p6 = r[6], p7 = r[7], p8 = r[8];
+    SORT2(p1, p2); SORT2(p4, p5); SORT2(p7, p8);
+    SORT2(p0, p1); SORT2(p3, p4); SORT2(p6, p7);
+    SORT2(p1, p2); SORT2(p4, p5); SORT2(p7, p8);
+    SORT2(p0, p3); SORT2(p5, p8); SORT2(p4, p7);
+    SORT2(p3, p6); SORT2(p1, p4); SORT2(p2, p5);
+    SORT2(p4, p7); SORT2(p4, p2); SORT2(p6, p4);
+    SORT2(p4, p2);
+    return p4;
+}
+
+static float network_median(const float *ring, int window) {
+    switch (window) {
+        case 1: return ring[0];
+        case 3: return median3(ring);
+        case 5: return median5(ring);
+        case 7: return median7(ring);
+        default: return median9(ring);
+    }
+}
+
 
 // MEDIAN FILTER
 // window size: smaller window size - less smoothing of data, bigger window size - more smoothing of data
 void median_filter(const float *input, float *output, int length, int window_size) {
     if (window_size % 2 == 0) {
-        window_size++; 
+        window_size++;
+    }
+    if (window_size > MEDIAN_FILTER_MAX_WINDOW) {
+        window_size = MEDIAN_FILTER_MAX_WINDOW;
     }
 
     int half_window =  window_size / 2;
 
-    float *window_buffer = (float *)malloc(window_size * sizeof(float));
-    if(!window_buffer) {
-        fprintf(stderr, "Memory allocation failed\n");
+    // sorted copy of the current (edge-truncated) window, lives on the stack
+    float window_buffer[MEDIAN_FILTER_MAX_WINDOW];
+    int size = 0;
+
+    // prime the window with the samples to the right of index 0
+    for (int j = 0; j < half_window && j < length; j++) {
+        sorted_insert(window_buffer, size++, input[j]);
     }
 
     //iterate through every element of audio data array
     for (int i = 0; i < length; i++) {
-        int actual_window_size = 0; 
-
-        //stores neighboring data points of current index in window buffer
-        for (int j = -half_window; j <= half_window; j++) {
-            int index = i + j;
-            
-            if (index >= 0 && index < length) {
-                window_buffer[actual_window_size++] = input[index];
+        int incoming = i + half_window;     // enters the window at this step
+        int outgoing = i - half_window - 1; // left the window at this step
+        int has_in = (incoming < length);
+        int has_out = (outgoing >= 0);
+
+        if (has_in && has_out) {
+            sorted_replace(window_buffer, size, input[outgoing], input[incoming]);
+        } else if (has_in) {
+            sorted_insert(window_buffer, size++, input[incoming]);
+        } else if (has_out) {
+            sorted_remove(window_buffer, size--, input[outgoing]);
+        }
+
+        output[i] = sorted_median(window_buffer, size);
+    }
+}
+
+//*************streaming median**************** */
+
+int median_filter_init(median_filter_state_t *state, int window_size, float *storage) {
+    if (!state || !storage || window_size < 1) {
+        return -1;
+    }
+    if (window_size % 2 == 0) {
+        window_size++;
+    }
+
+    state->window = window_size;
+    state->ring = storage;
+    state->sorted = storage + window_size;
+    median_filter_reset(state);
+    return 0;
+}
+
+void median_filter_reset(median_filter_state_t *state) {
+    state->count = 0;
+    state->head = 0;
+}
+
+void median_filter_process(median_filter_state_t *state, const float *input, float *output, int length) {
+    int window = state->window;
+    int use_network = (window <= 9);
+
+    for (int i = 0; i < length; i++) {
+        float sample = input[i];
+
+        if (state->count < window) {
+            // warm-up: window still filling, head stays at 0
+            state->ring[state->count] = sample;
+            if (use_network) {
+                float scratch[9];
+                memcpy(scratch, state->ring, (state->count + 1) * sizeof(float));
+                state->count++;
+                output[i] = find_median(scratch, state->count);
+            } else {
+                sorted_insert(state->sorted, state->count++, sample);
+                output[i] = sorted_median(state->sorted, state->count);
             }
+            continue;
+        }
+
+        float oldest = state->ring[state->head];
+        state->ring[state->head] = sample;
+        state->head = (state->head + 1 == window) ? 0 : state->head + 1;
+
+        if (use_network) {
+            // order inside the ring does not matter for the median
+            output[i] = network_median(state->ring, window);
+        } else {
+            sorted_replace(state->sorted, window, oldest, sample);
+            output[i] = state->sorted[window / 2];
         }
-        output[i] = find_median(window_buffer, actual_window_size);
     }
 }
@@ -0,0 +1,52 @@
+//noise filtering functions
+#ifndef NOISE_FILTERING_H
+#define NOISE_FILTERING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// largest window median_filter() handles without caller-provided memory
+#define MEDIAN_FILTER_MAX_WINDOW 127
+
+// floats of storage a streaming median of window w needs (ring + sorted copy)
+// an even w is rounded up to the next odd size, as median_filter_init() does
+#define MEDIAN_FILTER_STORAGE(w) (2 * ((w) | 1))
+
+// streaming median filter state
+// carries its window across blocks, so 128-sample audio blocks can be filtered
+// back to back with the same result as filtering the whole signal at once
+typedef struct {
+    int window;         // window size (always odd)
+    int count;          // samples currently in the window (< window during warm-up)
+    int head;           // ring index of the oldest sample
+    float *ring;        // last `window` samples in arrival order
+    float *sorted;      // same samples kept in ascending order (unused on the w <= 9 path)
+} median_filter_state_t;
+
+// insertion sort (for median filter), sorts buffer in place and returns its median
+float find_median(float *buffer, int size);
+
+// batch median filter with a centred window, windows shrink at the edges
+// window size: smaller window size - less smoothing of data, bigger window size - more smoothing of data
+// even window sizes are rounded up, sizes above MEDIAN_FILTER_MAX_WINDOW are clamped
+void median_filter(const float *input, float *output, int length, int window_size);
+
+// set up a streaming median using caller-provided storage of MEDIAN_FILTER_STORAGE(window) floats
+// returns 0 on success, -1 on bad arguments
+int median_filter_init(median_filter_state_t *state, int window_size, float *storage);
+
+// clear the window (keeps window size and storage)
+void median_filter_reset(median_filter_state_t *state);
+
+// filter one block; output[i] is the median of the last `window` inputs (delay of window/2 samples)
+// input and output may point to the same buffer
+void median_filter_process(median_filter_state_t *state, const float *input, float *output, int length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NOISE_FILTERING_H
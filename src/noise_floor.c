@@ -0,0 +1,149 @@
+/**
+ * noise_floor.c - Minimum-statistics noise-floor tracker
+ */
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include "noise_floor.h"
+
+void noise_floor_init(noise_floor_t* nf, uint32_t num_bins, uint32_t band_bins, float snr_threshold) {
+	memset(nf, 0, sizeof(*nf));
+	nf->num_bins = (num_bins > NOISE_FLOOR_MAX_BINS) ? NOISE_FLOOR_MAX_BINS : num_bins;
+	nf->band_bins = (band_bins > nf->num_bins || band_bins < 2) ? nf->num_bins : band_bins;
+	nf->snr_threshold = snr_threshold;
+
+	for (uint32_t k = 0; k < NOISE_FLOOR_MAX_BINS; k++) {
+		nf->current_min[k] = FLT_MAX;
+		nf->history_min[k] = FLT_MAX;
+		for (uint32_t u = 0; u < NOISE_FLOOR_SUBWINDOWS; u++) {
+			nf->subwindow_min[u][k] = FLT_MAX;
+		}
+	}
+}
+
+/**
+ * Is bin k within the main lobe of one of the note's first partials?
+ */
+static int is_held_bin(uint32_t k, uint32_t note_bin) {
+	if (note_bin == 0) {
+		return 0;
+	}
+	for (uint32_t h = 1; h <= NOISE_FLOOR_HOLD_HARMONICS; h++) {
+		uint32_t centre = h * note_bin;
+		if (k + NOISE_FLOOR_HOLD_BINS >= centre && k <= centre + NOISE_FLOOR_HOLD_BINS) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Median of the floor across the analysis band (insertion sort on a scratch copy)
+ * Only runs once per sub-window
+ */
+static float median_floor_power(const noise_floor_t* nf) {
+	float sorted[NOISE_FLOOR_MAX_BINS];
+	uint32_t n = 0;
+
+	for (uint32_t k = 1; k < nf->band_bins; k++) {  /* Skip DC */
+		if (!nf->seen[k]) {
+			continue;                               /* Never seen without a note */
+		}
+		float key = nf->floor_power[k];
+		int j = (int)n - 1;
+		while (j >= 0 && sorted[j] > key) {
+			sorted[j + 1] = sorted[j];
+			j--;
+		}
+		sorted[j + 1] = key;
+		n++;
+	}
+	return (n > 0) ? sorted[n / 2] : 0.0f;
+}
+
+void noise_floor_update(noise_floor_t* nf, const float* magnitude, uint32_t note_bin) {
+	const float alpha = NOISE_FLOOR_SMOOTHING;
+	uint32_t n = nf->num_bins;
+
+	for (uint32_t k = 0; k < n; k++) {
+		/* Bins carrying the detected note keep their previous estimate.
+		   A bin held since the start has no estimate yet and is left out
+		   of the broadband level until it is first seen without the note. */
+		if (is_held_bin(k, note_bin)) {
+			continue;
+		}
+
+		float power = magnitude[k] * magnitude[k];
+
+		/* First sight of a bin seeds the smoother instead of ramping up from zero */
+		nf->smoothed[k] = nf->seen[k] ? alpha * nf->smoothed[k] + (1.0f - alpha) * power : power;
+		nf->seen[k] = 1;
+
+		if (nf->smoothed[k] < nf->current_min[k]) {
+			nf->current_min[k] = nf->smoothed[k];
+		}
+
+		float minimum = (nf->current_min[k] < nf->history_min[k]) ? nf->current_min[k] : nf->history_min[k];
+		nf->floor_power[k] = NOISE_FLOOR_BIAS * minimum;
+	}
+
+	nf->frames_seen++;
+
+	/* Close the sub-window: store its minimum and recombine the history */
+	if (++nf->frame_in_subwindow == NOISE_FLOOR_SUBWINDOW_FRAMES) {
+		nf->frame_in_subwindow = 0;
+		memcpy(nf->subwindow_min[nf->subwindow_index], nf->current_min, n * sizeof(float));
+		nf->subwindow_index = (nf->subwindow_index + 1) % NOISE_FLOOR_SUBWINDOWS;
+
+		for (uint32_t k = 0; k < n; k++) {
+			float minimum = nf->subwindow_min[0][k];
+			for (uint32_t u = 1; u < NOISE_FLOOR_SUBWINDOWS; u++) {
+				if (nf->subwindow_min[u][k] < minimum) {
+					minimum = nf->subwindow_min[u][k];
+				}
+			}
+			nf->history_min[k] = minimum;
+			nf->current_min[k] = nf->seen[k] ? nf->smoothed[k] : FLT_MAX;
+		}
+		nf->broadband_power = median_floor_power(nf);
+	}
+}
+
+int noise_floor_ready(const noise_floor_t* nf) {
+	return nf->frames_seen >= NOISE_FLOOR_SUBWINDOWS * NOISE_FLOOR_SUBWINDOW_FRAMES;
+}
+
+float noise_floor_magnitude(const noise_floor_t* nf, uint32_t bin) {
+	if (bin >= nf->num_bins) {
+		return 0.0f;
+	}
+	return sqrtf(nf->floor_power[bin]);
+}
+
+float noise_floor_broadband_power(const noise_floor_t* nf) {
+	return nf->broadband_power;
+}
+
+float noise_floor_threshold(const noise_floor_t* nf, uint32_t bin) {
+	/* Per-bin estimates from a short history are noisy; never let one bin's
+	   floor drop below the broadband level or isolated noise bins slip through */
+	float power = (bin < nf->num_bins) ? nf->floor_power[bin] : 0.0f;
+	if (power < nf->broadband_power) {
+		power = nf->broadband_power;
+	}
+	return nf->snr_threshold * sqrtf(power);
+}
+
+void noise_floor_subtract(const noise_floor_t* nf, float* magnitude, float over_subtraction, float spectral_floor) {
+	float keep = spectral_floor * spectral_floor;
+
+	for (uint32_t k = 0; k < nf->num_bins; k++) {
+		float power = magnitude[k] * magnitude[k];
+		float cleaned = power - over_subtraction * nf->floor_power[k];
+		if (cleaned < keep * power) {
+			cleaned = keep * power;
+		}
+		magnitude[k] = sqrtf(cleaned);
+	}
+}
@@ -0,0 +1,106 @@
+/**
+ * noise_floor.h - Adaptive noise-floor estimation over the magnitude spectrum
+ *
+ * Minimum-statistics tracker (after R. Martin): each bin's power is smoothed
+ * over frames, and the noise floor is the minimum of that smoothed power over
+ * a sliding history of a few sub-windows, scaled by a bias factor. Speech and
+ * plucked notes come and go, so their bins dip back to the floor within the
+ * history while stationary noise (fans, hum, room tone) never does.
+ *
+ * When a note has been detected its partials are held out of the update, so
+ * a long sustained note is never learned as noise.
+ *
+ * Cost per frame is one multiply-add and two compares per bin; the sliding
+ * minimum and the broadband level are only recombined once per sub-window.
+ */
+
+#ifndef NOISE_FLOOR_H
+#define NOISE_FLOOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NOISE_FLOOR_MAX_BINS        128     /* FFT_SIZE / 2 */
+#define NOISE_FLOOR_SUBWINDOWS      4       /* U: sub-windows in the minimum history */
+#define NOISE_FLOOR_SUBWINDOW_FRAMES 8      /* V: frames per sub-window (history = U*V frames) */
+#define NOISE_FLOOR_SMOOTHING       0.7f    /* Recursive power smoothing factor */
+#define NOISE_FLOOR_BIAS            2.0f    /* Compensates the minimum's downward bias */
+#define NOISE_FLOOR_SNR_DEFAULT     3.0f    /* Peak must exceed 3x the floor magnitude (~9.5 dB) */
+#define NOISE_FLOOR_HOLD_BINS       2       /* Bins held either side of a detected partial (Hann main lobe) */
+#define NOISE_FLOOR_HOLD_HARMONICS  4       /* Partials of a detected note held out of the update */
+
+typedef struct {
+	uint32_t num_bins;
+	uint32_t band_bins;                                         /* Bins [1, band_bins) used for the broadband level */
+	uint32_t frames_seen;
+	uint32_t frame_in_subwindow;
+	uint32_t subwindow_index;
+	float snr_threshold;                                        /* Magnitude ratio over the floor */
+	float smoothed[NOISE_FLOOR_MAX_BINS];                       /* Smoothed power per bin */
+	float current_min[NOISE_FLOOR_MAX_BINS];                    /* Minimum within the open sub-window */
+	float history_min[NOISE_FLOOR_MAX_BINS];                    /* Minimum over the closed sub-windows */
+	float subwindow_min[NOISE_FLOOR_SUBWINDOWS][NOISE_FLOOR_MAX_BINS];
+	float floor_power[NOISE_FLOOR_MAX_BINS];                    /* Bias-compensated noise power */
+	float broadband_power;                                      /* Median floor power across the band */
+	uint8_t seen[NOISE_FLOOR_MAX_BINS];                         /* Bin has been updated at least once */
+} noise_floor_t;
+
+/**
+ * Initialize (or restart) a tracker
+ *
+ * @param num_bins: Bins per magnitude spectrum (<= NOISE_FLOOR_MAX_BINS)
+ * @param band_bins: Upper end of the analysis band (the peak search range);
+ *                   the broadband level is taken over bins 1..band_bins-1
+ * @param snr_threshold: Detection threshold as a magnitude ratio over the floor
+ */
+void noise_floor_init(noise_floor_t* nf, uint32_t num_bins, uint32_t band_bins, float snr_threshold);
+
+/**
+ * Feed one magnitude spectrum
+ *
+ * @param magnitude: Magnitude spectrum of the frame
+ * @param note_bin: Bin of the note detected in this frame (0 = none); the
+ *                  bins around it and its first harmonics keep their old floor
+ */
+void noise_floor_update(noise_floor_t* nf, const float* magnitude, uint32_t note_bin);
+
+/**
+ * Has the tracker seen enough frames (the full minimum history) to be trusted?
+ */
+int noise_floor_ready(const noise_floor_t* nf);
+
+/**
+ * Estimated noise magnitude in a bin
+ */
+float noise_floor_magnitude(const noise_floor_t* nf, uint32_t bin);
+
+/**
+ * Typical noise power per bin (median across the analysis band, robust to tonal bins)
+ * Updated once per sub-window
+ */
+float noise_floor_broadband_power(const noise_floor_t* nf);
+
+/**
+ * SNR-relative detection threshold for a bin
+ * snr_threshold * floor magnitude, with the broadband level as a lower bound
+ */
+float noise_floor_threshold(const noise_floor_t* nf, uint32_t bin);
+
+/**
+ * Power spectral subtraction in place
+ * |Y|^2 = max(|X|^2 - over_subtraction * N, spectral_floor^2 * |X|^2)
+ *
+ * @param magnitude: Magnitude spectrum, modified in place
+ * @param over_subtraction: Noise scale (1.0 - 2.0 typical)
+ * @param spectral_floor: Fraction of the original magnitude always kept (avoids musical noise)
+ */
+void noise_floor_subtract(const noise_floor_t* nf, float* magnitude, float over_subtraction, float spectral_floor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NOISE_FLOOR_H */
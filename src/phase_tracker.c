@@ -0,0 +1,190 @@
+/**
+ * phase_tracker.c - Target-locked quadrature demodulator implementation
+ *
+ * The oscillator is a recursive phasor rotation inside a block and is
+ * restarted from the double-precision phase at every block, so it never
+ * drifts in amplitude. The moving-average sums are kept in double and
+ * updated by add/subtract of the ring entries, one pass per sample; both
+ * stages share the ring position since they have the same length.
+ */
+
+#include "phase_tracker.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+/* ============================================================================
+ * INIT / LOCK
+ * ========================================================================== */
+
+void phase_tracker_init(phase_tracker_t* tracker, float sample_rate) {
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->sample_rate = sample_rate;
+    tracker->state = PHASE_TRACKER_IDLE;
+}
+
+int phase_tracker_lock(phase_tracker_t* tracker, double target_hz) {
+    const double fs = tracker->sample_rate;
+    if (target_hz <= 0.0 || target_hz >= fs / 2.0) {
+        return -1;
+    }
+
+    /* Whole periods covering at least PHASE_TRACKER_SPAN_MS */
+    int periods = (int)ceil(PHASE_TRACKER_SPAN_MS * target_hz / 1000.0);
+    uint32_t span = (uint32_t)lround(periods * fs / target_hz);
+    while (span > PHASE_TRACKER_MAX_SPAN && periods > 1) {
+        periods--;
+        span = (uint32_t)lround(periods * fs / target_hz);
+    }
+    if (span > PHASE_TRACKER_MAX_SPAN) {
+        return -1;
+    }
+
+    float sample_rate = tracker->sample_rate;
+    phase_tracker_init(tracker, sample_rate);
+    tracker->target_hz = target_hz;
+    tracker->span = span;
+    tracker->inv_span = 1.0 / span;
+    tracker->osc_step = 2.0 * PI * target_hz / fs;
+    tracker->rot_cos = (float)cos(tracker->osc_step);
+    tracker->rot_sin = (float)sin(tracker->osc_step);
+    tracker->state = PHASE_TRACKER_SETTLING;
+    return 0;
+}
+
+void phase_tracker_release(phase_tracker_t* tracker) {
+    phase_tracker_init(tracker, tracker->sample_rate);
+}
+
+/* ============================================================================
+ * DEMODULATION
+ * ========================================================================== */
+
+/**
+ * Mix one block down and update both moving-average stages
+ */
+static void demodulate(phase_tracker_t* tracker, const float* samples, uint32_t num_samples) {
+    float c = (float)cos(tracker->osc_phase);
+    float s = (float)sin(tracker->osc_phase);
+    const float rc = tracker->rot_cos;
+    const float rs = tracker->rot_sin;
+    uint32_t pos = tracker->pos;
+
+    for (uint32_t n = 0; n < num_samples; n++) {
+        const float x = samples[n];
+        const float re = x * c;
+        const float im = -x * s;
+        const float p = x * x;
+
+        tracker->sum_re += re - tracker->mix_re[pos];
+        tracker->sum_im += im - tracker->mix_im[pos];
+        tracker->sum_power += p - tracker->power[pos];
+        tracker->mix_re[pos] = re;
+        tracker->mix_im[pos] = im;
+        tracker->power[pos] = p;
+
+        /* Second stage: average of the first stage's averages */
+        const float avg_re = (float)(tracker->sum_re * tracker->inv_span);
+        const float avg_im = (float)(tracker->sum_im * tracker->inv_span);
+        tracker->sum2_re += avg_re - tracker->avg_re[pos];
+        tracker->sum2_im += avg_im - tracker->avg_im[pos];
+        tracker->avg_re[pos] = avg_re;
+        tracker->avg_im[pos] = avg_im;
+        if (++pos == tracker->span) {
+            pos = 0;
+        }
+
+        const float next_c = c * rc - s * rs;
+        s = s * rc + c * rs;
+        c = next_c;
+    }
+
+    tracker->pos = pos;
+    tracker->fill = (tracker->fill + num_samples > 2 * tracker->span) ? 2 * tracker->span : tracker->fill + num_samples;
+    tracker->samples += num_samples;
+    tracker->osc_phase = fmod(tracker->osc_phase + num_samples * tracker->osc_step, 2.0 * PI);
+}
+
+/**
+ * Unwrap the averaged phase and append it to the history ring
+ */
+static void record_phase(phase_tracker_t* tracker) {
+    double phase = atan2(tracker->sum2_im, tracker->sum2_re);
+
+    if (tracker->history_count == 0) {
+        tracker->unwrapped = phase;
+    } else {
+        double delta = phase - tracker->last_phase;
+        if (delta > PI) {
+            delta -= 2.0 * PI;
+        } else if (delta < -PI) {
+            delta += 2.0 * PI;
+        }
+        tracker->unwrapped += delta;
+    }
+    tracker->last_phase = phase;
+
+    tracker->history_phase[tracker->history_pos] = tracker->unwrapped;
+    tracker->history_time[tracker->history_pos] = tracker->samples;
+    tracker->history_pos = (tracker->history_pos + 1) % (PHASE_TRACKER_HISTORY + 1);
+    if (tracker->history_count < PHASE_TRACKER_HISTORY + 1) {
+        tracker->history_count++;
+    }
+}
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+phase_tracker_state_t phase_tracker_process(phase_tracker_t* tracker, const float* samples, uint32_t num_samples) {
+    if (tracker->state == PHASE_TRACKER_IDLE || tracker->state == PHASE_TRACKER_LOST || num_samples == 0) {
+        return tracker->state;
+    }
+
+    demodulate(tracker, samples, num_samples);
+    if (tracker->fill < 2 * tracker->span) {
+        return tracker->state;
+    }
+    record_phase(tracker);
+
+    const double mean_power = tracker->sum_power / tracker->span;
+    const double avg_re = tracker->sum2_re / tracker->span;
+    const double avg_im = tracker->sum2_im / tracker->span;
+    tracker->rms = (float)sqrt(mean_power);
+    tracker->purity = (mean_power > 0.0) ? (float)(2.0 * (avg_re * avg_re + avg_im * avg_im) / mean_power) : 0.0f;
+
+    if (tracker->history_count < 3) {
+        return tracker->state;      // Two block spans before the first reading
+    }
+
+    /* Oldest entry is the one about to be overwritten */
+    uint32_t oldest = (tracker->history_count == PHASE_TRACKER_HISTORY + 1) ? tracker->history_pos : 0;
+    double elapsed = (double)(tracker->samples - tracker->history_time[oldest]) / tracker->sample_rate;
+    double offset_hz = (tracker->unwrapped - tracker->history_phase[oldest]) / (2.0 * PI * elapsed);
+    double played = tracker->target_hz + offset_hz;
+    double cents = (played > 0.0) ? 1200.0 * log2(played / tracker->target_hz) : -1200.0;
+
+    /* A single bad block keeps the previous reading */
+    int bad = (tracker->rms < PHASE_TRACKER_MIN_RMS) ||
+              (tracker->purity < PHASE_TRACKER_MIN_PURITY) ||
+              (fabs(cents) > PHASE_TRACKER_LOCK_CENTS);
+    if (!bad) {
+        tracker->offset_hz = offset_hz;
+        tracker->cents = cents;
+        tracker->bad_blocks = 0;
+        tracker->state = PHASE_TRACKER_LOCKED;
+    } else if (++tracker->bad_blocks >= PHASE_TRACKER_LOSS_BLOCKS) {
+        tracker->state = PHASE_TRACKER_LOST;
+    }
+    return tracker->state;
+}
+
+double phase_tracker_frequency(const phase_tracker_t* tracker) {
+    if (tracker->state != PHASE_TRACKER_LOCKED) {
+        return 0.0;
+    }
+    return tracker->target_hz + tracker->offset_hz;
+}
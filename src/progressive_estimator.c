@@ -0,0 +1,170 @@
+/**
+ * progressive_estimator.c - Coarse-to-fine pitch estimate implementation
+ *
+ * NSDF(tau) = 2 r(tau) / m(tau), r the autocorrelation and m the energy of
+ * both overlapping parts, taken from prefix sums of squares so each lag
+ * costs one dot product. The full lag range is searched only for the
+ * coarse estimate; refining blocks search a few lags around it.
+ */
+
+#include "progressive_estimator.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+ * INIT
+ * ========================================================================== */
+
+void progressive_init(progressive_estimator_t* estimator, const tuning_table_t* tuning) {
+    memset(estimator, 0, sizeof(*estimator));
+    if (tuning == NULL) {
+        tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    }
+    estimator->tuning = tuning;
+
+    double lowest = tuning->min_hz * pow(2.0, -PROGRESSIVE_RANGE_BELOW / 12.0);
+    double highest = tuning->max_hz * pow(2.0, PROGRESSIVE_RANGE_ABOVE / 12.0);
+    uint32_t max_lag = (uint32_t)ceil(PROGRESSIVE_SAMPLE_RATE / lowest);
+    uint32_t min_lag = (uint32_t)floor(PROGRESSIVE_SAMPLE_RATE / highest);
+    estimator->max_lag = (max_lag > PROGRESSIVE_MAX_LAG) ? PROGRESSIVE_MAX_LAG : max_lag;
+    estimator->min_lag = (min_lag < 2) ? 2 : min_lag;
+    estimator->coarse_samples = (uint32_t)ceil(2.0 * PROGRESSIVE_SAMPLE_RATE / tuning->min_hz);
+    if (estimator->coarse_samples > PROGRESSIVE_WINDOW) {
+        estimator->coarse_samples = PROGRESSIVE_WINDOW;
+    }
+    progressive_reset(estimator);
+}
+
+void progressive_reset(progressive_estimator_t* estimator) {
+    estimator->fill = 0;
+    estimator->level = PROGRESSIVE_NONE;
+    estimator->lag = 0.0;
+    estimator->frequency = 0.0;
+    estimator->previous_frequency = 0.0;
+    estimator->clarity = 0.0f;
+    estimator->full_search = 1;
+}
+
+/* ============================================================================
+ * NSDF
+ * ========================================================================== */
+
+/**
+ * NSDF peak over lags [lo, hi] of the samples gathered so far
+ * @return 1 with estimator->lag / clarity set, 0 if no peak qualifies
+ */
+static int nsdf_peak(progressive_estimator_t* estimator, uint32_t lo, uint32_t hi) {
+    const uint32_t n = estimator->fill;
+    float* c = estimator->centered;
+    float* energy = estimator->energy;
+    float* nsdf = estimator->nsdf;
+
+    if (hi > n / 2) {
+        hi = n / 2;         // At least half the samples overlap
+    }
+    if (lo < 2) {
+        lo = 2;
+    }
+    if (hi < lo + 2) {
+        return 0;
+    }
+
+    float mean = 0.0f;
+    for (uint32_t j = 0; j < n; j++) {
+        mean += estimator->samples[j];
+    }
+    mean /= (float)n;
+    energy[0] = 0.0f;
+    for (uint32_t j = 0; j < n; j++) {
+        c[j] = estimator->samples[j] - mean;
+        energy[j + 1] = energy[j] + c[j] * c[j];
+    }
+
+    for (uint32_t tau = lo - 1; tau <= hi + 1; tau++) {
+        float r = 0.0f;
+        for (uint32_t j = 0; j + tau < n; j++) {
+            r += c[j] * c[j + tau];
+        }
+        float m = (energy[n - tau] - energy[0]) + (energy[n] - energy[tau]);
+        nsdf[tau] = (m > 0.0f) ? 2.0f * r / m : 0.0f;
+    }
+
+    /* Highest peak, then the first peak close to it */
+    float highest = 0.0f;
+    for (uint32_t tau = lo; tau <= hi; tau++) {
+        if (nsdf[tau] > highest && nsdf[tau] >= nsdf[tau - 1] && nsdf[tau] >= nsdf[tau + 1]) {
+            highest = nsdf[tau];
+        }
+    }
+    if (highest < PROGRESSIVE_MIN_CLARITY) {
+        return 0;
+    }
+    uint32_t peak = lo;
+    for (uint32_t tau = lo; tau <= hi; tau++) {
+        if (nsdf[tau] >= PROGRESSIVE_PEAK_K * highest && nsdf[tau] >= nsdf[tau - 1] && nsdf[tau] >= nsdf[tau + 1]) {
+            peak = tau;
+            break;
+        }
+    }
+
+    float a = nsdf[peak - 1], b = nsdf[peak], d = nsdf[peak + 1];
+    float denominator = a - 2.0f * b + d;
+    double offset = (denominator < 0.0f) ? 0.5 * (a - d) / denominator : 0.0;
+    estimator->lag = peak + offset;
+    estimator->clarity = b - 0.25f * (a - d) * (float)offset;
+    return 1;
+}
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+progressive_level_t progressive_process_block(progressive_estimator_t* estimator, const int16_t* block,
+                                              int num_samples) {
+    if (num_samples <= 0) {
+        return estimator->level;
+    }
+
+    /* Append; once full, keep the newest PROGRESSIVE_WINDOW samples */
+    uint32_t count = (num_samples > PROGRESSIVE_WINDOW) ? PROGRESSIVE_WINDOW : (uint32_t)num_samples;
+    block += num_samples - count;
+    if (estimator->fill + count > PROGRESSIVE_WINDOW) {
+        uint32_t drop = estimator->fill + count - PROGRESSIVE_WINDOW;
+        memmove(estimator->samples, &estimator->samples[drop], (estimator->fill - drop) * sizeof(float));
+        estimator->fill -= drop;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        estimator->samples[estimator->fill++] = (float)block[i] / 32768.0f;
+    }
+    if (estimator->fill < estimator->coarse_samples) {
+        return estimator->level;
+    }
+
+    uint32_t lo = estimator->min_lag;
+    uint32_t hi = estimator->max_lag;
+    if (!estimator->full_search) {
+        lo = (uint32_t)floor(estimator->lag * pow(2.0, -PROGRESSIVE_REFINE_SEMITONES / 12.0));
+        hi = (uint32_t)ceil(estimator->lag * pow(2.0, PROGRESSIVE_REFINE_SEMITONES / 12.0));
+        lo = (lo < estimator->min_lag) ? estimator->min_lag : lo;
+        hi = (hi > estimator->max_lag) ? estimator->max_lag : hi;
+    }
+    if (!nsdf_peak(estimator, lo, hi)) {
+        estimator->full_search = 1;     // Keep the last estimate, look everywhere next time
+        return estimator->level;
+    }
+    estimator->full_search = 0;
+
+    estimator->previous_frequency = estimator->frequency;
+    estimator->frequency = PROGRESSIVE_SAMPLE_RATE / estimator->lag;
+    estimator->result = analyze_tuning_table(estimator->tuning, estimator->frequency, 0);
+
+    if (estimator->fill < PROGRESSIVE_WINDOW) {
+        estimator->level = (estimator->level == PROGRESSIVE_NONE) ? PROGRESSIVE_COARSE : PROGRESSIVE_REFINING;
+    } else {
+        double change = (estimator->previous_frequency > 0.0)
+                      ? fabs(1200.0 * log2(estimator->frequency / estimator->previous_frequency)) : 1200.0;
+        int settled = (change <= PROGRESSIVE_STABLE_CENTS && estimator->clarity >= PROGRESSIVE_FINE_CLARITY);
+        estimator->level = settled ? PROGRESSIVE_FINE : PROGRESSIVE_REFINING;
+    }
+    return estimator->level;
+}
@@ -0,0 +1,129 @@
+/**
+ * progressive_estimator.h - Coarse-to-fine pitch estimate from the onset
+ *
+ * The frame pipeline says nothing until its first full window has been
+ * analyzed and the tracker has seen the same string several times. This
+ * estimator starts at the pluck and improves with every 128-sample block:
+ *
+ * 1. COARSE: as soon as two periods of the profile's lowest string have
+ *    arrived (two blocks for a guitar), a normalized autocorrelation (NSDF,
+ *    McLeod's "first peak within PROGRESSIVE_PEAK_K of the highest", which
+ *    keeps a strong second harmonic from reading an octave up) over the
+ *    whole lag range gives the note and string. Cents are only indicative.
+ *
+ * 2. REFINING: each further block re-runs the NSDF on everything gathered
+ *    so far, only over lags within PROGRESSIVE_REFINE_SEMITONES of the
+ *    previous estimate, with parabolic interpolation of the peak. Precision
+ *    grows with the number of periods in the window.
+ *
+ * 3. FINE: the window is full (PROGRESSIVE_WINDOW samples), the peak is
+ *    clear and two consecutive estimates agree within
+ *    PROGRESSIVE_STABLE_CENTS: cents can be announced.
+ *
+ *     progressive_estimator_t estimator;
+ *     progressive_init(&estimator, NULL);
+ *     ...on an onset:
+ *     progressive_reset(&estimator);
+ *     ...every block:
+ *     switch (progressive_process_block(&estimator, block, 128)) {
+ *     case PROGRESSIVE_COARSE: // announce estimator.result's string
+ *     case PROGRESSIVE_FINE:   // announce estimator.result's cents
+ *     }
+ *
+ * If the clarity of the narrowed search drops below PROGRESSIVE_MIN_CLARITY,
+ * the next block searches the whole range again, so a wrong coarse note can
+ * still be corrected while refining.
+ */
+
+#ifndef PROGRESSIVE_ESTIMATOR_H
+#define PROGRESSIVE_ESTIMATOR_H
+
+#include <stdint.h>
+#include "string_detection.h"
+#include "tuning_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define PROGRESSIVE_SAMPLE_RATE         10000   // Hz (SAMPLE_RATE)
+#define PROGRESSIVE_WINDOW              1024    // Samples for a FINE estimate (102 ms)
+#define PROGRESSIVE_MAX_LAG             511     // Longest period searched (~20 Hz)
+#define PROGRESSIVE_RANGE_BELOW         2.0     // Semitones below the lowest string searched
+#define PROGRESSIVE_RANGE_ABOVE         13.0    // Semitones above the highest (past the 12th fret)
+#define PROGRESSIVE_PEAK_K              0.9f    // First NSDF peak within this of the highest
+#define PROGRESSIVE_MIN_CLARITY         0.8f    // NSDF peak for any estimate
+#define PROGRESSIVE_FINE_CLARITY        0.9f    // NSDF peak for FINE
+#define PROGRESSIVE_REFINE_SEMITONES    2.0     // Lag search around the previous estimate
+#define PROGRESSIVE_STABLE_CENTS        2.0     // Consecutive estimates agreeing for FINE
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    PROGRESSIVE_NONE = 0,           // Not enough signal yet
+    PROGRESSIVE_COARSE,             // Note and string; cents indicative only
+    PROGRESSIVE_REFINING,           // Window filling, cents improving
+    PROGRESSIVE_FINE                // Cents-grade
+} progressive_level_t;
+
+typedef struct {
+    const tuning_table_t* tuning;
+    uint32_t min_lag;               // Lag range for the profile
+    uint32_t max_lag;
+    uint32_t coarse_samples;        // Two periods of the lowest string
+
+    /* Samples since the onset (newest last once the window is full) */
+    float samples[PROGRESSIVE_WINDOW];
+    uint32_t fill;
+
+    /* Work buffers */
+    float centered[PROGRESSIVE_WINDOW];
+    float energy[PROGRESSIVE_WINDOW + 1];       // Prefix sums of squares
+    float nsdf[PROGRESSIVE_MAX_LAG + 2];
+
+    /* Latest estimate */
+    progressive_level_t level;
+    double lag;                     // Interpolated period in samples
+    double frequency;
+    double previous_frequency;      // Estimate of the block before
+    float clarity;                 // NSDF peak (1.0 = perfectly periodic)
+    int full_search;                // Next estimate searches the whole range
+    TuningResult result;
+} progressive_estimator_t;
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/**
+ * Set the profile (lag range) and reset
+ *
+ * @param tuning: Profile, NULL for standard guitar
+ */
+void progressive_init(progressive_estimator_t* estimator, const tuning_table_t* tuning);
+
+/**
+ * Start over at a new onset (level back to PROGRESSIVE_NONE)
+ */
+void progressive_reset(progressive_estimator_t* estimator);
+
+/**
+ * Add one block and update the estimate
+ *
+ * @return Level after this block; estimator->result holds the estimate
+ *         from PROGRESSIVE_COARSE on
+ */
+progressive_level_t progressive_process_block(progressive_estimator_t* estimator, const int16_t* block,
+                                              int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROGRESSIVE_ESTIMATOR_H
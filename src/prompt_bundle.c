@@ -0,0 +1,206 @@
+/**
+ * prompt_bundle.c - Packed prompt asset bundle implementation
+ *
+ * Header and index fields are read byte-wise so the parser works on any
+ * alignment and byte order; payloads are read in place and only swapped
+ * on big-endian hosts.
+ */
+
+#include "prompt_bundle.h"
+#include <string.h>
+
+/* ============================================================================
+ * HELPERS
+ * ========================================================================== */
+
+static uint16_t read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t index_end(uint32_t entry_count) {
+    return PROMPT_BUNDLE_HEADER_SIZE + entry_count * PROMPT_BUNDLE_ENTRY_SIZE;
+}
+
+static uint32_t align_up(uint32_t offset) {
+    return (offset + PROMPT_BUNDLE_ALIGN - 1) & ~(uint32_t)(PROMPT_BUNDLE_ALIGN - 1);
+}
+
+/* ============================================================================
+ * READING
+ * ========================================================================== */
+
+prompt_bundle_error_t prompt_bundle_parse_index(const uint8_t* image, size_t size,
+                                                prompt_bundle_header_t* header,
+                                                prompt_bundle_entry_t* entries) {
+    if (image == NULL || header == NULL || entries == NULL ||
+        size < PROMPT_BUNDLE_HEADER_SIZE || memcmp(image, PROMPT_BUNDLE_MAGIC, 4) != 0) {
+        return PROMPT_BUNDLE_FORMAT_ERROR;
+    }
+    header->version = read_le16(image + 4);
+    header->entry_count = read_le16(image + 6);
+    header->sample_rate = read_le32(image + 8);
+    header->payload_bytes = read_le32(image + 12);
+
+    if (header->version != PROMPT_BUNDLE_VERSION || header->sample_rate == 0 ||
+        header->entry_count > PROMPT_BUNDLE_MAX_ENTRIES || index_end(header->entry_count) > size) {
+        return PROMPT_BUNDLE_FORMAT_ERROR;
+    }
+
+    uint64_t file_end = (uint64_t)index_end(header->entry_count) + header->payload_bytes;
+    for (uint32_t i = 0; i < header->entry_count; i++) {
+        const uint8_t* raw = image + index_end(i);
+        prompt_bundle_entry_t* entry = &entries[i];
+
+        if (memchr(raw, '\0', PROMPT_BUNDLE_NAME_LENGTH) == NULL) {
+            return PROMPT_BUNDLE_FORMAT_ERROR;      // Unterminated name
+        }
+        memcpy(entry->name, raw, PROMPT_BUNDLE_NAME_LENGTH);
+        entry->offset = read_le32(raw + 32);
+        entry->num_samples = read_le32(raw + 36);
+
+        if (entry->offset % PROMPT_BUNDLE_ALIGN != 0 || entry->offset < index_end(header->entry_count) ||
+            (uint64_t)entry->offset + 2ULL * entry->num_samples > file_end) {
+            return PROMPT_BUNDLE_FORMAT_ERROR;
+        }
+    }
+    return PROMPT_BUNDLE_OK;
+}
+
+prompt_bundle_error_t prompt_bundle_open(prompt_bundle_t* bundle, prompt_bundle_read_fn read, void* handle) {
+    uint8_t image[PROMPT_BUNDLE_INDEX_BYTES];
+
+    if (bundle == NULL || read == NULL) {
+        return PROMPT_BUNDLE_ERROR;
+    }
+    memset(bundle, 0, sizeof(*bundle));
+    bundle->read = read;
+    bundle->handle = handle;
+
+    /* Header plus the largest possible index in one read; small bundles
+       simply return fewer bytes */
+    size_t got = read(handle, 0, image, sizeof(image));
+    return prompt_bundle_parse_index(image, got, &bundle->header, bundle->entries);
+}
+
+const prompt_bundle_entry_t* prompt_bundle_find(const prompt_bundle_t* bundle, const char* name) {
+    if (bundle == NULL || name == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < bundle->header.entry_count; i++) {
+        if (strcmp(bundle->entries[i].name, name) == 0) {
+            return &bundle->entries[i];
+        }
+    }
+    return NULL;
+}
+
+prompt_bundle_error_t prompt_bundle_read_samples(const prompt_bundle_t* bundle,
+                                                 const prompt_bundle_entry_t* entry, int16_t* samples) {
+    if (bundle == NULL || entry == NULL || samples == NULL) {
+        return PROMPT_BUNDLE_ERROR;
+    }
+    size_t bytes = (size_t)entry->num_samples * sizeof(int16_t);
+    if (bundle->read(bundle->handle, entry->offset, (uint8_t*)samples, bytes) != bytes) {
+        return PROMPT_BUNDLE_FILE_ERROR;
+    }
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (uint32_t i = 0; i < entry->num_samples; i++) {
+        uint16_t v = (uint16_t)samples[i];
+        samples[i] = (int16_t)((v >> 8) | (v << 8));
+    }
+#endif
+    return PROMPT_BUNDLE_OK;
+}
+
+/* ============================================================================
+ * WRITING
+ * ========================================================================== */
+
+#ifndef __arm__
+
+static void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    put_le16(p, (uint16_t)(v & 0xFFFF));
+    put_le16(p + 2, (uint16_t)(v >> 16));
+}
+
+prompt_bundle_error_t prompt_bundle_write(FILE* out, uint32_t sample_rate, int count,
+                                          const char* const* names,
+                                          const int16_t* const* samples,
+                                          const uint32_t* num_samples) {
+    uint8_t image[PROMPT_BUNDLE_INDEX_BYTES];
+    uint8_t bytes[2 * 256];
+
+    if (out == NULL || count < 0 || count > PROMPT_BUNDLE_MAX_ENTRIES || sample_rate == 0) {
+        return PROMPT_BUNDLE_ERROR;
+    }
+
+    /* Lay out the payloads */
+    memset(image, 0, sizeof(image));
+    uint32_t offset = align_up(index_end((uint32_t)count));
+    for (int i = 0; i < count; i++) {
+        uint8_t* raw = image + index_end((uint32_t)i);
+        if (strlen(names[i]) >= PROMPT_BUNDLE_NAME_LENGTH) {
+            return PROMPT_BUNDLE_ERROR;
+        }
+        strcpy((char*)raw, names[i]);
+        put_le32(raw + 32, offset);
+        put_le32(raw + 36, num_samples[i]);
+        offset = align_up(offset + num_samples[i] * 2);
+    }
+
+    memcpy(image, PROMPT_BUNDLE_MAGIC, 4);
+    put_le16(image + 4, PROMPT_BUNDLE_VERSION);
+    put_le16(image + 6, (uint16_t)count);
+    put_le32(image + 8, sample_rate);
+    put_le32(image + 12, offset - index_end((uint32_t)count));
+
+    uint32_t position = index_end((uint32_t)count);
+    if (fwrite(image, 1, position, out) != position) {
+        return PROMPT_BUNDLE_FILE_ERROR;
+    }
+
+    for (int i = 0; i < count; i++) {
+        uint32_t start = read_le32(image + index_end((uint32_t)i) + 32);
+        for (; position < start; position++) {
+            fputc(0, out);                  // Alignment padding
+        }
+        for (uint32_t done = 0; done < num_samples[i]; ) {
+            uint32_t chunk = num_samples[i] - done;
+            if (chunk > 256) {
+                chunk = 256;
+            }
+            for (uint32_t k = 0; k < chunk; k++) {
+                put_le16(bytes + 2 * k, (uint16_t)samples[i][done + k]);
+            }
+            if (fwrite(bytes, 2, chunk, out) != chunk) {
+                return PROMPT_BUNDLE_FILE_ERROR;
+            }
+            done += chunk;
+        }
+        position += num_samples[i] * 2;
+    }
+    for (; position < offset; position++) {
+        fputc(0, out);
+    }
+    return ferror(out) ? PROMPT_BUNDLE_FILE_ERROR : PROMPT_BUNDLE_OK;
+}
+
+size_t prompt_bundle_read_stdio(void* handle, uint32_t offset, uint8_t* buffer, size_t bytes) {
+    FILE* file = (FILE*)handle;
+    if (fseek(file, (long)offset, SEEK_SET) != 0) {
+        return 0;
+    }
+    return fread(buffer, 1, bytes, file);
+}
+
+#endif // __arm__
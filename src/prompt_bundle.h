@@ -0,0 +1,138 @@
+/**
+ * prompt_bundle.h - Packed prompt asset bundle
+ *
+ * All feedback prompts live in one file instead of one WAV each, so startup
+ * is one open plus one index read and every prompt is one sequential read
+ * straight into its destination buffer.
+ *
+ * Layout (all fields little-endian):
+ *
+ *     offset 0    header      32 bytes  (prompt_bundle_header_t)
+ *     offset 32   index       entry_count x 40 bytes (prompt_bundle_entry_t)
+ *     ...         payloads    mono int16 PCM at header.sample_rate, each
+ *                             starting on a PROMPT_BUNDLE_ALIGN boundary
+ *
+ * Bundles are built natively by tools/prompt_packer from a folder of WAVs.
+ */
+
+#ifndef PROMPT_BUNDLE_H
+#define PROMPT_BUNDLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * FORMAT
+ * ========================================================================== */
+
+#define PROMPT_BUNDLE_MAGIC         "TPRB"
+#define PROMPT_BUNDLE_VERSION       1
+#define PROMPT_BUNDLE_HEADER_SIZE   32
+#define PROMPT_BUNDLE_ENTRY_SIZE    40
+#define PROMPT_BUNDLE_NAME_LENGTH   32      // Including the terminator
+#define PROMPT_BUNDLE_ALIGN         32      // Payload alignment (cache line / DMA burst)
+#define PROMPT_BUNDLE_MAX_ENTRIES   32
+#define PROMPT_BUNDLE_INDEX_BYTES   (PROMPT_BUNDLE_HEADER_SIZE + PROMPT_BUNDLE_MAX_ENTRIES * PROMPT_BUNDLE_ENTRY_SIZE)
+
+typedef enum {
+    PROMPT_BUNDLE_OK = 0,
+    PROMPT_BUNDLE_ERROR = -1,           // Bad arguments
+    PROMPT_BUNDLE_FILE_ERROR = -2,      // Short read or write
+    PROMPT_BUNDLE_FORMAT_ERROR = -3     // Bad magic, version or index
+} prompt_bundle_error_t;
+
+typedef struct {
+    uint16_t version;
+    uint16_t entry_count;
+    uint32_t sample_rate;
+    uint32_t payload_bytes;             // Bytes after the index, padding included
+} prompt_bundle_header_t;
+
+typedef struct {
+    char name[PROMPT_BUNDLE_NAME_LENGTH];
+    uint32_t offset;                    // From the start of the file, aligned
+    uint32_t num_samples;
+} prompt_bundle_entry_t;
+
+/**
+ * Positioned read: copy up to `bytes` from file offset `offset`
+ *
+ * @return Bytes copied
+ */
+typedef size_t (*prompt_bundle_read_fn)(void* handle, uint32_t offset, uint8_t* buffer, size_t bytes);
+
+typedef struct {
+    prompt_bundle_read_fn read;
+    void* handle;
+    prompt_bundle_header_t header;
+    prompt_bundle_entry_t entries[PROMPT_BUNDLE_MAX_ENTRIES];
+} prompt_bundle_t;
+
+/* ============================================================================
+ * READING
+ * ========================================================================== */
+
+/**
+ * Parse a header plus index image (the first PROMPT_BUNDLE_INDEX_BYTES of the file)
+ *
+ * @param size: Bytes available in `image` (may be less for small bundles)
+ * @return PROMPT_BUNDLE_OK or PROMPT_BUNDLE_FORMAT_ERROR
+ */
+prompt_bundle_error_t prompt_bundle_parse_index(const uint8_t* image, size_t size,
+                                                prompt_bundle_header_t* header,
+                                                prompt_bundle_entry_t* entries);
+
+/**
+ * Read and validate the header and index with a single read
+ */
+prompt_bundle_error_t prompt_bundle_open(prompt_bundle_t* bundle, prompt_bundle_read_fn read, void* handle);
+
+/**
+ * @return Index entry for `name`, or NULL
+ */
+const prompt_bundle_entry_t* prompt_bundle_find(const prompt_bundle_t* bundle, const char* name);
+
+/**
+ * Read one prompt's samples with a single sequential read
+ *
+ * @param samples: Destination, entry->num_samples long
+ */
+prompt_bundle_error_t prompt_bundle_read_samples(const prompt_bundle_t* bundle,
+                                                 const prompt_bundle_entry_t* entry, int16_t* samples);
+
+/* ============================================================================
+ * WRITING (native only)
+ * ========================================================================== */
+
+#ifndef __arm__
+
+#include <stdio.h>
+
+/**
+ * Write a complete bundle
+ *
+ * @param names / samples / num_samples: One element per prompt
+ * @return PROMPT_BUNDLE_OK, PROMPT_BUNDLE_ERROR (too many or bad names)
+ *         or PROMPT_BUNDLE_FILE_ERROR
+ */
+prompt_bundle_error_t prompt_bundle_write(FILE* out, uint32_t sample_rate, int count,
+                                          const char* const* names,
+                                          const int16_t* const* samples,
+                                          const uint32_t* num_samples);
+
+/**
+ * Positioned read callback for stdio streams (handle = FILE*)
+ */
+size_t prompt_bundle_read_stdio(void* handle, uint32_t offset, uint8_t* buffer, size_t bytes);
+
+#endif // __arm__
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROMPT_BUNDLE_H
@@ -0,0 +1,396 @@
+/**
+ * prompt_cache.c - RAM-resident feedback prompts implementation
+ *
+ * Clips are packed back to back into one static pool; nothing is freed
+ * until prompt_cache_init(). Playback hands playlists from the main loop to
+ * the audio update through a single atomic pointer, so no lock is needed.
+ */
+
+#include "prompt_cache.h"
+#include "prompt_bundle.h"
+#include "audio_sequencer.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ========================================================================== */
+
+#ifdef __INCLUDE_TEENSY_LIBS__
+#define PROMPT_POOL_MEMORY EXTMEM       // External PSRAM
+#else
+#define PROMPT_POOL_MEMORY
+#endif
+
+static PROMPT_POOL_MEMORY int16_t prompt_pool[PROMPT_CACHE_POOL_SAMPLES] __attribute__((aligned(PROMPT_BUNDLE_ALIGN)));
+static uint32_t pool_used = 0;
+
+static prompt_clip_t clips[PROMPT_CACHE_MAX_CLIPS];
+static int num_clips = 0;
+
+/* Main loop -> audio update handoff: NULL = no request, an empty playlist = stop.
+   The main loop fills the slot it did not post last; the audio update copies a
+   posted playlist out at the start of a block, before the main loop can run again */
+static prompt_playlist_t request_slots[2];
+static int next_slot = 0;
+static const prompt_playlist_t stop_request;
+static const prompt_playlist_t* pending_request = NULL;
+
+/* Owned by the audio update */
+static prompt_playlist_t active_list;
+static volatile int active_index = -1;      // -1 = idle
+static uint32_t play_position = 0;
+static uint32_t fade_length = 0;            // Tail of the current clip overlapped with the next
+
+/* Every prompt the sequencer or the firmware can ask for */
+static const char* const default_prompts[] = {
+    FILE_E, FILE_A, FILE_D, FILE_G, FILE_B,
+    FILE_UP, FILE_DOWN, FILE_IN_TUNE, FILE_10_CENTS, FILE_20_CENTS,
+    AUDIO_FILE_E_STRING, AUDIO_FILE_B_STRING, AUDIO_FILE_G_STRING,
+    AUDIO_FILE_D_STRING, AUDIO_FILE_A_STRING,
+    AUDIO_FILE_10_CENTS, AUDIO_FILE_20_CENTS,
+    AUDIO_FILE_TUNE_UP, AUDIO_FILE_TUNE_DOWN, AUDIO_FILE_IN_TUNE
+};
+
+#define NUM_DEFAULT_PROMPTS (sizeof(default_prompts) / sizeof(default_prompts[0]))
+
+/* ============================================================================
+ * LOADING
+ * ========================================================================== */
+
+void prompt_cache_init(void) {
+    prompt_cache_stop();
+    active_index = -1;
+    play_position = 0;
+    fade_length = 0;
+    pool_used = 0;
+    num_clips = 0;
+    memset(clips, 0, sizeof(clips));
+}
+
+static prompt_clip_t* find_slot(const char* name) {
+    for (int i = 0; i < num_clips; i++) {
+        if (strcmp(clips[i].name, name) == 0) {
+            return &clips[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Point `name` at samples just placed at the end of the pool
+ * Caller has checked that a slot is free or the name exists
+ */
+static void register_clip(const char* name, uint32_t start, uint32_t num_samples) {
+    prompt_clip_t* clip = find_slot(name);
+    if (clip == NULL) {
+        clip = &clips[num_clips++];
+        strcpy(clip->name, name);
+    }
+    clip->samples = &prompt_pool[start];
+    clip->num_samples = num_samples;
+    pool_used = start + num_samples;
+}
+
+prompt_cache_error_t prompt_cache_load(const char* name, wav_read_fn read, void* handle) {
+    static wav_decoder_t decoder;       // ~2.5 KB - keep it off the stack
+
+    if (name == NULL || read == NULL || strlen(name) >= PROMPT_CACHE_NAME_LENGTH) {
+        return PROMPT_CACHE_ERROR;
+    }
+    if (find_slot(name) == NULL && num_clips == PROMPT_CACHE_MAX_CLIPS) {
+        return PROMPT_CACHE_FULL;
+    }
+    if (wav_decoder_open(&decoder, read, handle) != WAV_OK) {
+        return PROMPT_CACHE_FORMAT_ERROR;
+    }
+    wav_decoder_set_output_rate(&decoder, PROMPT_CACHE_SAMPLE_RATE);
+
+    /* Decode straight into the free end of the pool */
+    uint32_t space = PROMPT_CACHE_POOL_SAMPLES - pool_used;
+    uint32_t decoded = wav_decoder_read_int16(&decoder, &prompt_pool[pool_used], space);
+    if (decoded == space) {
+        int16_t probe;
+        if (wav_decoder_read_int16(&decoder, &probe, 1) != 0) {
+            return PROMPT_CACHE_FULL;   // Clip does not fit - pool left as it was
+        }
+    }
+
+    register_clip(name, pool_used, decoded);
+    return PROMPT_CACHE_OK;
+}
+
+#ifdef __INCLUDE_TEENSY_LIBS__
+static size_t sd_prompt_read(void* handle, uint8_t* buffer, size_t bytes) {
+    int got = sd_file_read((sd_file_t*)handle, buffer, (int)bytes);
+    return (got > 0) ? (size_t)got : 0;
+}
+
+static size_t sd_bundle_read(void* handle, uint32_t offset, uint8_t* buffer, size_t bytes) {
+    if (!sd_file_seek((sd_file_t*)handle, offset)) {
+        return 0;
+    }
+    return sd_prompt_read(handle, buffer, bytes);
+}
+#endif
+
+prompt_cache_error_t prompt_cache_load_file(const char* name, const char* root) {
+    char path[MAX_FILENAME_LENGTH];
+
+    if (name == NULL || root == NULL ||
+        snprintf(path, sizeof(path), "%s%s", root, name) >= (int)sizeof(path)) {
+        return PROMPT_CACHE_ERROR;
+    }
+
+#ifdef __INCLUDE_TEENSY_LIBS__
+    sd_file_t* file = sd_open(path);
+    if (file == NULL) {
+        return PROMPT_CACHE_FILE_ERROR;
+    }
+    prompt_cache_error_t err = prompt_cache_load(name, sd_prompt_read, file);
+    sd_file_close(file);
+    return err;
+#elif !defined(__arm__)
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return PROMPT_CACHE_FILE_ERROR;
+    }
+    prompt_cache_error_t err = prompt_cache_load(name, wav_read_stdio, file);
+    fclose(file);
+    return err;
+#else
+    return PROMPT_CACHE_FILE_ERROR;
+#endif
+}
+
+int prompt_cache_load_defaults(const char* root) {
+    int loaded = 0;
+
+    for (size_t i = 0; i < NUM_DEFAULT_PROMPTS; i++) {
+        if (prompt_cache_find(default_prompts[i]) != NULL) {
+            loaded++;       // Already cached
+            continue;
+        }
+        prompt_cache_error_t err = prompt_cache_load_file(default_prompts[i], root);
+        if (err == PROMPT_CACHE_OK) {
+            loaded++;
+        } else if (err != PROMPT_CACHE_FILE_ERROR) {
+            printf("WARNING: Prompt %s not cached (error %d)\n", default_prompts[i], err);
+        }
+    }
+    printf("Prompt cache: %d clips, %lu/%lu samples\n", loaded,
+           (unsigned long)pool_used, (unsigned long)PROMPT_CACHE_POOL_SAMPLES);
+    return loaded;
+}
+
+/**
+ * Copy every bundle entry into the pool, one read per prompt
+ */
+static int load_bundle_entries(const prompt_bundle_t* bundle) {
+    const uint32_t align = PROMPT_BUNDLE_ALIGN / sizeof(int16_t);
+    int loaded = 0;
+
+    if (bundle->header.sample_rate != PROMPT_CACHE_SAMPLE_RATE) {
+        return PROMPT_CACHE_FORMAT_ERROR;
+    }
+    for (uint32_t i = 0; i < bundle->header.entry_count; i++) {
+        const prompt_bundle_entry_t* entry = &bundle->entries[i];
+        uint32_t start = (pool_used + align - 1) / align * align;   // Keep DMA alignment
+
+        if (strlen(entry->name) >= PROMPT_CACHE_NAME_LENGTH ||
+            (find_slot(entry->name) == NULL && num_clips == PROMPT_CACHE_MAX_CLIPS) ||
+            start > PROMPT_CACHE_POOL_SAMPLES || entry->num_samples > PROMPT_CACHE_POOL_SAMPLES - start) {
+            printf("WARNING: Prompt %s not cached (error %d)\n", entry->name, PROMPT_CACHE_FULL);
+            continue;
+        }
+        if (prompt_bundle_read_samples(bundle, entry, &prompt_pool[start]) != PROMPT_BUNDLE_OK) {
+            return PROMPT_CACHE_FILE_ERROR;
+        }
+        register_clip(entry->name, start, entry->num_samples);
+        loaded++;
+    }
+    return loaded;
+}
+
+int prompt_cache_load_bundle(const char* path) {
+    static prompt_bundle_t bundle;
+    int result;
+
+    if (path == NULL) {
+        return PROMPT_CACHE_ERROR;
+    }
+
+#ifdef __INCLUDE_TEENSY_LIBS__
+    sd_file_t* file = sd_open(path);
+    if (file == NULL) {
+        return PROMPT_CACHE_FILE_ERROR;
+    }
+    result = (prompt_bundle_open(&bundle, sd_bundle_read, file) == PROMPT_BUNDLE_OK)
+        ? load_bundle_entries(&bundle) : PROMPT_CACHE_FORMAT_ERROR;
+    sd_file_close(file);
+#elif !defined(__arm__)
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return PROMPT_CACHE_FILE_ERROR;
+    }
+    result = (prompt_bundle_open(&bundle, prompt_bundle_read_stdio, file) == PROMPT_BUNDLE_OK)
+        ? load_bundle_entries(&bundle) : PROMPT_CACHE_FORMAT_ERROR;
+    fclose(file);
+#else
+    (void)bundle;
+    result = PROMPT_CACHE_FILE_ERROR;
+#endif
+
+    if (result >= 0) {
+        printf("Prompt cache: %d clips from %s, %lu/%lu samples\n", result, path,
+               (unsigned long)pool_used, (unsigned long)PROMPT_CACHE_POOL_SAMPLES);
+    }
+    return result;
+}
+
+int prompt_cache_load_startup(const char* bundle_path, const char* root) {
+    prompt_cache_init();
+    if (prompt_cache_load_bundle(bundle_path != NULL ? bundle_path : AUDIO_PROMPT_BUNDLE) < 0) {
+        printf("Prompt cache: no usable bundle, loading loose prompts\n");
+    }
+    prompt_cache_load_defaults(root);     // Skips what the bundle brought
+    return num_clips;
+}
+
+int prompt_cache_count(void) {
+    return num_clips;
+}
+
+const prompt_clip_t* prompt_cache_clip(int index) {
+    return (index >= 0 && index < num_clips) ? &clips[index] : NULL;
+}
+
+const prompt_clip_t* prompt_cache_find(const char* name) {
+    if (name == NULL) {
+        return NULL;
+    }
+    return find_slot(name);
+}
+
+uint32_t prompt_cache_pool_used(void) {
+    return pool_used;
+}
+
+/* ============================================================================
+ * PLAYBACK
+ * ========================================================================== */
+
+bool prompt_cache_play_list(const char* const* names, int count, uint32_t crossfade_samples,
+                            prompt_done_fn done, void* context) {
+    if (names == NULL || count <= 0 || count > PROMPT_PLAYLIST_MAX_CLIPS) {
+        return false;
+    }
+    prompt_playlist_t* list = &request_slots[next_slot];
+    for (int i = 0; i < count; i++) {
+        list->clips[i] = prompt_cache_find(names[i]);
+        if (list->clips[i] == NULL) {
+            return false;           // All or nothing - caller falls back to files
+        }
+    }
+    list->count = count;
+    list->crossfade = (crossfade_samples < PROMPT_PLAYLIST_MAX_FADE) ? crossfade_samples : PROMPT_PLAYLIST_MAX_FADE;
+    list->done = done;
+    list->context = context;
+
+    next_slot ^= 1;
+    __atomic_store_n(&pending_request, list, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool prompt_cache_play(const char* name) {
+    return prompt_cache_play_list(&name, 1, 0, NULL, NULL);
+}
+
+void prompt_cache_stop(void) {
+    __atomic_store_n(&pending_request, &stop_request, __ATOMIC_RELEASE);
+}
+
+bool prompt_cache_is_playing(void) {
+    const prompt_playlist_t* request = __atomic_load_n(&pending_request, __ATOMIC_ACQUIRE);
+    return (request != NULL && request != &stop_request) || active_index >= 0;
+}
+
+/**
+ * Make clip `index` of the active playlist current, `start` samples in
+ * (the part already heard in the crossfade), and size its own fade-out
+ */
+static void start_clip(int index, uint32_t start) {
+    const prompt_clip_t* clip = active_list.clips[index];
+
+    active_index = index;
+    play_position = start;
+    fade_length = 0;
+    if (index + 1 < active_list.count) {
+        const prompt_clip_t* next = active_list.clips[index + 1];
+        fade_length = active_list.crossfade;
+        if (fade_length > clip->num_samples - start) {
+            fade_length = clip->num_samples - start;
+        }
+        if (fade_length > next->num_samples / 2) {
+            fade_length = next->num_samples / 2;    // Leave room for its own fade-out
+        }
+        __builtin_prefetch(next->samples);          // Pull the next head into cache now
+    }
+}
+
+uint32_t prompt_cache_render(int16_t* output, uint32_t num_samples) {
+    /* Take the newest request at the block boundary */
+    const prompt_playlist_t* request = __atomic_exchange_n(&pending_request, NULL, __ATOMIC_ACQUIRE);
+    if (request != NULL) {
+        active_index = -1;
+        if (request != &stop_request) {
+            active_list = *request;
+            start_clip(0, 0);
+        }
+    }
+
+    uint32_t written = 0;
+    while (active_index >= 0) {
+        const prompt_clip_t* clip = active_list.clips[active_index];
+        uint32_t fade_start = clip->num_samples - fade_length;
+
+        if (play_position == clip->num_samples) {
+            /* Clip finished: splice the next one in on the very next sample */
+            if (active_index + 1 < active_list.count) {
+                start_clip(active_index + 1, fade_length);
+            } else {
+                active_index = -1;
+                if (active_list.done != NULL) {
+                    active_list.done(active_list.context);
+                }
+            }
+            continue;
+        }
+        if (written == num_samples) {
+            break;
+        }
+        if (play_position < fade_start) {
+            /* Plain copy up to the fade (or the end of the clip) */
+            uint32_t count = fade_start - play_position;
+            if (count > num_samples - written) {
+                count = num_samples - written;
+            }
+            memcpy(output + written, clip->samples + play_position, count * sizeof(int16_t));
+            play_position += count;
+            written += count;
+            continue;
+        }
+
+        /* Linear crossfade into the head of the next clip */
+        const int16_t* next = active_list.clips[active_index + 1]->samples;
+        for (; play_position < clip->num_samples && written < num_samples; play_position++) {
+            uint32_t k = play_position - fade_start;
+            int32_t mixed = ((int32_t)clip->samples[play_position] * (int32_t)(fade_length - k) +
+                             (int32_t)next[k] * (int32_t)k) / (int32_t)fade_length;
+            output[written++] = (int16_t)mixed;
+        }
+    }
+    memset(output + written, 0, (num_samples - written) * sizeof(int16_t));
+    return written;
+}
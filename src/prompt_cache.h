@@ -0,0 +1,190 @@
+/**
+ * prompt_cache.h - RAM-resident feedback prompts
+ *
+ * The spoken feedback clips (FILE_* from audio_sequencer.h and AUDIO_FILE_*
+ * from config.h) are decoded once at startup into a single sample pool
+ * (PSRAM on the Teensy) so the sequencer never touches the SD card and never
+ * blocks while the tuner is running:
+ *
+ *     prompt_cache_load_startup(NULL, "");   // init_audio_system(): bundle, then loose WAVs
+ *     ...
+ *     prompt_cache_play_list(phrase, 3, 0, on_done, NULL);   // Main loop: returns at once
+ *     ...
+ *     prompt_cache_render(block, 128);       // Audio update, every block
+ *
+ * prompt_cache_play() and prompt_cache_play_list() only post a request; the
+ * audio update picks it up at the start of its next block, so a prompt starts
+ * within one block (2.9 ms at 44.1 kHz) of the tuning decision.
+ */
+
+#ifndef PROMPT_CACHE_H
+#define PROMPT_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "wav_decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define PROMPT_CACHE_SAMPLE_RATE    44100   // Playback rate (Teensy audio library)
+#define PROMPT_CACHE_MAX_CLIPS      16
+#define PROMPT_CACHE_NAME_LENGTH    32
+#define PROMPT_CACHE_POOL_SECONDS   12      // ~1 MB of int16 in PSRAM
+#define PROMPT_CACHE_POOL_SAMPLES   (PROMPT_CACHE_SAMPLE_RATE * PROMPT_CACHE_POOL_SECONDS)
+#define PROMPT_PLAYLIST_MAX_CLIPS   8       // Longest phrase queued at once
+#define PROMPT_PLAYLIST_MAX_FADE    32768   // Longest crossfade (~0.74 s); keeps the int32 mix in range
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    PROMPT_CACHE_OK = 0,
+    PROMPT_CACHE_ERROR = -1,            // Bad arguments
+    PROMPT_CACHE_FILE_ERROR = -2,       // File missing or unreadable
+    PROMPT_CACHE_FORMAT_ERROR = -3,     // Not a decodable WAV
+    PROMPT_CACHE_FULL = -4              // Out of clip slots or pool space
+} prompt_cache_error_t;
+
+typedef struct {
+    char name[PROMPT_CACHE_NAME_LENGTH];    // Lookup key, e.g. FILE_E
+    const int16_t* samples;                 // Mono, PROMPT_CACHE_SAMPLE_RATE
+    uint32_t num_samples;
+} prompt_clip_t;
+
+/**
+ * Playlist finished (called from the audio update - keep it short)
+ */
+typedef void (*prompt_done_fn)(void* context);
+
+typedef struct {
+    const prompt_clip_t* clips[PROMPT_PLAYLIST_MAX_CLIPS];
+    int count;
+    uint32_t crossfade;                     // Overlap between clips, 0 = butt splice
+    prompt_done_fn done;
+    void* context;
+} prompt_playlist_t;
+
+/* ============================================================================
+ * LOADING (startup)
+ * ========================================================================== */
+
+/**
+ * Drop all clips and stop playback
+ */
+void prompt_cache_init(void);
+
+/**
+ * Decode one WAV stream into the pool under `name`
+ * Any format wav_decoder handles; resampled to PROMPT_CACHE_SAMPLE_RATE
+ * Loading a name again replaces the lookup (the old samples stay allocated)
+ */
+prompt_cache_error_t prompt_cache_load(const char* name, wav_read_fn read, void* handle);
+
+/**
+ * Load `name` from the file root + name (SD card on the Teensy, stdio natively)
+ */
+prompt_cache_error_t prompt_cache_load_file(const char* name, const char* root);
+
+/**
+ * Load every known feedback prompt found under `root`
+ * Missing files are skipped - the sequencer falls back to play_audio_file()
+ *
+ * @return Number of clips cached
+ */
+int prompt_cache_load_defaults(const char* root);
+
+/**
+ * Load every prompt from a bundle built by tools/prompt_packer
+ * One open, one index read and one read per prompt; payloads keep their
+ * PROMPT_BUNDLE_ALIGN alignment in the pool
+ *
+ * @return Number of clips cached, or a negative prompt_cache_error_t
+ */
+int prompt_cache_load_bundle(const char* path);
+
+/**
+ * Startup load: drop all clips, load the bundle, then any known prompt it
+ * lacks from a loose WAV under `root` (a missing or damaged bundle leaves
+ * only the loose files)
+ *
+ * @param bundle_path: Packed prompts, NULL for AUDIO_PROMPT_BUNDLE
+ * @return Number of clips cached
+ */
+int prompt_cache_load_startup(const char* bundle_path, const char* root);
+
+/**
+ * @return Number of cached clips
+ */
+int prompt_cache_count(void);
+
+/**
+ * @return Clip by position (0 .. prompt_cache_count() - 1), or NULL
+ */
+const prompt_clip_t* prompt_cache_clip(int index);
+
+/**
+ * @return Cached clip, or NULL
+ */
+const prompt_clip_t* prompt_cache_find(const char* name);
+
+/**
+ * @return Pool samples in use
+ */
+uint32_t prompt_cache_pool_used(void);
+
+/* ============================================================================
+ * PLAYBACK (non-blocking)
+ * ========================================================================== */
+
+/**
+ * Start a cached clip, cutting off the current one
+ *
+ * @return false if `name` is not cached
+ */
+bool prompt_cache_play(const char* name);
+
+/**
+ * Queue a whole phrase, cutting off whatever is playing
+ * Clips follow each other at sample accuracy inside the audio update, with
+ * no main-loop polling between them: butt-spliced, or overlapped by a linear
+ * crossfade of `crossfade_samples` (clamped to the clip lengths and to
+ * PROMPT_PLAYLIST_MAX_FADE). The next clip is resolved and prefetched while
+ * the current one plays.
+ *
+ * @param done: Called once after the last sample, or NULL; not called if the
+ *              phrase is cut off by another play or a stop
+ * @return false (nothing queued) if any name is not cached
+ */
+bool prompt_cache_play_list(const char* const* names, int count, uint32_t crossfade_samples,
+                            prompt_done_fn done, void* context);
+
+/**
+ * Stop at the next block boundary
+ */
+void prompt_cache_stop(void);
+
+/**
+ * @return true while a clip is playing or waiting for the next block
+ */
+bool prompt_cache_is_playing(void);
+
+/**
+ * Produce the next output block (audio update / interrupt context)
+ * Silence is written once the playlist ends
+ *
+ * @return Samples of prompt audio written (the rest is zero)
+ */
+uint32_t prompt_cache_render(int16_t* output, uint32_t num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROMPT_CACHE_H
@@ -1,12 +1,175 @@
 //*************tuner audio filtering functions**************** */
 
+#include <stddef.h>
+#include <math.h>
+#include "signal_processing.h"
+
 
 //harmonic product spectrum (prevents detecting harmonics as the target note)
 
 
 //parabolic interpolation(detects small note changes)
+float parabolic_peak_offset(const float* magnitude, uint32_t num_bins, uint32_t bin) {
+	if (magnitude == NULL || bin == 0 || bin + 1 >= num_bins) {
+		return 0.0f;
+	}
+	// log magnitude makes the Hann main lobe close to a parabola (Gaussian fit)
+	float left = logf(magnitude[bin - 1] + 1e-12f);
+	float centre = logf(magnitude[bin] + 1e-12f);
+	float right = logf(magnitude[bin + 1] + 1e-12f);
+	float denominator = left - 2.0f * centre + right;
+	if (denominator >= 0.0f) {
+		return 0.0f;	// not a local maximum
+	}
+	float offset = 0.5f * (left - right) / denominator;
+	if (offset > 0.5f) {
+		offset = 0.5f;
+	} else if (offset < -0.5f) {
+		offset = -0.5f;
+	}
+	return offset;
+}
+
+
+//top-k spectral peaks (polyphonic analysis, tracking, harmonic checks)
+uint32_t spectral_peaks_top_k(const float* magnitude, const float* re, const float* im, uint32_t num_bins,
+                              const spectral_peak_search_t* search, spectral_peak_t* peaks, uint32_t max_peaks) {
+	if (magnitude == NULL || search == NULL || peaks == NULL || max_peaks == 0 || num_bins < 3) {
+		return 0;
+	}
+	uint32_t first = (search->first_bin < 1) ? 1 : search->first_bin;
+	uint32_t last = (search->last_bin > num_bins - 2) ? num_bins - 2 : search->last_bin;
+
+	// single pass: local maxima into a magnitude-sorted array, strongest tracked on the way
+	uint32_t count = 0;
+	float strongest = 0.0f;
+	for (uint32_t k = first; k <= last; k++) {
+		float m = magnitude[k];
+		if (m > strongest) {
+			strongest = m;
+		}
+		if (m < search->floor || m <= magnitude[k - 1] || m < magnitude[k + 1]) {
+			continue;
+		}
+		if (count == max_peaks && m <= peaks[count - 1].magnitude) {
+			continue;
+		}
+		uint32_t i = (count < max_peaks) ? count++ : count - 1;
+		while (i > 0 && peaks[i - 1].magnitude < m) {
+			peaks[i] = peaks[i - 1];
+			i--;
+		}
+		peaks[i].bin = k;
+		peaks[i].magnitude = m;
+	}
+
+	// adaptive threshold on the survivors, then refine them
+	float threshold = strongest * search->relative;
+	while (count > 0 && peaks[count - 1].magnitude < threshold) {
+		count--;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t k = peaks[i].bin;
+		float offset = parabolic_peak_offset(magnitude, num_bins, k);
+		float left = logf(magnitude[k - 1] + 1e-12f);
+		float right = logf(magnitude[k + 1] + 1e-12f);
+		peaks[i].magnitude = expf(logf(magnitude[k] + 1e-12f) - 0.25f * (left - right) * offset);
+		peaks[i].frequency = ((float)k + offset) * search->bin_hz;
+		peaks[i].phase = (re != NULL && im != NULL) ? atan2f(im[k], re[k]) : 0.0f;
+	}
+	return count;
+}
+
 
 
+//goertzel probe (one frequency, any position between bins)
+float goertzel_power(const float* samples, uint32_t num_samples, double cycles_per_sample) {
+	if (samples == NULL || num_samples == 0) {
+		return 0.0f;
+	}
+	const double coeff = 2.0 * cos(2.0 * 3.14159265358979323846 * cycles_per_sample);
+	double s1 = 0.0;
+	double s2 = 0.0;
+	for (uint32_t n = 0; n < num_samples; n++) {
+		double s0 = samples[n] + coeff * s1 - s2;
+		s2 = s1;
+		s1 = s0;
+	}
+	return (float)(s1 * s1 + s2 * s2 - coeff * s1 * s2);
+}
+
+
+//golden-section refinement (cents-level frequency from a coarse bin)
+double golden_section_peak(const float* samples, uint32_t num_samples, double sample_rate,
+                           double low_hz, double high_hz, uint32_t probes) {
+	const double ratio = 0.6180339887498949;	// 1 / golden ratio
+	if (samples == NULL || sample_rate <= 0.0 || high_hz <= low_hz || probes < 2) {
+		return 0.5 * (low_hz + high_hz);
+	}
+
+	double a = low_hz;
+	double b = high_hz;
+	double x1 = b - ratio * (b - a);
+	double x2 = a + ratio * (b - a);
+	float p1 = goertzel_power(samples, num_samples, x1 / sample_rate);
+	float p2 = goertzel_power(samples, num_samples, x2 / sample_rate);
+
+	// each step keeps the side holding the larger probe and reuses it
+	for (uint32_t i = 2; i < probes; i++) {
+		if (p1 >= p2) {
+			b = x2;
+			x2 = x1;
+			p2 = p1;
+			x1 = b - ratio * (b - a);
+			p1 = goertzel_power(samples, num_samples, x1 / sample_rate);
+		} else {
+			a = x1;
+			x1 = x2;
+			p1 = p2;
+			x2 = a + ratio * (b - a);
+			p2 = goertzel_power(samples, num_samples, x2 / sample_rate);
+		}
+	}
+	if (p1 >= p2) {
+		b = x2;
+	} else {
+		a = x1;
+	}
+	return 0.5 * (a + b);
+}
+
 //harmonic validation (filters out non-music noise)
+float harmonic_validation_score(const float* samples, uint32_t num_samples, double sample_rate, double f0) {
+	if (samples == NULL || num_samples < 2 || sample_rate <= 0.0 || f0 <= 0.0) {
+		return 0.0f;
+	}
+
+	float frame_energy = 0.0f;
+	for (uint32_t n = 0; n < num_samples; n++) {
+		frame_energy += samples[n] * samples[n];
+	}
+	if (frame_energy <= 0.0f) {
+		return 0.0f;
+	}
 
+	// valley h lies midway below partial h; valleys are shared by neighbours
+	float valley_below = goertzel_power(samples, num_samples, 0.5 * f0 / sample_rate);
+	float line_power = 0.0f;
+	for (uint32_t h = 1; h <= HARMONIC_VALIDATION_PARTIALS; h++) {
+		double centre = h * f0;
+		if (centre + 0.5 * f0 >= 0.5 * sample_rate) {
+			break;
+		}
+		float peak = goertzel_power(samples, num_samples, centre / sample_rate);
+		float valley_above = goertzel_power(samples, num_samples, (centre + 0.5 * f0) / sample_rate);
+		float valley = 0.5f * (valley_below + valley_above);
+		if (peak > HARMONIC_VALIDATION_VALLEY_RATIO * valley) {
+			line_power += peak - HARMONIC_VALIDATION_VALLEY_RATIO * valley;
+		}
+		valley_below = valley_above;
+	}
 
+	// a Hann-windowed sinusoid of energy E peaks at |X|^2 = E * N / 3
+	float score = 3.0f * line_power / ((float)num_samples * frame_energy);
+	return (score > 1.0f) ? 1.0f : score;
+}
@@ -0,0 +1,150 @@
+/**
+ * signal_processing.h - Spectral post-processing for the tuner
+ *
+ * Stages that run after the FFT peak search, on the magnitude spectrum or
+ * the windowed frame: parabolic interpolation, top-K peak extraction,
+ * Goertzel refinement and harmonic validation.
+ */
+
+#ifndef SIGNAL_PROCESSING_H
+#define SIGNAL_PROCESSING_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HARMONIC_VALIDATION_PARTIALS    6       /* Partials checked (k * f0, k = 1..6) */
+#define HARMONIC_VALIDATION_VALLEY_RATIO 4.0f   /* Partial power discounted by this many valleys */
+#define HARMONIC_CONFIDENCE_MIN         0.5f    /* Frames below this are not music */
+
+/**
+ * Parabolic interpolation (detects small note changes)
+ *
+ * Fits a parabola through the log magnitudes of a peak bin and its two
+ * neighbours; for a Hann-windowed sinusoid this places the true frequency
+ * within a few hundredths of a bin instead of +/-0.5 bin.
+ *
+ * @param magnitude: Magnitude spectrum
+ * @param num_bins: Number of bins in the spectrum
+ * @param bin: Local maximum (1 .. num_bins - 2)
+ * @return: Offset of the true peak from `bin` in bins, in [-0.5, 0.5]
+ */
+float parabolic_peak_offset(const float* magnitude, uint32_t num_bins, uint32_t bin);
+
+/**
+ * One spectral peak (see spectral_peaks_top_k)
+ */
+typedef struct {
+	float frequency;	/* Hz, with sub-bin interpolation */
+	float magnitude;	/* Interpolated peak magnitude */
+	float phase;		/* Radians at the peak bin; 0 without complex input */
+	uint32_t bin;		/* Local-maximum bin */
+} spectral_peak_t;
+
+/**
+ * Where and how strict spectral_peaks_top_k() searches
+ */
+typedef struct {
+	uint32_t first_bin;	/* Lowest bin considered (>= 1) */
+	uint32_t last_bin;	/* Highest bin considered (< num_bins - 1) */
+	float bin_hz;		/* Bin spacing in Hz (sample_rate / FFT size) */
+	float floor;		/* Absolute magnitude a peak must reach */
+	float relative;		/* ... and this fraction of the strongest peak (0 = off) */
+} spectral_peak_search_t;
+
+/**
+ * Top-K spectral peak extraction
+ *
+ * One pass over the search band: every local maximum above the absolute
+ * floor is inserted into the caller's array (kept sorted by magnitude, the
+ * weakest dropped when full) while the strongest magnitude is tracked. The
+ * relative threshold is then applied to the K survivors, so the adaptive
+ * threshold costs no second pass. Each kept peak is refined with
+ * parabolic_peak_offset(). Nothing is allocated.
+ *
+ * @param magnitude: Magnitude spectrum
+ * @param re, im: Complex spectrum for peak phases (both NULL to skip)
+ * @param num_bins: Number of bins in the spectrum
+ * @param search: Band and thresholds
+ * @param peaks: Output, strongest first
+ * @param max_peaks: K, capacity of `peaks`
+ * @return: Number of peaks written
+ */
+uint32_t spectral_peaks_top_k(const float* magnitude, const float* re, const float* im, uint32_t num_bins,
+                              const spectral_peak_search_t* search, spectral_peak_t* peaks, uint32_t max_peaks);
+
+/**
+ * Goertzel probe (power of one arbitrary frequency)
+ *
+ * Second-order recursion for |X(f)|^2 = |sum_n x[n] e^(-j 2 pi f n)|^2 at
+ * any frequency, not just bin centres: one multiply-add per sample, about
+ * the cost of a real dot product. The recursion runs in double: at E2 on a
+ * 1024-sample frame a cent moves the power near the peak by 1e-4, which
+ * float rounding of the state matches.
+ *
+ * @param samples: Time-domain frame (already windowed)
+ * @param num_samples: Frame length
+ * @param cycles_per_sample: Probe frequency / sample rate
+ * @return: Power at the probe frequency
+ */
+float goertzel_power(const float* samples, uint32_t num_samples, double cycles_per_sample);
+
+/**
+ * Golden-section peak refinement (sub-bin frequency from the time domain)
+ *
+ * The FFT only says which bin the peak fell in. Inside a single main lobe
+ * the windowed spectrum is unimodal, so a golden-section search with
+ * Goertzel probes on the same windowed frame narrows [low_hz, high_hz] by
+ * 0.618 per probe: 16 probes over 1.2 bins of a 256-point frame at 10 kHz
+ * leave a bracket under 0.05 Hz, about one cent at E2. Other partials
+ * and the negative-frequency image leaking into the lobe still shift the
+ * maximum itself: on 256 samples a few cents from C3 up and tens of cents
+ * for E2, whose second harmonic is two bins away. Searching again on a
+ * 1024-sample frame, bracketed by one of its bins, puts E2's second
+ * harmonic eight bins away and the error under a cent.
+ *
+ * @param samples: Windowed frame the peak was found in
+ * @param num_samples: Frame length
+ * @param sample_rate: Sample rate in Hz
+ * @param low_hz, high_hz: Bracket around the peak (within its main lobe)
+ * @param probes: Goertzel evaluations to spend (>= 2)
+ * @return: Frequency of the largest |X(f)| in Hz, centre of the final bracket
+ */
+double golden_section_peak(const float* samples, uint32_t num_samples, double sample_rate,
+                           double low_hz, double high_hz, uint32_t probes);
+
+/**
+ * Harmonic validation (filters out non-music noise)
+ *
+ * A plucked string is a set of spectral lines at k * f0 with quiet valleys
+ * between them; claps, breath, whispered vowels and handling noise fill the
+ * valleys (a formant is a peak tens of Hz wide, not a line). Each partial is
+ * probed at k * f0 and against the two valleys midway to its neighbours,
+ * and only the power standing HARMONIC_VALIDATION_VALLEY_RATIO times above
+ * the mean valley counts. The score is that line power as a fraction of the
+ * frame's energy, so low-pass noise, whose energy merely sits below a few
+ * hundred Hz, scores near zero however low f0 is.
+ *
+ * The valleys only open up once the window resolves them: at E2 (82 Hz)
+ * the partials are 82 Hz apart and a 256-sample Hann lobe is 78 Hz wide,
+ * while on 512 samples each valley lies past the edge of its lobes.
+ *
+ * Cost: two Goertzel probes per partial below Nyquist plus one, the valleys
+ * being shared between neighbouring partials (13 over 512 samples at most
+ * for the analyzer's frame, about 7k multiply-adds).
+ *
+ * @param samples: Hann-windowed, mean-removed frame
+ * @param num_samples: Frame length
+ * @param sample_rate: Sample rate in Hz
+ * @param f0: Candidate fundamental in Hz (refined, not a bin centre)
+ * @return: Confidence in [0, 1]; 0.0 for a silent frame or invalid f0
+ */
+float harmonic_validation_score(const float* samples, uint32_t num_samples, double sample_rate, double f0);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIGNAL_PROCESSING_H */
@@ -52,7 +52,11 @@ const NoteFrequency guitar_notes[] = { // Frequency, Note, String, Octave
 	{440, "A", 1, 4},
 	{466, "A#", 1, 4},
 	{494, "B", 1, 4},
-	{523, "C", 1, 5} 
+	{523, "C", 1, 5},
+	{554, "C#", 1, 5},
+	{587, "D", 1, 5},
+	{622, "D#", 1, 5},
+	{659, "E", 1, 5} // 12th fret of string 1
 };
 
 #define NUM_NOTES (sizeof(guitar_notes) / sizeof(guitar_notes[0]))
@@ -66,9 +70,53 @@ const double string_frequencies[] = {
 	GUITAR_STRING_6_FREQ
 };
 
+/* Active instrument/tuning - NULL falls back to string_frequencies[] */
+static const tuning_table_t* active_tuning = NULL;
+
 void string_detection_init(void) {
+	active_tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
 	printf("String detection module initialized.\n");
 	printf("Number of notes in database: %ld\n", NUM_NOTES);
+	printf("Tuning profile: %s (%d strings)\n", active_tuning->name, active_tuning->string_count);
+}
+
+/**
+ * Switch instrument/tuning profile
+ * Tables carry a prebuilt index, so this is just a pointer swap
+ */
+void string_detection_set_tuning(const tuning_table_t* table) {
+	active_tuning = table;
+}
+
+const tuning_table_t* string_detection_get_tuning(void) {
+	return active_tuning;
+}
+
+/* Number of strings in a profile (NULL = string_frequencies[]) */
+static int table_string_count(const tuning_table_t* table) {
+	return table ? table->string_count : 6;
+}
+
+/* Target frequency of a 1-based string in a profile */
+static double table_string_frequency(const tuning_table_t* table, int string_num) {
+	if (table) {
+		return table->strings[string_num - 1].target_hz;
+	}
+	return string_frequencies[string_num - 1];
+}
+
+/* Per-string "in tune" window from a profile */
+static const char* tuning_direction_for_string(const tuning_table_t* table, double cents, int string_num) {
+	if (table && string_num >= 1 && string_num <= table->string_count) {
+		double tolerance = table->strings[string_num - 1].tolerance_cents;
+		if (cents < -tolerance) {
+			return "UP";
+		} else if (cents > tolerance) {
+			return "DOWN";
+		}
+		return "IN_TUNE";
+	}
+	return get_tuning_direction(cents);
 }
 
 double calculate_cents_offset(double detected_freq, double target_freq) {
@@ -89,7 +137,21 @@ const char* get_tuning_direction(double cents) {
 	}
 }
 
-int find_closest_string(double frequency, double* closest_freq) {
+static int closest_string_in(const tuning_table_t* table, double frequency, double* closest_freq) {
+	if (table) {
+		/* O(log n) lookup through the table's precomputed split points */
+		int string_num = tuning_table_find_string(table, frequency);
+		if (string_num < 0) {
+			return -1;
+		}
+		double target = table->strings[string_num - 1].target_hz;
+		if (fabs(frequency - target) >= 1000.0) {
+			return -1;
+		}
+		*closest_freq = target;
+		return string_num;
+	}
+
 	double min_diff = 1000.0;
 	int closest_string = -1;
 	for (int i = 0; i < 6; i++) {
@@ -103,6 +165,10 @@ int find_closest_string(double frequency, double* closest_freq) {
 	return closest_string;
 }
 
+int find_closest_string(double frequency, double* closest_freq) {
+	return closest_string_in(active_tuning, frequency, closest_freq);
+}
+
 int find_closest_note(double frequency, double* closest_freq, int* string_num) {
 	double min_diff = 1000.0;
 	int closest_index = -1;
@@ -119,50 +185,41 @@ int find_closest_note(double frequency, double* closest_freq, int* string_num) {
 }
 
 TuningResult analyze_tuning(double detected_frequency, int target_string) {
-	TuningResult result;
-	if (target_string < 1 || target_string > 6) {
-		return analyze_tuning_auto(detected_frequency);
-	}
-	result.target_frequency = string_frequencies[target_string - 1];
-	result.target_string = target_string;
-	double detected_string_freq;
-	result.detected_string = find_closest_string(detected_frequency, &detected_string_freq);
-	result.detected_frequency = detected_frequency;
-	result.cents_offset = calculate_cents_offset(detected_frequency, result.target_frequency);
-	if (detected_frequency <= 0.0) {
-		result.direction = "UNKNOWN";
-	} else {
-		result.direction = get_tuning_direction(result.cents_offset);
-	}
-	double closest_note_freq;
-	int note_string;
-	int note_index = find_closest_note(detected_frequency, &closest_note_freq, &note_string);
-	if (note_index >= 0) {
-		result.note_name = guitar_notes[note_index].note_name;
-		result.octave = guitar_notes[note_index].octave;
-	} else {
-		result.note_name = "?";
-		result.octave = 0;
-	}
-	return result;
+	return analyze_tuning_table(active_tuning, detected_frequency, target_string);
 }
 
 TuningResult analyze_tuning_auto(double detected_frequency) {
+	return analyze_tuning_table(active_tuning, detected_frequency, 0);
+}
+
+/**
+ * Shared by the table and note entry points: note_index picks the name and
+ * octave directly when valid, otherwise the nearest note is searched
+ */
+static TuningResult tuning_result_for(const tuning_table_t* table, double detected_frequency, int target_string,
+                                      int note_index) {
 	TuningResult result;
-	double target_freq;
-	result.detected_string = find_closest_string(detected_frequency, &target_freq);
-	result.target_string = result.detected_string;
+	double detected_string_freq = 0.0;
+	result.detected_string = closest_string_in(table, detected_frequency, &detected_string_freq);
 	result.detected_frequency = detected_frequency;
-	result.target_frequency = target_freq;
-	result.cents_offset = calculate_cents_offset(detected_frequency, target_freq);
+	if (target_string >= 1 && target_string <= table_string_count(table)) {
+		result.target_string = target_string;
+		result.target_frequency = table_string_frequency(table, target_string);
+	} else {
+		result.target_string = result.detected_string;
+		result.target_frequency = detected_string_freq;
+	}
+	result.cents_offset = calculate_cents_offset(detected_frequency, result.target_frequency);
 	if (detected_frequency <= 0.0) {
 		result.direction = "UNKNOWN";
 	} else {
-		result.direction = get_tuning_direction(result.cents_offset);
+		result.direction = tuning_direction_for_string(table, result.cents_offset, result.target_string);
+	}
+	if (note_index < 0 || note_index >= (int)NUM_NOTES) {
+		double closest_note_freq;
+		int note_string;
+		note_index = find_closest_note(detected_frequency, &closest_note_freq, &note_string);
 	}
-	double closest_note_freq;
-	int note_string;
-	int note_index = find_closest_note(detected_frequency, &closest_note_freq, &note_string);
 	if (note_index >= 0) {
 		result.note_name = guitar_notes[note_index].note_name;
 		result.octave = guitar_notes[note_index].octave;
@@ -172,3 +229,21 @@ TuningResult analyze_tuning_auto(double detected_frequency) {
 	}
 	return result;
 }
+
+/**
+ * Tuning analysis against an explicit profile instead of the active one
+ * Reads no module state, so independent sessions (each with its own
+ * profile) can call it from any thread
+ */
+TuningResult analyze_tuning_table(const tuning_table_t* table, double detected_frequency, int target_string) {
+	return tuning_result_for(table, detected_frequency, target_string, -1);
+}
+
+/**
+ * Tuning analysis when the note is already known, e.g. from a constant-Q
+ * bin: the name comes from the index instead of a nearest-note search
+ */
+TuningResult analyze_tuning_note(const tuning_table_t* table, int note_index, double detected_frequency,
+                                 int target_string) {
+	return tuning_result_for(table, detected_frequency, target_string, note_index);
+}
@@ -9,6 +9,7 @@
 #define STRING_DETECTION_H
 
 #include <stdint.h>
+#include "tuning_table.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +52,22 @@ const char* get_tuning_direction(double cents);
 int find_closest_string(double frequency, double* closest_freq);
 int find_closest_note(double frequency, double* closest_freq, int* string_num);
 
+// Active tuning profile (defaults to standard guitar after string_detection_init)
+void string_detection_set_tuning(const tuning_table_t* table);
+const tuning_table_t* string_detection_get_tuning(void);
+
+// Analysis against an explicit profile (NULL = string_frequencies[]); reads no
+// module state. target_string outside 1..string_count means auto-detect.
+TuningResult analyze_tuning_table(const tuning_table_t* table, double detected_frequency, int target_string);
+
+// Chromatic note table: index = semitones above E2, up to E5 (12th fret of string 1)
+#define NOTE_INDEX_COUNT 37
+
+// Same with the note already known (note_index 0 = E2); an index outside
+// 0..NOTE_INDEX_COUNT-1 falls back to the nearest-note search
+TuningResult analyze_tuning_note(const tuning_table_t* table, int note_index, double detected_frequency,
+                                 int target_string);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,233 @@
+/**
+ * strum_analyzer.c - Polyphonic strum analysis implementation
+ *
+ * Peak picking (spectral_peaks_top_k) keeps only the STRUM_MAX_PEAKS
+ * strongest maxima, so grouping works on a few dozen candidates rather than
+ * the 800 bins of the search band.
+ */
+
+#include "strum_analyzer.h"
+#include "signal_processing.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.14159265358979323846f
+#endif
+
+#define HZ_PER_BIN ((double)STRUM_SAMPLE_RATE / STRUM_FFT_SIZE)
+
+typedef struct {
+    double f0;                  // Interpolated fundamental peak
+    float magnitude;
+    int partials;
+} strum_series_t;
+
+/* ============================================================================
+ * INIT
+ * ========================================================================== */
+
+void strum_analyzer_init(strum_analyzer_t* strum, const tuning_table_t* tuning) {
+    if (tuning == NULL) {
+        tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    }
+    strum->tuning = tuning;
+    for (int n = 0; n < STRUM_FFT_SIZE; n++) {
+        strum->window[n] = 0.5f * (1.0f - cosf(2.0f * PI * n / (STRUM_FFT_SIZE - 1)));
+    }
+    for (int k = 0; k < STRUM_FFT_SIZE / 2; k++) {
+        strum->twiddle_re[k] = cosf(-2.0f * PI * k / STRUM_FFT_SIZE);
+        strum->twiddle_im[k] = sinf(-2.0f * PI * k / STRUM_FFT_SIZE);
+    }
+}
+
+/* ============================================================================
+ * SPECTRUM
+ * ========================================================================== */
+
+static void fft(strum_analyzer_t* strum) {
+    float* re = strum->re;
+    float* im = strum->im;
+
+    for (uint32_t i = 0; i < STRUM_FFT_SIZE; i++) {
+        uint32_t reversed = 0;
+        for (uint32_t b = 0, j = i; b < STRUM_LOG2_SIZE; b++, j >>= 1) {
+            reversed = (reversed << 1) | (j & 1);
+        }
+        if (i < reversed) {
+            float tmp = re[i];
+            re[i] = re[reversed];
+            re[reversed] = tmp;
+        }
+    }
+    for (uint32_t half = 1, stride = STRUM_FFT_SIZE / 2; half < STRUM_FFT_SIZE; half <<= 1, stride >>= 1) {
+        for (uint32_t i = 0; i < STRUM_FFT_SIZE; i += 2 * half) {
+            for (uint32_t j = 0; j < half; j++) {
+                const float wr = strum->twiddle_re[j * stride];
+                const float wi = strum->twiddle_im[j * stride];
+                uint32_t a = i + j;
+                uint32_t b = a + half;
+                float tr = wr * re[b] - wi * im[b];
+                float ti = wr * im[b] + wi * re[b];
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * Windowed, DC-free spectrum of the strum into strum->magnitude
+ * @return Last bin of the search band
+ */
+static uint32_t compute_spectrum(strum_analyzer_t* strum, const int16_t* samples, int num_samples) {
+    float mean = 0.0f;
+    for (int n = 0; n < num_samples; n++) {
+        mean += samples[n];
+    }
+    mean /= (float)num_samples;
+
+    for (int n = 0; n < STRUM_FFT_SIZE; n++) {
+        strum->re[n] = (n < num_samples) ? (samples[n] - mean) / 32768.0f * strum->window[n] : 0.0f;
+        strum->im[n] = 0.0f;
+    }
+    fft(strum);
+
+    uint32_t limit = (uint32_t)(STRUM_MAX_HZ / HZ_PER_BIN);
+    if (limit > STRUM_BINS - 1) {
+        limit = STRUM_BINS - 1;
+    }
+    for (uint32_t k = 0; k <= limit; k++) {
+        strum->magnitude[k] = sqrtf(strum->re[k] * strum->re[k] + strum->im[k] * strum->im[k]);
+    }
+    return limit;
+}
+
+/* ============================================================================
+ * PEAKS
+ * ========================================================================== */
+
+/**
+ * Strongest local maxima (spectral_peaks_top_k), returned in ascending frequency
+ */
+static int find_peaks(const strum_analyzer_t* strum, uint32_t limit, spectral_peak_t* peaks) {
+    const spectral_peak_search_t search = {
+        1, limit - 1, (float)HZ_PER_BIN, STRUM_PEAK_FLOOR, STRUM_PEAK_RELATIVE
+    };
+    int count = (int)spectral_peaks_top_k(strum->magnitude, strum->re, strum->im, limit + 1, &search,
+                                          peaks, STRUM_MAX_PEAKS);
+
+    /* Grouping walks upwards in frequency */
+    for (int i = 1; i < count; i++) {
+        spectral_peak_t peak = peaks[i];
+        int j = i;
+        while (j > 0 && peaks[j - 1].frequency > peak.frequency) {
+            peaks[j] = peaks[j - 1];
+            j--;
+        }
+        peaks[j] = peak;
+    }
+    return count;
+}
+
+/* ============================================================================
+ * HARMONIC GROUPING
+ * ========================================================================== */
+
+static double cents_between(double f, double reference) {
+    return 1200.0 * log2(f / reference);
+}
+
+/**
+ * Add `peak` to the series of a lower fundamental it is a partial of
+ * A peak that could also be an open string's fundamental is only taken when
+ * clearly weaker than the owner's fundamental (see STRUM_OVERLAP_RATIO)
+ * @return true if the peak was explained that way
+ */
+static bool claim_partial(strum_series_t* series, int string_count, const spectral_peak_t* peak, bool string_candidate) {
+    for (int s = 0; s < string_count; s++) {
+        strum_series_t* owner = &series[s];
+        if (owner->partials == 0 || owner->f0 >= peak->frequency) {
+            continue;
+        }
+        int k = (int)(peak->frequency / owner->f0 + 0.5);
+        if (k < 2 || k > STRUM_PARTIALS) {
+            continue;
+        }
+        if (fabs(cents_between(peak->frequency, k * owner->f0)) > STRUM_PARTIAL_CENTS) {
+            continue;
+        }
+        /* Too strong for a partial alone: another string is sounding here too */
+        if (string_candidate && peak->magnitude > owner->magnitude * STRUM_OVERLAP_RATIO) {
+            continue;
+        }
+        owner->partials++;
+        return true;
+    }
+    return false;
+}
+
+static int nearest_open_string(const tuning_table_t* tuning, double frequency) {
+    int best = -1;
+    double best_cents = STRUM_MATCH_CENTS;
+    for (int s = 0; s < tuning->string_count; s++) {
+        double cents = fabs(cents_between(frequency, tuning->strings[s].target_hz));
+        if (cents < best_cents) {
+            best_cents = cents;
+            best = s;
+        }
+    }
+    return best;
+}
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+int strum_analyze(strum_analyzer_t* strum, const int16_t* samples, int num_samples, strum_result_t* result) {
+    spectral_peak_t peaks[STRUM_MAX_PEAKS];
+    strum_series_t series[TUNING_MAX_STRINGS];
+    const tuning_table_t* tuning = strum->tuning;
+
+    memset(result, 0, sizeof(*result));
+    memset(series, 0, sizeof(series));
+    result->string_count = tuning->string_count;
+    if (samples == NULL || num_samples <= 0) {
+        return 0;
+    }
+    if (num_samples > STRUM_FFT_SIZE) {
+        num_samples = STRUM_FFT_SIZE;
+    }
+
+    uint32_t limit = compute_spectrum(strum, samples, num_samples);
+    int peak_count = find_peaks(strum, limit, peaks);
+
+    for (int p = 0; p < peak_count; p++) {
+        int s = nearest_open_string(tuning, peaks[p].frequency);
+        if (claim_partial(series, tuning->string_count, &peaks[p], s >= 0)) {
+            continue;
+        }
+        if (s < 0 || (series[s].partials > 0 && series[s].magnitude >= peaks[p].magnitude)) {
+            continue;       // Stray peak, or a weaker candidate for a string already found
+        }
+        series[s].f0 = peaks[p].frequency;
+        series[s].magnitude = peaks[p].magnitude;
+        series[s].partials = 1;
+    }
+
+    for (int s = 0; s < tuning->string_count; s++) {
+        double frequency = 0.0;
+        if (series[s].partials > 0) {
+            frequency = series[s].f0;
+            result->found[s] = 1;
+            result->level[s] = series[s].magnitude;
+            result->partials[s] = (uint8_t)series[s].partials;
+            result->strings_found++;
+        }
+        result->strings[s] = analyze_tuning_table(tuning, frequency, s + 1);
+    }
+    return result->strings_found;
+}
@@ -0,0 +1,114 @@
+/**
+ * strum_analyzer.h - Polyphonic strum mode: every string from one strum
+ *
+ * Instead of plucking and waiting six times, the user strums once and the
+ * tuner reports which strings are off. One high-resolution transform is
+ * shared by all strings:
+ *
+ * 1. SPECTRUM: 4096-point FFT of 410 ms of the strum (2.44 Hz/bin at
+ *    10 kHz), Hann window, magnitudes up to STRUM_MAX_HZ
+ *
+ * 2. PEAKS: local maxima above an adaptive threshold (a fraction of the
+ *    strongest peak, never below a fixed floor), refined with parabolic
+ *    interpolation to a few hundredths of a bin
+ *
+ * 3. HARMONIC GROUPING: peaks are taken lowest first. A peak that sits on a
+ *    partial (k * f0) of a fundamental already accepted is part of that
+ *    string's series; otherwise it is a new fundamental and is matched to
+ *    the nearest open string within STRUM_MATCH_CENTS. A string's frequency
+ *    is its interpolated fundamental: partials of low strings coincide with
+ *    higher strings and would pull an average off.
+ *
+ * 4. RESULTS: one TuningResult per string of the profile, analyzed against
+ *    that string's own target
+ *
+ *     static strum_analyzer_t strum;
+ *     strum_analyzer_init(&strum, NULL);
+ *     strum_result_t result;
+ *     strum_analyze(&strum, samples, STRUM_FFT_SIZE, &result);
+ *
+ * Coinciding partials (E2 x 3 = B3, E2 x 4 = A2 x 3 = E4 in standard
+ * tuning) are credited to the higher string when that peak is more than
+ * STRUM_OVERLAP_RATIO of the lower string's fundamental, i.e. when the
+ * string was played too. A low string with unusually strong upper partials
+ * can therefore report a higher string that was not played.
+ */
+
+#ifndef STRUM_ANALYZER_H
+#define STRUM_ANALYZER_H
+
+#include <stdint.h>
+#include "string_detection.h"
+#include "tuning_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define STRUM_FFT_SIZE          4096    // 410 ms at 10 kHz, 2.44 Hz/bin
+#define STRUM_LOG2_SIZE         12
+#define STRUM_SAMPLE_RATE       10000   // Hz (SAMPLE_RATE)
+#define STRUM_MAX_HZ            2000    // Top of the peak search
+#define STRUM_MAX_PEAKS         32      // Strongest peaks kept for grouping
+#define STRUM_PEAK_RELATIVE     0.03f   // Peaks below 3% (-30 dB) of the strongest are ignored
+#define STRUM_PEAK_FLOOR        0.5f    // Absolute magnitude floor (fixed mono threshold)
+#define STRUM_MATCH_CENTS       180.0   // Fundamental to open string, either side (< 2 semitones)
+#define STRUM_PARTIAL_CENTS     30.0    // Peak to k * f0 (allows string inharmonicity)
+#define STRUM_PARTIALS          8       // Partials grouped into one series
+#define STRUM_OVERLAP_RATIO     0.5f    // A partial on an open string must be below this x its fundamental
+
+#define STRUM_BINS              (STRUM_FFT_SIZE / 2)
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef struct {
+    float re[STRUM_FFT_SIZE];
+    float im[STRUM_FFT_SIZE];
+    float magnitude[STRUM_BINS];
+    float window[STRUM_FFT_SIZE];
+    float twiddle_re[STRUM_FFT_SIZE / 2];
+    float twiddle_im[STRUM_FFT_SIZE / 2];
+    const tuning_table_t* tuning;
+} strum_analyzer_t;
+
+typedef struct {
+    int string_count;                               // Strings in the profile
+    int strings_found;
+    TuningResult strings[TUNING_MAX_STRINGS];       // strings[i] is string i + 1
+    uint8_t found[TUNING_MAX_STRINGS];              // 0 = string not heard in the strum
+    float level[TUNING_MAX_STRINGS];                // Fundamental magnitude
+    uint8_t partials[TUNING_MAX_STRINGS];           // Partials grouped into the series
+} strum_result_t;
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/**
+ * Build window and twiddle tables
+ *
+ * @param tuning: Profile whose open strings are matched, NULL for standard guitar
+ */
+void strum_analyzer_init(strum_analyzer_t* strum, const tuning_table_t* tuning);
+
+/**
+ * Analyze one strum
+ *
+ * @param samples: 10 kHz PCM starting just after the strum's attack
+ * @param num_samples: Up to STRUM_FFT_SIZE (fewer are zero padded, with
+ *                     proportionally less resolution)
+ * @return Number of strings found
+ */
+int strum_analyze(strum_analyzer_t* strum, const int16_t* samples, int num_samples, strum_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STRUM_ANALYZER_H
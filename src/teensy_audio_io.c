@@ -51,6 +51,13 @@ teensy_audio_error_t init_audio_system(void)
     return TEENSY_AUDIO_OK;
 }
 
+// Byte source for the WAV decoder
+static size_t sd_wav_read(void* handle, uint8_t* buffer, size_t bytes)
+{
+    int got = sd_file_read((audio_file_handle_t)handle, buffer, (int)bytes);
+    return (got > 0) ? (size_t)got : 0;
+}
+
 // --------- Opens audio file (on SD card) --------------
 teensy_audio_error_t open_audio_file(teensy_audio_stream_t* stream, const char* filename) 
 {
@@ -66,50 +73,60 @@ teensy_audio_error_t open_audio_file(teensy_audio_stream_t* stream, const char*
     
     stream->file_size = sd_file_size(stream->audio_file);
     stream->bytes_read = 0;
+
+    // Parse the header - any PCM depth, float32 and multichannel files are accepted
+    if (wav_decoder_open(&stream->decoder, sd_wav_read, stream->audio_file) != WAV_OK)
+    {
+        serial_print("ERROR: Unsupported WAV file: ");
+        serial_println(filename);
+        sd_file_close(stream->audio_file);
+        stream->audio_file = NULL;
+        return TEENSY_AUDIO_FILE_ERROR;
+    }
+    // Blocks are analyzed as AUDIO_SAMPLE_RATE audio, whatever rate the file was recorded at
+    wav_decoder_set_output_rate(&stream->decoder, AUDIO_SAMPLE_RATE);
     stream->is_playing = true;
     
     serial_print("Opened audio file: ");
     serial_print(filename);
     serial_print(", size: ");
     serial_print_uint32(stream->file_size);
-    serial_println(" bytes");
+    serial_print(" bytes, ");
+    serial_print_uint32(stream->decoder.format.sample_rate);
+    serial_print(" Hz, ");
+    serial_print_uint32(stream->decoder.format.channels);
+    serial_print(" ch, ");
+    serial_print_uint32(stream->decoder.format.bits_per_sample);
+    serial_println(" bit");
     
     return TEENSY_AUDIO_OK;
 }
 
 // Reads block of audio samples from audio file
+// Output is mono (channels averaged), resampled to AUDIO_SAMPLE_RATE
 teensy_audio_error_t read_audio_block(teensy_audio_stream_t* stream, float* output) 
 {
-    if (!stream->is_playing || !sd_file_available(stream->audio_file)) 
+    if (!stream->is_playing) 
     {
-        stream->is_playing = false;
         return TEENSY_AUDIO_ERROR;
     }
     
-    // Read raw audio data, this assumes 16-bit WAV but can be changed
-    int bytes_to_read = AUDIO_BLOCK_SIZE * 2; // 2 bytes per 16-bit sample
-    int bytes_read = sd_file_read(stream->audio_file, (uint8_t*)stream->buffer, bytes_to_read);
+    // Decode any supported format straight to float (-1.0, 1.0)
+    uint32_t samples_read = wav_decoder_read(&stream->decoder, output, AUDIO_BLOCK_SIZE);
     
-    if (bytes_read <= 0) 
+    if (samples_read == 0) 
     {
         stream->is_playing = false;
         return TEENSY_AUDIO_ERROR;
     }
     
-    // Convert 16-bit samples (-32768 to +32767) to float (-1.0, 1.0)
-    int samples_read = bytes_read / 2;
-    for (int i = 0; i < samples_read; i++) 
-    {
-        output[i] = stream->buffer[i] / 32768.0f;
-    }
-    
-    // If it gets to the end of the file and the block is less than 16-bits, fill end with 0s
-    for (int i = samples_read; i < AUDIO_BLOCK_SIZE; i++) 
+    // If it gets to the end of the file and the block is short, fill end with 0s
+    for (uint32_t i = samples_read; i < AUDIO_BLOCK_SIZE; i++) 
     {
         output[i] = 0.0f;
     }
     
-    stream->bytes_read += bytes_read;
+    stream->bytes_read = stream->decoder.bytes_consumed;
     
     // Print progress every 10% -- also an error check if it isn't loading
     static uint32_t last_progress = 0;
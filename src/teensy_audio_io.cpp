@@ -1,20 +1,82 @@
 #include "teensy_audio_io.h" //header file
 #include <Arduino.h> 
+#include "voice_mixer.h"
+#include "feedback_scheduler.h"
+#include "prompt_cache.h"
+
+// --------- FEEDBACK MIXER STAGE ---------
+// Mixes the SD player (passthrough), cached prompts (speech) and beeps into
+// one output block, so a beep no longer stops a clip and vice versa
+// Prompts and beeps come from the sample-clock scheduler; beeps duck under speech
+// The SD player's left and right are averaged into the passthrough (a mono
+// file arrives on both); the mix is mono and sent to both speaker channels
+class AudioFeedbackMixer : public AudioStream {
+public:
+    AudioFeedbackMixer() : AudioStream(2, inputQueueArray) {
+        voice_mixer_init();
+        voice_mixer_add(VOICE_SPEECH, voice_mixer_buffer_source, &prompt_voice, 1.0f);
+        voice_mixer_add(VOICE_BEEP, voice_mixer_buffer_source, &beep_voice, 1.0f);
+        voice_mixer_add(VOICE_PASSTHROUGH, voice_mixer_buffer_source, &sd_voice, 1.0f);
+        prompt_voice.samples = prompt_block;
+        beep_voice.samples = beep_block;
+        sd_voice.samples = sd_block;
+    }
+
+    virtual void update(void) {
+        audio_block_t* left = receiveReadOnly(0);
+        audio_block_t* right = receiveReadOnly(1);
+        sd_voice.active = (left || right) ? AUDIO_BLOCK_SAMPLES : 0;
+        for (int i = 0; i < AUDIO_BLOCK_SAMPLES; i++) {
+            int32_t l = left ? left->data[i] : 0;
+            int32_t r = right ? right->data[i] : 0;
+            sd_block[i] = (int16_t)((left && right) ? (l + r) / 2 : l + r);
+        }
+        prompt_voice.active = feedback_scheduler_render_split(prompt_block, beep_block,
+                                                              AUDIO_BLOCK_SAMPLES, &beep_voice.active);
+
+        audio_block_t* out = allocate();
+        if (out) {
+            voice_mixer_render(out->data, AUDIO_BLOCK_SAMPLES);
+            transmit(out, 0);
+            transmit(out, 1);
+            release(out);
+        }
+        if (left) {
+            release(left);
+        }
+        if (right) {
+            release(right);
+        }
+    }
+
+private:
+    audio_block_t* inputQueueArray[2];
+    int16_t sd_block[AUDIO_BLOCK_SAMPLES];
+    int16_t prompt_block[AUDIO_BLOCK_SAMPLES];
+    int16_t beep_block[AUDIO_BLOCK_SAMPLES];
+    voice_buffer_t prompt_voice = { NULL, 0 };
+    voice_buffer_t beep_voice = { NULL, 0 };
+    voice_buffer_t sd_voice = { NULL, 0 };
+};
 
 // --------- GLOBAL OBJECTS ---------
 // playWav: read WAV files from SD card
 // fft: analyzes frequency (1024-point fft)
+// feedback_mix: mixes SD playback, cached prompts and beeps (voice_mixer)
 // i2s_out: sends data to speaker via I2S protocol 
 // patchCord1: connects audio to FFT analyzer
-// patchCord2: connects left channel to speaker
-// patchCord3: connects right channel to speaker
+// patchCord2/5: connect both SD playback channels to the mixer (averaged)
+// patchCord3/4: connect the mono mix to both speaker channels
 // sgt15000: controls audio codec chip
 AudioPlaySdWav           playWav;
 AudioAnalyzeFFT1024      fft;
+AudioFeedbackMixer       feedback_mix;
 AudioOutputI2S           i2s_out;
 AudioConnection          patchCord1(playWav, 0, fft, 0);
-AudioConnection          patchCord2(playWav, 0, i2s_out, 0);
-AudioConnection          patchCord3(playWav, 1, i2s_out, 1);
+AudioConnection          patchCord2(playWav, 0, feedback_mix, 0);
+AudioConnection          patchCord3(feedback_mix, 0, i2s_out, 0);
+AudioConnection          patchCord4(feedback_mix, 1, i2s_out, 1);
+AudioConnection          patchCord5(playWav, 1, feedback_mix, 1);
 AudioControlSGTL5000     sgtl5000;
 
 
@@ -29,8 +91,16 @@ teensy_audio_error_t init_audio_system(void)
     // For now, we just allocate audio memory and set up state
     printf("SD card initialization (platform-specific)...\n");
     
+    // Spoken prompts into RAM once, so feedback never waits on the SD card
+    int prompts = prompt_cache_load_startup(NULL, "");
+    printf("Prompts cached: %d\n", prompts);
+    
     // Audio memory allocation - allocate 20 blocks in RAM
     // Each block is 128 samples (~2.9ms at 44.1kHz)
+    // The graph starts updating once memory is there: feedback_mix then
+    // renders the prompt cache and beeps every block, which is what lets a
+    // phrase finish (audio_sequencer_update() waits on prompt_cache_is_playing())
+    AudioMemory(20);            // Static block pool: the count must be a constant
     audio_memory_blocks = 20;
     printf("Audio memory allocated: %u blocks\n", audio_memory_blocks);
     
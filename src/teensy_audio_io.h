@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "wav_decoder.h"
 
 // Standard C-based configuration (no Arduino-specific constants)
 #define AUDIO_BLOCK_SIZE 128 // Audio block size in samples (~2.9ms at 44.1kHz)
@@ -22,6 +23,7 @@ typedef struct {
     uint32_t bytes_read;
     int16_t buffer[AUDIO_BLOCK_SIZE];
     float fft_buffer[FFT_SIZE];
+    wav_decoder_t decoder; // Header, format and downmix state of the open file
 } teensy_audio_stream_t;
 
 //error codes 
@@ -0,0 +1,206 @@
+/**
+ * tone_synth.c - Phase-accumulator beep synthesizer implementation
+ *
+ * The pattern being played is copied into audio-update state when it is
+ * picked up, so the main loop may build the next one at any time. The
+ * envelope is min(position, remaining, ramp) times a precomputed Q15 step,
+ * which keeps attack, sustain and release in one branch-free expression.
+ */
+
+#include "tone_synth.h"
+#include "config.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ========================================================================== */
+
+#define FRACTION_BITS   15
+#define INDEX_SHIFT     (32 - TONE_SYNTH_TABLE_BITS)
+#define FRACTION_SHIFT  (INDEX_SHIFT - FRACTION_BITS)
+
+/* One guard entry so interpolation never wraps the index */
+static int16_t sine_table[TONE_SYNTH_TABLE_SIZE + 1];
+
+/* Main loop -> audio update handoff: NULL = no request, stop_request = fade out.
+   Two slots alternate so a pattern being picked up is never rewritten */
+static tone_pattern_t request_slots[2];
+static int next_slot = 0;
+static const tone_pattern_t stop_request;
+static const tone_pattern_t* pending_request = NULL;
+
+/* Owned by the audio update */
+static tone_pattern_t active;
+static volatile bool sounding = false;
+static uint32_t phase = 0;
+static uint32_t position = 0;       // Within the current beep
+static uint32_t gap_left = 0;
+static uint32_t repeats_left = 0;
+static int32_t envelope_step = 0;   // Q15 gain per ramp sample
+
+/* ============================================================================
+ * CONTROL
+ * ========================================================================== */
+
+void tone_synth_init(void) {
+    for (int i = 0; i <= TONE_SYNTH_TABLE_SIZE; i++) {
+        sine_table[i] = (int16_t)lrint(32767.0 * sin(2.0 * M_PI * i / TONE_SYNTH_TABLE_SIZE));
+    }
+    __atomic_store_n(&pending_request, NULL, __ATOMIC_RELEASE);
+    sounding = false;
+    phase = 0;
+    position = 0;
+    gap_left = 0;
+    repeats_left = 0;
+}
+
+static uint32_t ms_to_samples(uint32_t ms) {
+    return (uint32_t)((uint64_t)ms * AUDIO_SAMPLE_RATE / 1000);
+}
+
+void tone_synth_pattern(tone_pattern_t* pattern, float frequency_hz, uint32_t duration_ms,
+                        uint32_t gap_ms, uint32_t repeats, float level) {
+    if (frequency_hz < 0.0f) {
+        frequency_hz = 0.0f;
+    } else if (frequency_hz > AUDIO_SAMPLE_RATE * 0.45f) {
+        frequency_hz = AUDIO_SAMPLE_RATE * 0.45f;
+    }
+    if (duration_ms > TONE_SYNTH_MAX_DURATION_MS) {
+        duration_ms = TONE_SYNTH_MAX_DURATION_MS;
+    }
+    if (level < 0.0f) {
+        level = 0.0f;
+    } else if (level > 1.0f) {
+        level = 1.0f;
+    }
+
+    pattern->phase_increment = (uint32_t)(frequency_hz * (4294967296.0 / AUDIO_SAMPLE_RATE));
+    pattern->tone_samples = ms_to_samples(duration_ms);
+    pattern->gap_samples = ms_to_samples(gap_ms);
+    pattern->ramp_samples = ms_to_samples(TONE_SYNTH_RAMP_MS);
+    if (pattern->ramp_samples > pattern->tone_samples / 2) {
+        pattern->ramp_samples = pattern->tone_samples / 2;
+    }
+    if (pattern->ramp_samples == 0) {
+        pattern->ramp_samples = 1;
+    }
+    pattern->amplitude = (int32_t)(level * 32767.0f);
+    pattern->repeats = (repeats > 0) ? repeats : 1;
+}
+
+void tone_synth_play(const tone_pattern_t* pattern) {
+    if (pattern == NULL) {
+        return;
+    }
+    tone_pattern_t* slot = &request_slots[next_slot];
+    *slot = *pattern;
+    next_slot ^= 1;
+    __atomic_store_n(&pending_request, slot, __ATOMIC_RELEASE);
+}
+
+void tone_synth_beep(float frequency_hz, uint32_t duration_ms, float level) {
+    tone_pattern_t pattern;
+    tone_synth_pattern(&pattern, frequency_hz, duration_ms, 0, 1, level);
+    tone_synth_play(&pattern);
+}
+
+void tone_synth_stop(void) {
+    __atomic_store_n(&pending_request, &stop_request, __ATOMIC_RELEASE);
+}
+
+bool tone_synth_is_active(void) {
+    const tone_pattern_t* request = __atomic_load_n(&pending_request, __ATOMIC_ACQUIRE);
+    return (request != NULL && request != &stop_request) || sounding;
+}
+
+/* ============================================================================
+ * RENDERING
+ * ========================================================================== */
+
+/**
+ * Cut the pattern short: release from the current gain, no further repeats
+ */
+static void begin_release(void) {
+    repeats_left = 1;
+    if (gap_left > 0) {
+        sounding = false;           // Already silent
+        return;
+    }
+    uint32_t ramp = (position < active.ramp_samples) ? position : active.ramp_samples;
+    if (position + ramp < active.tone_samples) {
+        active.tone_samples = position + ramp;
+    }
+}
+
+uint32_t tone_synth_render(int16_t* output, uint32_t num_samples) {
+    /* Take the newest request at the block boundary */
+    const tone_pattern_t* request = __atomic_exchange_n(&pending_request, NULL, __ATOMIC_ACQUIRE);
+    if (request == &stop_request) {
+        if (sounding) {
+            begin_release();
+        }
+    } else if (request != NULL) {
+        active = *request;
+        envelope_step = active.amplitude / (int32_t)active.ramp_samples;
+        phase = 0;
+        position = 0;
+        gap_left = 0;
+        repeats_left = active.repeats;
+        sounding = (active.tone_samples > 0 && active.amplitude > 0);
+    }
+
+    uint32_t produced = 0;
+    uint32_t i = 0;
+    while (sounding && i < num_samples) {
+        if (gap_left > 0) {
+            uint32_t skip = (gap_left < num_samples - i) ? gap_left : num_samples - i;
+            gap_left -= skip;
+            i += skip;
+            continue;
+        }
+
+        uint32_t run = active.tone_samples - position;
+        if (run > num_samples - i) {
+            run = num_samples - i;
+        }
+        for (uint32_t k = 0; k < run; k++, i++, position++) {
+            uint32_t index = phase >> INDEX_SHIFT;
+            int32_t fraction = (int32_t)((phase >> FRACTION_SHIFT) & ((1 << FRACTION_BITS) - 1));
+            int32_t a = sine_table[index];
+            int32_t sample = a + (((sine_table[index + 1] - a) * fraction) >> FRACTION_BITS);
+
+            uint32_t edge = active.tone_samples - position;
+            if (edge > position) {
+                edge = position;
+            }
+            if (edge > active.ramp_samples) {
+                edge = active.ramp_samples;
+            }
+            int32_t mixed = output[i] + ((sample * (int32_t)edge * envelope_step) >> FRACTION_BITS);
+            if (mixed > 32767) {
+                mixed = 32767;
+            } else if (mixed < -32768) {
+                mixed = -32768;
+            }
+            output[i] = (int16_t)mixed;
+            phase += active.phase_increment;
+        }
+        produced += run;
+
+        if (position == active.tone_samples) {
+            position = 0;
+            if (--repeats_left == 0) {
+                sounding = false;
+            } else {
+                gap_left = active.gap_samples;
+                phase = 0;
+            }
+        }
+    }
+    return produced;
+}
@@ -0,0 +1,109 @@
+/**
+ * tone_synth.h - Phase-accumulator beep synthesizer for the output blocks
+ *
+ * One table-driven oscillator mixed into each 128-sample output block by the
+ * audio update. A 32-bit phase accumulator indexes a 256-entry sine table
+ * (linear interpolation between entries), and every beep gets a linear
+ * attack/release ramp so it starts and stops without clicks:
+ *
+ *     tone_synth_init();
+ *     ...
+ *     tone_synth_beep(880.0f, 50, 0.5f);     // Main loop: returns at once
+ *     ...
+ *     tone_synth_render(block, 128);         // Audio update: mixes into block
+ *
+ * Per sample: one add for the phase, one table interpolation, one envelope
+ * step and a saturating mix - no division, no floating point and no
+ * allocation. Beep requests are handed over through a single atomic pointer
+ * like prompt_cache playback, so the audio update never takes a lock.
+ */
+
+#ifndef TONE_SYNTH_H
+#define TONE_SYNTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define TONE_SYNTH_TABLE_BITS       8       // 256-entry sine table
+#define TONE_SYNTH_TABLE_SIZE       (1 << TONE_SYNTH_TABLE_BITS)
+#define TONE_SYNTH_RAMP_MS          4       // Attack and release (clicks below ~2 ms)
+#define TONE_SYNTH_MAX_DURATION_MS  2000
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef struct {
+    uint32_t phase_increment;   // Frequency * 2^32 / sample rate
+    uint32_t tone_samples;      // Length of each beep
+    uint32_t gap_samples;       // Silence between repeats
+    uint32_t ramp_samples;      // Attack / release length (<= tone_samples / 2)
+    int32_t amplitude;          // Q15 peak level
+    uint32_t repeats;           // Beeps in the pattern (1 = single beep)
+} tone_pattern_t;
+
+/* ============================================================================
+ * CONTROL (main loop)
+ * ========================================================================== */
+
+/**
+ * Silence the oscillator and build the sine table
+ */
+void tone_synth_init(void);
+
+/**
+ * Build a beep pattern without starting it
+ *
+ * @param frequency_hz: Pitch (clamped below Nyquist)
+ * @param duration_ms: Length of each beep
+ * @param gap_ms: Silence between repeats
+ * @param repeats: Number of beeps (>= 1)
+ * @param level: Peak amplitude 0.0 - 1.0
+ */
+void tone_synth_pattern(tone_pattern_t* pattern, float frequency_hz, uint32_t duration_ms,
+                        uint32_t gap_ms, uint32_t repeats, float level);
+
+/**
+ * Start a pattern at the next block, replacing any beep in progress
+ */
+void tone_synth_play(const tone_pattern_t* pattern);
+
+/**
+ * Start a single beep at the next block
+ */
+void tone_synth_beep(float frequency_hz, uint32_t duration_ms, float level);
+
+/**
+ * Fade out at the next block (release ramp, no click)
+ */
+void tone_synth_stop(void);
+
+/**
+ * @return true while a beep or pattern is sounding or waiting for the next block
+ */
+bool tone_synth_is_active(void);
+
+/* ============================================================================
+ * RENDERING (audio update)
+ * ========================================================================== */
+
+/**
+ * Mix the oscillator into an output block (adds with saturation)
+ *
+ * @return Samples of the block the oscillator was sounding in
+ */
+uint32_t tone_synth_render(int16_t* output, uint32_t num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TONE_SYNTH_H
@@ -0,0 +1,240 @@
+/**
+ * tuner_session.c - Independent tuner stream implementation
+ *
+ * A session touches only its own struct and the caller's stack, so sessions
+ * need no locking as long as each one is processed by one thread at a time.
+ */
+
+#include "tuner_session.h"
+#include "hum_notch.h"
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define FINE_CHUNK  128     // Samples converted per notch/tracker call
+
+/* ============================================================================
+ * FEEDBACK DECISION
+ * ========================================================================== */
+
+/**
+ * Recompute phrase and beep rate for the tracked result
+ * Without SEQUENCER_PART_OFFSET the cents are not trusted yet: no beeps
+ * @return true if anything the user would hear changed
+ */
+static bool update_feedback(tuner_session_t* session, int parts) {
+    const char* phrase[SEQUENCER_MAX_PHRASE_CLIPS];
+    int length = audio_sequencer_build_phrase_parts(&session->result, parts, phrase);
+    uint32_t interval = (parts & SEQUENCER_PART_OFFSET) ? calculate_beep_interval(session->result.cents_offset) : 0;
+    float pitch = (interval > 0) ? get_beep_pitch(session->result.cents_offset) : 0.0f;
+
+    bool changed = (length != session->phrase_length) ||
+                   (interval != session->beep_interval_ms) ||
+                   (pitch != session->beep_pitch);
+    for (int i = 0; !changed && i < length; i++) {
+        changed = (phrase[i] != session->phrase[i]);    // Clip names are constants
+    }
+    if (!changed) {
+        return false;
+    }
+    memcpy(session->phrase, phrase, sizeof(phrase));
+    session->phrase_length = length;
+    session->beep_interval_ms = interval;
+    session->beep_pitch = pitch;
+    session->feedback_changes++;
+    return true;
+}
+
+/* ============================================================================
+ * FINE TUNE
+ * ========================================================================== */
+
+/**
+ * Close enough to hand over: within the tracker's lock range, or within half
+ * an FFT bin (closer than the frame analysis can tell)
+ */
+static bool within_capture(const TuningResult* result) {
+    double bin_hz = (double)SAMPLE_RATE / ANALYZER_FRAME_SIZE;
+    return fabs(result->cents_offset) <= PHASE_TRACKER_LOCK_CENTS ||
+           fabs(result->detected_frequency - result->target_frequency) <= bin_hz / 2.0;
+}
+
+/**
+ * One block through the hum notch and the phase tracker
+ */
+static int process_fine(tuner_session_t* session, const int16_t* block, int num_samples) {
+    float chunk[FINE_CHUNK];
+    phase_tracker_state_t state = session->tracker.state;
+
+    /* The locked string stays guarded from the notch like an analyzed note */
+    hum_notch_set_note(&session->analyzer.hum_filter, (float)session->tracker.target_hz);
+    for (int offset = 0; offset < num_samples; offset += FINE_CHUNK) {
+        uint32_t count = (num_samples - offset < FINE_CHUNK) ? (uint32_t)(num_samples - offset) : FINE_CHUNK;
+        for (uint32_t i = 0; i < count; i++) {
+            chunk[i] = (float)block[offset + i] / 32768.0f;
+        }
+        hum_notch_process(&session->analyzer.hum_filter, chunk, count);
+        state = phase_tracker_process(&session->tracker, chunk, count);
+    }
+
+    if (state == PHASE_TRACKER_LOST) {
+        /* Back to frames, starting from a fresh window */
+        phase_tracker_release(&session->tracker);
+        session->fine_losses++;
+        session->fine_holdoff = TUNER_SESSION_FINE_HOLDOFF;
+        session->stable_frames = 0;
+        session->analyzer.stream_fill = 0;
+        return 0;
+    }
+    if (state != PHASE_TRACKER_LOCKED) {
+        return 0;
+    }
+
+    int events = TUNER_SESSION_FINE | TUNER_SESSION_DETECTED;
+    session->fine_blocks++;
+    session->result = analyze_tuning_table(session->tuning, phase_tracker_frequency(&session->tracker),
+                                           session->result.target_string);
+    if (update_feedback(session, SEQUENCER_PART_ALL)) {
+        events |= TUNER_SESSION_FEEDBACK;
+    }
+    return events;
+}
+
+/* ============================================================================
+ * PROGRESSIVE ESTIMATE
+ * ========================================================================== */
+
+/**
+ * Onset detection and one step of the progressive estimate
+ * The string is announced as soon as it is named (or renamed), the cents
+ * only at PROGRESSIVE_FINE
+ */
+static int process_early(tuner_session_t* session, const int16_t* block, int num_samples) {
+    int peak = 0;
+    for (int i = 0; i < num_samples; i++) {
+        int amplitude = block[i] < 0 ? -block[i] : block[i];
+        if (amplitude > peak) {
+            peak = amplitude;
+        }
+    }
+    if (peak < TUNER_SESSION_ONSET_AMPLITUDE) {
+        session->quiet = 1;
+        return 0;
+    }
+    if (session->quiet) {
+        session->quiet = 0;
+        session->early_active = 1;
+        session->early_level = PROGRESSIVE_NONE;
+        progressive_reset(&session->estimator);
+    }
+    if (!session->early_active) {
+        return 0;
+    }
+
+    progressive_level_t level = progressive_process_block(&session->estimator, block, num_samples);
+    if (level == PROGRESSIVE_NONE) {
+        return 0;
+    }
+
+    int events = TUNER_SESSION_EARLY | TUNER_SESSION_DETECTED;
+    TuningResult result = analyze_tuning_table(session->tuning, session->estimator.frequency,
+                                               session->target_string);
+    bool renamed = (session->early_level == PROGRESSIVE_NONE) ||
+                   (result.detected_string != session->result.detected_string);
+    session->result = result;
+    session->early_level = level;
+
+    if (level == PROGRESSIVE_FINE) {
+        session->early_active = 0;
+        if (update_feedback(session, SEQUENCER_PART_ALL)) {
+            events |= TUNER_SESSION_FEEDBACK;
+        }
+    } else if (renamed && update_feedback(session, SEQUENCER_PART_STRING)) {
+        events |= TUNER_SESSION_FEEDBACK;
+    }
+    return events;
+}
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+void tuner_session_init(tuner_session_t* session, const tuning_table_t* tuning, int target_string) {
+    memset(session, 0, sizeof(*session));
+    audio_analyzer_init(&session->analyzer);
+    if (tuning == NULL) {
+        tuning = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    }
+    session->tuning = tuning;
+    session->target_string = target_string;
+    session->candidate_string = -1;
+    session->result.detected_string = -1;
+    session->result.direction = "UNKNOWN";
+    audio_analyzer_configure_prefilter(&session->analyzer, PREFILTER_BANDPASS, tuning->min_hz, tuning->max_hz);
+    phase_tracker_init(&session->tracker, (float)SAMPLE_RATE);
+    progressive_init(&session->estimator, tuning);
+    session->quiet = 1;
+}
+
+void tuner_session_set_progressive(tuner_session_t* session, int enabled) {
+    session->progressive = enabled;
+    session->early_active = 0;
+}
+
+void tuner_session_set_fine_tune(tuner_session_t* session, int enabled) {
+    session->fine_tune = enabled;
+    if (!enabled && session->tracker.state != PHASE_TRACKER_IDLE) {
+        phase_tracker_release(&session->tracker);
+        session->analyzer.stream_fill = 0;
+    }
+}
+
+int tuner_session_process_block(tuner_session_t* session, const int16_t* block, int num_samples) {
+    double frequency = 0.0;
+    int events = 0;
+
+    if (session->progressive) {
+        events |= process_early(session, block, num_samples);
+    }
+    if (session->tracker.state != PHASE_TRACKER_IDLE) {
+        return events | process_fine(session, block, num_samples);
+    }
+    if (!audio_analyzer_process_block(&session->analyzer, block, num_samples, &frequency)) {
+        return events;
+    }
+    events |= TUNER_SESSION_FRAME;
+    session->frames++;
+    if (session->fine_holdoff > 0) {
+        session->fine_holdoff--;
+    }
+    if (frequency <= 0.0) {
+        session->stable_frames = 0;
+        return events;
+    }
+
+    TuningResult result = analyze_tuning_table(session->tuning, frequency, session->target_string);
+    if (result.detected_string < 1) {
+        session->stable_frames = 0;
+        return events;
+    }
+    events |= TUNER_SESSION_DETECTED;
+    session->detections++;
+
+    /* Tracker: feedback follows a string only once it has held */
+    if (result.detected_string == session->candidate_string) {
+        session->stable_frames++;
+    } else {
+        session->candidate_string = result.detected_string;
+        session->stable_frames = 1;
+    }
+    if (session->stable_frames >= TUNER_SESSION_STABLE_FRAMES && !session->early_active) {
+        session->result = result;
+        if (update_feedback(session, SEQUENCER_PART_ALL)) {
+            events |= TUNER_SESSION_FEEDBACK;
+        }
+        if (session->fine_tune && session->fine_holdoff == 0 && within_capture(&result)) {
+            phase_tracker_lock(&session->tracker, result.target_frequency);
+        }
+    }
+    return events;
+}
@@ -0,0 +1,138 @@
+/**
+ * tuner_session.h - One independent tuner stream
+ *
+ * Everything a single input needs, with no module statics: its own analyzer
+ * (hum notch, pre-filter, noise floor, stream window), its own tuning
+ * profile and target string, a small string tracker, and the feedback the
+ * sequencer would give for it. Any number of sessions can be processed
+ * side by side, on one core or spread over worker threads:
+ *
+ *     tuner_session_t session;
+ *     tuner_session_init(&session, tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD), 0);
+ *     ...
+ *     int events = tuner_session_process_block(&session, block, 128);
+ *     if (events & TUNER_SESSION_FEEDBACK) {
+ *         // session.phrase / session.beep_interval_ms changed
+ *     }
+ *
+ * - Tracker: a detection only drives feedback once the same string has been
+ *   seen TUNER_SESSION_STABLE_FRAMES frames in a row (a wrong bin on the
+ *   attack does not produce an announcement)
+ * - Feedback is decided, not played: phrase clip names and the beep rate and
+ *   pitch come from the audio_sequencer functions, so a server can hand them
+ *   to whatever renders audio for that stream
+ * - Fine tune (tuner_session_set_fine_tune): once the tracked string is
+ *   within reach of its target, the session hands its input to a
+ *   phase_tracker locked on that target and reports every block at sub-cent
+ *   resolution instead of analyzing frames. When lock is lost it goes back
+ *   to full analysis and waits TUNER_SESSION_FINE_HOLDOFF frames before
+ *   trying again.
+ * - Progressive (tuner_session_set_progressive): a block rising above
+ *   TUNER_SESSION_ONSET_AMPLITUDE after a quieter one starts a
+ *   progressive_estimator. Its coarse estimate, two blocks after the pluck,
+ *   sets a phrase with only the string name; once it is FINE the full
+ *   phrase with cents follows and the frame tracker takes over again.
+ */
+
+#ifndef TUNER_SESSION_H
+#define TUNER_SESSION_H
+
+#include <stdint.h>
+#include "string_detection.h"      // Before audio_sequencer.h: this copy declares the table API
+#include "tuning_table.h"
+#include "audio_processing.h"
+#include "audio_sequencer.h"
+#include "phase_tracker.h"
+#include "progressive_estimator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define TUNER_SESSION_STABLE_FRAMES 3       // Frames on one string before feedback follows it
+#define TUNER_SESSION_FINE_HOLDOFF  16      // Frames of full analysis after a lost lock
+#define TUNER_SESSION_ONSET_AMPLITUDE 200   // Block peak that counts as a pluck after a quieter block
+
+/* Events returned by tuner_session_process_block() */
+#define TUNER_SESSION_FRAME         0x01    // At least one frame was analyzed
+#define TUNER_SESSION_DETECTED      0x02    // The latest frame held a valid note
+#define TUNER_SESSION_FEEDBACK      0x04    // Phrase or beep rate changed
+#define TUNER_SESSION_FINE          0x08    // Result came from the phase tracker
+#define TUNER_SESSION_EARLY         0x10    // Result came from the progressive estimator
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef struct {
+    audio_analyzer_t analyzer;
+    const tuning_table_t* tuning;           // NULL = string_frequencies[]
+    int target_string;                      // 0 = auto-detect
+
+    /* Tracker */
+    TuningResult result;                    // Latest valid detection
+    int candidate_string;
+    uint32_t stable_frames;
+    uint32_t frames;                        // Frames analyzed
+    uint32_t detections;                    // Frames with a valid note
+
+    /* Feedback decision (what audio_sequencer would play) */
+    const char* phrase[SEQUENCER_MAX_PHRASE_CLIPS];
+    int phrase_length;
+    uint32_t beep_interval_ms;              // 0 = in tune, no beeps
+    float beep_pitch;
+    uint32_t feedback_changes;
+
+    /* Fine tune */
+    int fine_tune;                          // Set by tuner_session_set_fine_tune()
+    phase_tracker_t tracker;
+    uint32_t fine_holdoff;                  // Frames before the next lock attempt
+    uint32_t fine_blocks;                   // Blocks reported by the tracker
+    uint32_t fine_losses;
+
+    /* Progressive estimate from the onset */
+    int progressive;                        // Set by tuner_session_set_progressive()
+    progressive_estimator_t estimator;
+    progressive_level_t early_level;        // Confidence of `result` while the estimate runs
+    int early_active;                       // Onset seen, estimate not FINE yet
+    int quiet;                              // Last block was below the onset level
+} tuner_session_t;
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/**
+ * Reset a session (quiet: no console output)
+ *
+ * @param tuning: Profile to tune against, NULL for standard guitar
+ * @param target_string: 1-based string to tune, 0 to follow the played string
+ */
+void tuner_session_init(tuner_session_t* session, const tuning_table_t* tuning, int target_string);
+
+/**
+ * Enable or disable target-locked fine tuning (off after init)
+ */
+void tuner_session_set_fine_tune(tuner_session_t* session, int enabled);
+
+/**
+ * Enable or disable progressive estimates from each onset (off after init)
+ */
+void tuner_session_set_progressive(tuner_session_t* session, int enabled);
+
+/**
+ * Feed contiguous capture samples (10 kHz, any block size)
+ *
+ * @return TUNER_SESSION_* event flags for this call
+ */
+int tuner_session_process_block(tuner_session_t* session, const int16_t* block, int num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TUNER_SESSION_H
@@ -0,0 +1,271 @@
+/**
+ * tuning_table.c - Multi-instrument tuning table loader and lookup
+ *
+ * Built-in profiles are const (flash) data with their lookup index already
+ * filled in. Custom tables are parsed from the binary format described in
+ * tuning_table.h and indexed when they are loaded.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "tuning_table.h"
+
+/* ============================================================================
+ * BUILT-IN PROFILES (const data - stays in flash on Teensy)
+ * ========================================================================== */
+
+/* The lookup index is written out as tuning_table_build_index() computes it
+   (TEST 7 checks that it matches), so no table needs building at run time */
+static const tuning_table_t builtin_tables[TUNING_PROFILE_COUNT] = {
+	[TUNING_PROFILE_GUITAR_STANDARD] = {INSTRUMENT_GUITAR, 6, "Guitar EADGBE", {
+		{329.63f, 2.0f, "E", 4},
+		{246.94f, 2.0f, "B", 3},
+		{196.00f, 2.0f, "G", 3},
+		{146.83f, 2.0f, "D", 3},
+		{110.00f, 2.0f, "A", 2},
+		{ 82.41f, 2.0f, "E", 2}},
+		{5, 4, 3, 2, 1, 0},
+		{95.2108231f, 127.087761f, 169.642807f, 220.000549f, 285.30481f},
+		82.41f, 329.63f},
+	[TUNING_PROFILE_GUITAR_DROP_D] = {INSTRUMENT_GUITAR, 6, "Guitar Drop D", {
+		{329.63f, 2.0f, "E", 4},
+		{246.94f, 2.0f, "B", 3},
+		{196.00f, 2.0f, "G", 3},
+		{146.83f, 2.0f, "D", 3},
+		{110.00f, 2.0f, "A", 2},
+		{ 73.42f, 2.0f, "D", 2}},
+		{5, 4, 3, 2, 1, 0},
+		{89.8676758f, 127.087761f, 169.642807f, 220.000549f, 285.30481f},
+		73.42f, 329.63f},
+	[TUNING_PROFILE_GUITAR_OPEN_G] = {INSTRUMENT_GUITAR, 6, "Guitar Open G", {
+		{293.66f, 2.0f, "D", 4},
+		{246.94f, 2.0f, "B", 3},
+		{196.00f, 2.0f, "G", 3},
+		{146.83f, 2.0f, "D", 3},
+		{ 98.00f, 2.0f, "G", 2},
+		{ 73.42f, 2.0f, "D", 2}},
+		{5, 4, 3, 2, 1, 0},
+		{84.8242874f, 119.955574f, 169.642807f, 220.000549f, 269.288696f},
+		73.42f, 293.66f},
+	[TUNING_PROFILE_GUITAR_7_STANDARD] = {INSTRUMENT_GUITAR_7, 7, "7-String BEADGBE", {
+		{329.63f, 2.0f, "E", 4},
+		{246.94f, 2.0f, "B", 3},
+		{196.00f, 2.0f, "G", 3},
+		{146.83f, 2.0f, "D", 3},
+		{110.00f, 2.0f, "A", 2},
+		{ 82.41f, 2.0f, "E", 2},
+		{ 61.74f, 3.0f, "B", 1}},
+		{6, 5, 4, 3, 2, 1, 0},
+		{71.3301773f, 95.2108231f, 127.087761f, 169.642807f, 220.000549f, 285.30481f},
+		61.74f, 329.63f},
+	[TUNING_PROFILE_BASS_STANDARD] = {INSTRUMENT_BASS, 4, "Bass EADG", {
+		{ 98.00f, 3.0f, "G", 2},
+		{ 73.42f, 3.0f, "D", 2},
+		{ 55.00f, 3.0f, "A", 1},
+		{ 41.20f, 3.0f, "E", 1}},
+		{3, 2, 1, 0},
+		{47.60252f, 63.5460434f, 84.8242874f},
+		41.20f, 98.00f},
+	[TUNING_PROFILE_UKULELE_STANDARD] = {INSTRUMENT_UKULELE, 4, "Ukulele GCEA", {
+		{440.00f, 2.0f, "A", 4},
+		{329.63f, 2.0f, "E", 4},
+		{261.63f, 2.0f, "C", 4},
+		{392.00f, 2.0f, "G", 4}},   /* Re-entrant: string 4 is higher than string 3 */
+		{2, 1, 3, 0},
+		{293.668365f, 359.464813f, 415.307129f},
+		261.63f, 440.00f},
+};
+
+/* ============================================================================
+ * LITTLE-ENDIAN FIELD ACCESS
+ * The format is fixed little-endian so files are portable between the PC
+ * packer and the Teensy regardless of struct padding.
+ * ========================================================================== */
+
+static uint16_t read_u16le(const uint8_t* p) {
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32le(const uint8_t* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float read_f32le(const uint8_t* p) {
+	uint32_t bits = read_u32le(p);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static void write_u16le(uint8_t* p, uint16_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+}
+
+static void write_u32le(uint8_t* p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+static void write_f32le(uint8_t* p, float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	write_u32le(p, bits);
+}
+
+/* ============================================================================
+ * INDEX CONSTRUCTION
+ * ========================================================================== */
+
+/**
+ * Sort string slots by frequency and precompute the split points
+ *
+ * The boundary between two neighbouring strings is their geometric mean,
+ * i.e. the point that is equally many cents away from both targets.
+ * At most 8 strings, so an insertion sort is plenty.
+ */
+void tuning_table_build_index(tuning_table_t* table) {
+	int n = table->string_count;
+
+	for (int i = 0; i < n; i++) {
+		table->sorted[i] = (uint8_t)i;
+	}
+	for (int i = 1; i < n; i++) {
+		uint8_t key = table->sorted[i];
+		int j = i - 1;
+		while (j >= 0 && table->strings[table->sorted[j]].target_hz > table->strings[key].target_hz) {
+			table->sorted[j + 1] = table->sorted[j];
+			j--;
+		}
+		table->sorted[j + 1] = key;
+	}
+
+	for (int i = 0; i + 1 < n; i++) {
+		float lo = table->strings[table->sorted[i]].target_hz;
+		float hi = table->strings[table->sorted[i + 1]].target_hz;
+		table->split_hz[i] = sqrtf(lo * hi);
+	}
+
+	table->min_hz = (n > 0) ? table->strings[table->sorted[0]].target_hz : 0.0f;
+	table->max_hz = (n > 0) ? table->strings[table->sorted[n - 1]].target_hz : 0.0f;
+}
+
+int tuning_table_find_string(const tuning_table_t* table, double frequency) {
+	if (table == NULL || table->string_count == 0) {
+		return -1;
+	}
+
+	/* Find the first split point above the frequency */
+	int lo = 0;
+	int hi = table->string_count - 1;
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		if (frequency < table->split_hz[mid]) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	return table->sorted[lo] + 1;
+}
+
+/* ============================================================================
+ * LOADING AND SAVING
+ * ========================================================================== */
+
+tuning_error_t tuning_table_load_blob(tuning_table_t* table, const void* data, size_t size) {
+	const uint8_t* bytes = (const uint8_t*)data;
+
+	if (table == NULL || bytes == NULL || size < TUNING_HEADER_BYTES) {
+		return TUNING_FORMAT_ERROR;
+	}
+	if (read_u32le(bytes) != TUNING_TABLE_MAGIC || read_u16le(bytes + 4) != TUNING_TABLE_VERSION) {
+		return TUNING_FORMAT_ERROR;
+	}
+
+	uint8_t count = bytes[7];
+	if (count == 0 || count > TUNING_MAX_STRINGS ||
+	    size < (size_t)TUNING_HEADER_BYTES + (size_t)count * TUNING_ENTRY_BYTES) {
+		return TUNING_FORMAT_ERROR;
+	}
+
+	memset(table, 0, sizeof(*table));
+	table->instrument = (instrument_t)bytes[6];
+	table->string_count = count;
+	memcpy(table->name, bytes + 8, TUNING_NAME_LENGTH);
+	table->name[TUNING_NAME_LENGTH] = '\0';
+
+	for (int i = 0; i < count; i++) {
+		const uint8_t* entry = bytes + TUNING_HEADER_BYTES + i * TUNING_ENTRY_BYTES;
+		tuning_string_t* s = &table->strings[i];
+		s->target_hz = read_f32le(entry);
+		s->tolerance_cents = read_f32le(entry + 4);
+		memcpy(s->note_name, entry + 8, 3);
+		s->note_name[3] = '\0';
+		s->octave = (int8_t)entry[11];
+
+		if (!(s->target_hz > 0.0f) || s->tolerance_cents < 0.0f) {
+			return TUNING_FORMAT_ERROR;
+		}
+	}
+
+	tuning_table_build_index(table);
+	return TUNING_OK;
+}
+
+tuning_error_t tuning_table_load_file(tuning_table_t* table, const char* path) {
+	uint8_t buffer[TUNING_TABLE_MAX_BYTES];
+
+	if (table == NULL || path == NULL) {
+		return TUNING_ERROR;
+	}
+
+	FILE* fp = fopen(path, "rb");
+	if (fp == NULL) {
+		printf("ERROR: Cannot open tuning table: %s\n", path);
+		return TUNING_FILE_ERROR;
+	}
+	size_t size = fread(buffer, 1, sizeof(buffer), fp);
+	fclose(fp);
+
+	return tuning_table_load_blob(table, buffer, size);
+}
+
+size_t tuning_table_serialize(const tuning_table_t* table, void* out, size_t capacity) {
+	uint8_t* bytes = (uint8_t*)out;
+	size_t size = TUNING_HEADER_BYTES + (size_t)table->string_count * TUNING_ENTRY_BYTES;
+
+	if (capacity < size) {
+		return 0;
+	}
+
+	memset(bytes, 0, size);
+	write_u32le(bytes, TUNING_TABLE_MAGIC);
+	write_u16le(bytes + 4, TUNING_TABLE_VERSION);
+	bytes[6] = (uint8_t)table->instrument;
+	bytes[7] = table->string_count;
+	size_t name_length = strlen(table->name);
+	if (name_length > TUNING_NAME_LENGTH) {
+		name_length = TUNING_NAME_LENGTH;
+	}
+	memcpy(bytes + 8, table->name, name_length);	/* fixed field, NUL padded by the memset */
+
+	for (int i = 0; i < table->string_count; i++) {
+		uint8_t* entry = bytes + TUNING_HEADER_BYTES + i * TUNING_ENTRY_BYTES;
+		write_f32le(entry, table->strings[i].target_hz);
+		write_f32le(entry + 4, table->strings[i].tolerance_cents);
+		memcpy(entry + 8, table->strings[i].note_name, 3);
+		entry[11] = (uint8_t)table->strings[i].octave;
+	}
+	return size;
+}
+
+const tuning_table_t* tuning_table_builtin(tuning_profile_t profile) {
+	if ((int)profile < 0 || profile >= TUNING_PROFILE_COUNT) {
+		return NULL;
+	}
+	return &builtin_tables[profile];
+}
@@ -0,0 +1,150 @@
+/**
+ * tuning_table.h - Multi-instrument tuning tables
+ *
+ * A tuning table describes one instrument/tuning combination: the instrument
+ * type, the number of strings, and a target frequency and tolerance for each
+ * string. Tables can be linked in as const flash data (built-in profiles) or
+ * loaded at runtime from a compact binary file on the SD card.
+ *
+ * Each table carries a sorted lookup index (precomputed for the built-in
+ * profiles, built once when a table is loaded), so finding the closest
+ * string is a binary search and switching the active profile is
+ * just a pointer swap (see string_detection_set_tuning()).
+ *
+ * BINARY FORMAT (little-endian, no padding):
+ *
+ *   Offset  Size  Field
+ *   ------  ----  ----------------------------------------------
+ *   0       4     magic            "TUNE"
+ *   4       2     version          TUNING_TABLE_VERSION
+ *   6       1     instrument       instrument_t
+ *   7       1     string_count     1..TUNING_MAX_STRINGS
+ *   8       16    name             NUL-padded ASCII
+ *   24      12*N  strings[N]:
+ *                   float32 target_hz
+ *                   float32 tolerance_cents
+ *                   char[3] note_name (NUL-padded, e.g. "E", "F#")
+ *                   int8    octave
+ *
+ * String 1 is always the first entry (highest string on a guitar, matching
+ * the numbering used by TuningResult and the string buttons).
+ */
+
+#ifndef TUNING_TABLE_H
+#define TUNING_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TUNING_TABLE_MAGIC          0x454E5554u  /* "TUNE" read as little-endian u32 */
+#define TUNING_TABLE_VERSION        1
+#define TUNING_MAX_STRINGS          8
+#define TUNING_NAME_LENGTH          16
+#define TUNING_HEADER_BYTES         24
+#define TUNING_ENTRY_BYTES          12
+#define TUNING_TABLE_MAX_BYTES      (TUNING_HEADER_BYTES + TUNING_MAX_STRINGS * TUNING_ENTRY_BYTES)
+
+typedef enum {
+    INSTRUMENT_GUITAR = 0,
+    INSTRUMENT_BASS = 1,
+    INSTRUMENT_UKULELE = 2,
+    INSTRUMENT_GUITAR_7 = 3
+} instrument_t;
+
+/* Built-in profiles linked into flash */
+typedef enum {
+    TUNING_PROFILE_GUITAR_STANDARD = 0,
+    TUNING_PROFILE_GUITAR_DROP_D,
+    TUNING_PROFILE_GUITAR_OPEN_G,
+    TUNING_PROFILE_GUITAR_7_STANDARD,
+    TUNING_PROFILE_BASS_STANDARD,
+    TUNING_PROFILE_UKULELE_STANDARD,
+    TUNING_PROFILE_COUNT
+} tuning_profile_t;
+
+//error codes
+typedef enum {
+    TUNING_OK = 0,
+    TUNING_ERROR = -1,
+    TUNING_FORMAT_ERROR = -2,
+    TUNING_FILE_ERROR = -3
+} tuning_error_t;
+
+typedef struct {
+    float target_hz;            // Ideal open-string frequency
+    float tolerance_cents;      // +/- cents considered "in tune" for this string
+    char note_name[4];          // "E", "F#", ... (NUL terminated)
+    int8_t octave;              // Scientific pitch octave
+} tuning_string_t;
+
+typedef struct {
+    instrument_t instrument;
+    uint8_t string_count;
+    char name[TUNING_NAME_LENGTH + 1];
+    tuning_string_t strings[TUNING_MAX_STRINGS];   // strings[0] = string 1
+
+    /* Lookup index, precomputed for built-ins, built at load time otherwise */
+    uint8_t sorted[TUNING_MAX_STRINGS];            // string slots by ascending frequency
+    float split_hz[TUNING_MAX_STRINGS];            // geometric midpoint between sorted[i] and sorted[i+1]
+    float min_hz;                                  // lowest target in the table
+    float max_hz;                                  // highest target in the table
+} tuning_table_t;
+
+/**
+ * Load a table from its binary representation (flash blob or file contents)
+ * Validates magic, version and string count, then builds the lookup index
+ *
+ * @param table: Destination table
+ * @param data: Serialized table bytes
+ * @param size: Number of bytes available at data
+ * @return: TUNING_OK, or TUNING_FORMAT_ERROR if the data is malformed
+ */
+tuning_error_t tuning_table_load_blob(tuning_table_t* table, const void* data, size_t size);
+
+/**
+ * Load a table from a binary file (e.g. "/TUNINGS/DADGAD.TUN" on the SD card)
+ *
+ * @return: TUNING_OK, TUNING_FILE_ERROR or TUNING_FORMAT_ERROR
+ */
+tuning_error_t tuning_table_load_file(tuning_table_t* table, const char* path);
+
+/**
+ * Serialize a table into the binary format
+ *
+ * @param out: Destination buffer (at least TUNING_TABLE_MAX_BYTES is always enough)
+ * @param capacity: Size of out in bytes
+ * @return: Number of bytes written, 0 if the buffer is too small
+ */
+size_t tuning_table_serialize(const tuning_table_t* table, void* out, size_t capacity);
+
+/**
+ * Build the sorted lookup index (called by the loaders)
+ * Only needed when a table is filled in by hand
+ */
+void tuning_table_build_index(tuning_table_t* table);
+
+/**
+ * Find the string whose target is closest (in cents) to a frequency
+ * Binary search over the precomputed split points: O(log strings)
+ *
+ * @param frequency: Detected frequency in Hz
+ * @return: String number (1-based), or -1 if the table is empty
+ */
+int tuning_table_find_string(const tuning_table_t* table, double frequency);
+
+/**
+ * Get a built-in profile (const data, safe from any thread)
+ *
+ * @return: Pointer to the profile, or NULL for an unknown id
+ */
+const tuning_table_t* tuning_table_builtin(tuning_profile_t profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TUNING_TABLE_H */
@@ -0,0 +1,175 @@
+/**
+ * voice_mixer.c - Block mixer implementation
+ *
+ * Each block every voice renders into its own scratch buffer first, so the
+ * ducking decision for this block is known before anything is mixed. Gains
+ * are tracked in Q30 (Q15 gain << 15) so the per-sample ramp step keeps its
+ * precision over a 128-sample block; the sample multiply stays Q15 x Q15.
+ */
+
+#include "voice_mixer.h"
+#include "hardware_interface.h"
+#include <string.h>
+
+/* ============================================================================
+ * INTERNAL STATE
+ * ========================================================================== */
+
+#define Q15_ONE 32768
+
+typedef struct {
+    voice_render_fn render;
+    void* context;
+    voice_class_t voice_class;
+    int32_t gain;               // Q15, set by the main loop
+    int32_t current;            // Q30, ramped by the audio update
+    bool active;                // Written last when adding, first when removing
+} voice_t;
+
+static voice_t voices[VOICE_MIXER_MAX_VOICES];
+static int16_t scratch[VOICE_MIXER_MAX_VOICES][VOICE_MIXER_BLOCK_SIZE];
+static uint32_t duck_hold = 0;
+
+/* ============================================================================
+ * CONTROL
+ * ========================================================================== */
+
+static int32_t to_q15(float value) {
+    if (value <= 0.0f) {
+        return 0;
+    }
+    if (value >= 1.0f) {
+        return Q15_ONE;
+    }
+    return (int32_t)(value * Q15_ONE + 0.5f);
+}
+
+void voice_mixer_init(void) {
+    memset(voices, 0, sizeof(voices));
+    duck_hold = 0;
+}
+
+int voice_mixer_add(voice_class_t voice_class, voice_render_fn render, void* context, float gain) {
+    if (render == NULL) {
+        return -1;
+    }
+    for (int v = 0; v < VOICE_MIXER_MAX_VOICES; v++) {
+        if (!__atomic_load_n(&voices[v].active, __ATOMIC_ACQUIRE)) {
+            voices[v].render = render;
+            voices[v].context = context;
+            voices[v].voice_class = voice_class;
+            voices[v].gain = to_q15(gain);
+            voices[v].current = 0;          // Fades in over the first block
+            __atomic_store_n(&voices[v].active, true, __ATOMIC_RELEASE);
+            return v;
+        }
+    }
+    return -1;
+}
+
+void voice_mixer_remove(int voice) {
+    if (voice >= 0 && voice < VOICE_MIXER_MAX_VOICES) {
+        __atomic_store_n(&voices[voice].active, false, __ATOMIC_RELEASE);
+    }
+}
+
+void voice_mixer_set_gain(int voice, float gain) {
+    if (voice >= 0 && voice < VOICE_MIXER_MAX_VOICES) {
+        __atomic_store_n(&voices[voice].gain, to_q15(gain), __ATOMIC_RELAXED);
+    }
+}
+
+bool voice_mixer_is_ducking(void) {
+    return __atomic_load_n(&duck_hold, __ATOMIC_RELAXED) > 0;
+}
+
+/* ============================================================================
+ * RENDERING
+ * ========================================================================== */
+
+int voice_mixer_render(int16_t* output, uint32_t num_samples) {
+    int32_t mix[VOICE_MIXER_BLOCK_SIZE];
+    uint32_t sounding[VOICE_MIXER_MAX_VOICES];
+    bool speech = false;
+    int voices_heard = 0;
+
+    if (num_samples > VOICE_MIXER_BLOCK_SIZE) {
+        num_samples = VOICE_MIXER_BLOCK_SIZE;
+    }
+
+    /* Render every voice before mixing so ducking applies from this block */
+    for (int v = 0; v < VOICE_MIXER_MAX_VOICES; v++) {
+        sounding[v] = 0;
+        if (__atomic_load_n(&voices[v].active, __ATOMIC_ACQUIRE)) {
+            sounding[v] = voices[v].render(voices[v].context, scratch[v], num_samples);
+            if (sounding[v] > 0 && voices[v].voice_class == VOICE_SPEECH) {
+                speech = true;
+            }
+        }
+    }
+    if (speech) {
+        duck_hold = VOICE_MIXER_DUCK_HOLD_BLOCKS;
+    } else if (duck_hold > 0) {
+        duck_hold--;
+    }
+
+    const int32_t master = to_q15(volume_get());
+    const int32_t duck = (duck_hold > 0) ? to_q15(VOICE_MIXER_DUCK_LEVEL) : Q15_ONE;
+
+    memset(mix, 0, num_samples * sizeof(int32_t));
+    for (int v = 0; v < VOICE_MIXER_MAX_VOICES; v++) {
+        voice_t* voice = &voices[v];
+        if (!__atomic_load_n(&voice->active, __ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        int32_t target = (__atomic_load_n(&voice->gain, __ATOMIC_RELAXED) * master) >> 15;
+        if (voice->voice_class == VOICE_BEEP) {
+            target = (target * duck) >> 15;
+        }
+        target <<= 15;                                  // Q30
+        int32_t step = (target - voice->current) / (int32_t)num_samples;
+
+        if (sounding[v] == 0) {
+            voice->current = target;                    // Silent: nothing to ramp audibly
+            continue;
+        }
+        voices_heard++;
+
+        const int16_t* samples = scratch[v];
+        int32_t gain = voice->current;
+        if (step == 0) {
+            int32_t g = gain >> 15;
+            for (uint32_t i = 0; i < num_samples; i++) {
+                mix[i] += (samples[i] * g) >> 15;
+            }
+        } else {
+            for (uint32_t i = 0; i < num_samples; i++) {
+                gain += step;
+                mix[i] += (samples[i] * (gain >> 15)) >> 15;
+            }
+        }
+        voice->current = target;
+    }
+
+    for (uint32_t i = 0; i < num_samples; i++) {
+        int32_t s = mix[i];
+        if (s > 32767) {
+            s = 32767;
+        } else if (s < -32768) {
+            s = -32768;
+        }
+        output[i] = (int16_t)s;
+    }
+    return voices_heard;
+}
+
+uint32_t voice_mixer_buffer_source(void* context, int16_t* output, uint32_t num_samples) {
+    const voice_buffer_t* buffer = (const voice_buffer_t*)context;
+    if (buffer == NULL || buffer->samples == NULL || buffer->active == 0) {
+        memset(output, 0, num_samples * sizeof(int16_t));
+        return 0;
+    }
+    memcpy(output, buffer->samples, num_samples * sizeof(int16_t));
+    return buffer->active;
+}
@@ -0,0 +1,121 @@
+/**
+ * voice_mixer.h - Fixed-capacity block mixer for prompts, beeps and passthrough
+ *
+ * Several sounds share the output instead of the newest one cutting off the
+ * last: every voice renders its own 128-sample block, is scaled by a gain
+ * that ramps linearly across the block (no zipper noise or clicks when a
+ * gain changes), and is summed into a 32-bit accumulator that is saturated
+ * once at the end.
+ *
+ *     voice_mixer_init();
+ *     int speech = voice_mixer_add(VOICE_SPEECH, prompt_source, NULL, 1.0f);
+ *     int beeps  = voice_mixer_add(VOICE_BEEP, beep_source, NULL, 0.8f);
+ *     ...
+ *     voice_mixer_render(block, 128);        // Audio update, every block
+ *
+ * - Ducking: while any VOICE_SPEECH voice produces sound, VOICE_BEEP voices
+ *   are pulled down to VOICE_MIXER_DUCK_LEVEL, and come back up only after
+ *   VOICE_MIXER_DUCK_HOLD_BLOCKS of speech silence (no pumping between words)
+ * - Master volume is read from volume_get() once per block and folded into
+ *   every voice's ramp, so knob changes are click-free too
+ * - No allocation, no floating point per sample: gains are Q15
+ */
+
+#ifndef VOICE_MIXER_H
+#define VOICE_MIXER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define VOICE_MIXER_MAX_VOICES          8
+#define VOICE_MIXER_BLOCK_SIZE          128     // Largest block rendered at once (AUDIO_BLOCK_SIZE)
+#define VOICE_MIXER_DUCK_LEVEL          0.25f   // Beep gain under speech (-12 dB)
+#define VOICE_MIXER_DUCK_HOLD_BLOCKS    16      // ~46 ms of speech silence before beeps return
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    VOICE_SPEECH = 0,       // Spoken prompts - duck the beeps
+    VOICE_BEEP,             // Synthesized beeps - ducked under speech
+    VOICE_PASSTHROUGH       // Monitored input or SD playback - never ducked
+} voice_class_t;
+
+/**
+ * Render one block of a voice into `output` (all `num_samples` written)
+ *
+ * @return Samples that carried sound; 0 means the voice was silent
+ */
+typedef uint32_t (*voice_render_fn)(void* context, int16_t* output, uint32_t num_samples);
+
+/**
+ * Voice source that copies a block rendered elsewhere earlier in the update
+ */
+typedef struct {
+    const int16_t* samples;
+    uint32_t active;        // Samples that carried sound (returned as-is)
+} voice_buffer_t;
+
+/* ============================================================================
+ * CONTROL (main loop / setup)
+ * ========================================================================== */
+
+/**
+ * Remove all voices and reset ducking
+ */
+void voice_mixer_init(void);
+
+/**
+ * Add a voice
+ *
+ * @param gain: 0.0 - 1.0, before ducking and master volume
+ * @return Voice id, or -1 if all VOICE_MIXER_MAX_VOICES are in use
+ */
+int voice_mixer_add(voice_class_t voice_class, voice_render_fn render, void* context, float gain);
+
+/**
+ * Remove a voice (it stops being rendered at the next block)
+ */
+void voice_mixer_remove(int voice);
+
+/**
+ * Change a voice's gain; the change is ramped over the next block
+ */
+void voice_mixer_set_gain(int voice, float gain);
+
+/**
+ * @return true while speech is holding the beeps down
+ */
+bool voice_mixer_is_ducking(void);
+
+/* ============================================================================
+ * RENDERING (audio update)
+ * ========================================================================== */
+
+/**
+ * Mix every voice into `output` (overwritten)
+ *
+ * @param num_samples: <= VOICE_MIXER_BLOCK_SIZE
+ * @return Number of voices that carried sound this block
+ */
+int voice_mixer_render(int16_t* output, uint32_t num_samples);
+
+/**
+ * voice_render_fn for a voice_buffer_t context
+ */
+uint32_t voice_mixer_buffer_source(void* context, int16_t* output, uint32_t num_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VOICE_MIXER_H
@@ -0,0 +1,275 @@
+/**
+ * wav_decoder.c - Streaming RIFF/WAVE decoder implementation
+ */
+
+#include "wav_decoder.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DATA_SIZE_UNKNOWN 0xFFFFFFFFu
+
+/* ============================================================================
+ * BYTE SOURCE HELPERS
+ * ========================================================================== */
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * Read exactly `bytes` (the callback may return short counts)
+ */
+static size_t read_full(wav_decoder_t* decoder, uint8_t* buffer, size_t bytes) {
+    size_t total = 0;
+    while (total < bytes) {
+        size_t got = decoder->read(decoder->handle, buffer + total, bytes - total);
+        if (got == 0) {
+            break;
+        }
+        total += got;
+    }
+    return total;
+}
+
+/**
+ * Discard `bytes` from the source without seeking
+ */
+static int skip_bytes(wav_decoder_t* decoder, uint32_t bytes) {
+    while (bytes > 0) {
+        size_t want = (bytes < sizeof(decoder->scratch)) ? bytes : sizeof(decoder->scratch);
+        if (read_full(decoder, decoder->scratch, want) != want) {
+            return 0;
+        }
+        bytes -= (uint32_t)want;
+    }
+    return 1;
+}
+
+size_t wav_read_stdio(void* handle, uint8_t* buffer, size_t bytes) {
+    return fread(buffer, 1, bytes, (FILE*)handle);
+}
+
+/* ============================================================================
+ * HEADER
+ * ========================================================================== */
+
+wav_error_t wav_decoder_open(wav_decoder_t* decoder, wav_read_fn read, void* handle) {
+    uint8_t header[12];
+    int have_fmt = 0;
+
+    if (decoder == NULL || read == NULL) {
+        return WAV_ERROR;
+    }
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->read = read;
+    decoder->handle = handle;
+
+    if (read_full(decoder, header, 12) != 12 ||
+        memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0) {
+        return WAV_FORMAT_ERROR;
+    }
+
+    for (;;) {
+        if (read_full(decoder, header, 8) != 8) {
+            return WAV_FORMAT_ERROR;    // Ran out before the data chunk
+        }
+        uint32_t chunk_size = read_le32(header + 4);
+        uint32_t padded = chunk_size + (chunk_size & 1);
+
+        if (memcmp(header, "fmt ", 4) == 0) {
+            uint32_t keep = (chunk_size < 40) ? chunk_size : 40;
+            if (read_full(decoder, decoder->scratch, keep) != keep ||
+                wav_parse_fmt(decoder->scratch, keep, &decoder->format) != WAV_OK ||
+                !skip_bytes(decoder, padded - keep)) {
+                return WAV_FORMAT_ERROR;
+            }
+            have_fmt = 1;
+        } else if (memcmp(header, "data", 4) == 0) {
+            if (!have_fmt) {
+                return WAV_FORMAT_ERROR;
+            }
+            decoder->bytes_remaining = (chunk_size == 0) ? DATA_SIZE_UNKNOWN : chunk_size;
+            break;
+        } else if (!skip_bytes(decoder, padded)) {
+            return WAV_FORMAT_ERROR;
+        }
+    }
+
+    const wav_format_t* f = &decoder->format;
+    int pcm_ok = (f->format == WAV_FORMAT_PCM &&
+                  (f->bits_per_sample == 8 || f->bits_per_sample == 16 ||
+                   f->bits_per_sample == 24 || f->bits_per_sample == 32));
+    int float_ok = (f->format == WAV_FORMAT_IEEE_FLOAT && f->bits_per_sample == 32);
+    if ((!pcm_ok && !float_ok) || f->channels > WAV_DECODER_MAX_CHANNELS) {
+        return WAV_UNSUPPORTED;
+    }
+    return WAV_OK;
+}
+
+void wav_decoder_set_output_rate(wav_decoder_t* decoder, uint32_t output_rate) {
+    uint32_t input_rate = decoder->format.sample_rate;
+
+    if (output_rate == 0 || output_rate == input_rate) {
+        decoder->output_rate = 0;
+        return;
+    }
+    decoder->output_rate = output_rate;
+    decoder->step = (double)input_rate / output_rate;
+    decoder->position = 0.0;
+    decoder->primed = 0;
+
+    /* Downsampling: 4th-order low-pass at 0.4 * output rate against aliasing
+       (the 20 Hz high-pass half of the band-pass only removes DC) */
+    if (output_rate < input_rate) {
+        biquad_cascade_design(&decoder->anti_alias, PREFILTER_BANDPASS,
+                              20.0f, 0.4f * output_rate, (float)input_rate);
+    } else {
+        biquad_cascade_design(&decoder->anti_alias, PREFILTER_OFF, 0.0f, 0.0f, (float)input_rate);
+    }
+}
+
+/* ============================================================================
+ * DECODING
+ * ========================================================================== */
+
+/**
+ * One sample of any supported encoding as float
+ */
+static float decode_sample(const uint8_t* p, const wav_format_t* f) {
+    switch (f->bits_per_sample) {
+    case 8:
+        return ((float)p[0] - 128.0f) / 128.0f;
+    case 16:
+        return (float)(int16_t)(p[0] | (p[1] << 8)) / 32768.0f;
+    case 24: {
+        /* Place the 3 bytes in the top of an int32 so the sign comes along */
+        int32_t v = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24));
+        return (float)(v >> 8) / 8388608.0f;
+    }
+    default: {
+        uint32_t bits = read_le32(p);
+        if (f->format == WAV_FORMAT_IEEE_FLOAT) {
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        return (float)(int32_t)bits / 2147483648.0f;
+    }
+    }
+}
+
+/**
+ * Refill `decoded` with up to WAV_DECODER_CHUNK_FRAMES mono samples at the file rate
+ */
+static void decode_chunk(wav_decoder_t* decoder) {
+    const wav_format_t* f = &decoder->format;
+    uint32_t frame_bytes = f->block_align;
+    uint32_t bytes_per_sample = f->bits_per_sample / 8;
+    uint32_t want = WAV_DECODER_CHUNK_FRAMES * frame_bytes;
+
+    decoder->decoded_count = 0;
+    decoder->decoded_pos = 0;
+    if (decoder->end_of_stream) {
+        return;
+    }
+
+    if (decoder->bytes_remaining != DATA_SIZE_UNKNOWN && want > decoder->bytes_remaining) {
+        want = decoder->bytes_remaining - decoder->bytes_remaining % frame_bytes;
+    }
+    size_t got = read_full(decoder, decoder->scratch, want);
+    uint32_t frames = (uint32_t)(got / frame_bytes);
+
+    if (got < want || frames == 0) {
+        decoder->end_of_stream = 1;
+    }
+    if (decoder->bytes_remaining != DATA_SIZE_UNKNOWN) {
+        decoder->bytes_remaining -= (uint32_t)got;
+    }
+    decoder->bytes_consumed += (uint32_t)got;
+
+    /* Downmix: average of all channels */
+    float channel_scale = 1.0f / f->channels;
+    for (uint32_t i = 0; i < frames; i++) {
+        const uint8_t* frame = decoder->scratch + i * frame_bytes;
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < f->channels; c++) {
+            sum += decode_sample(frame + c * bytes_per_sample, f);
+        }
+        decoder->decoded[i] = sum * channel_scale;
+    }
+
+    if (decoder->output_rate != 0 && frames > 0) {
+        biquad_cascade_process(&decoder->anti_alias, decoder->decoded, decoder->decoded, frames);
+    }
+    decoder->decoded_count = frames;
+}
+
+/**
+ * Next mono sample at the file rate
+ *
+ * @return 1 if a sample was produced, 0 at end of stream
+ */
+static int next_input(wav_decoder_t* decoder, float* sample) {
+    if (decoder->decoded_pos == decoder->decoded_count) {
+        decode_chunk(decoder);
+        if (decoder->decoded_count == 0) {
+            return 0;
+        }
+    }
+    *sample = decoder->decoded[decoder->decoded_pos++];
+    return 1;
+}
+
+uint32_t wav_decoder_read(wav_decoder_t* decoder, float* output, uint32_t max_samples) {
+    uint32_t written = 0;
+
+    if (decoder->output_rate == 0) {
+        while (written < max_samples && next_input(decoder, &output[written])) {
+            written++;
+        }
+        return written;
+    }
+
+    /* Linear interpolation between x0 and x1; position in [0, 1) */
+    if (!decoder->primed) {
+        if (!next_input(decoder, &decoder->x0) || !next_input(decoder, &decoder->x1)) {
+            return 0;
+        }
+        decoder->primed = 1;
+    }
+    while (written < max_samples) {
+        while (decoder->position >= 1.0) {
+            decoder->x0 = decoder->x1;
+            if (!next_input(decoder, &decoder->x1)) {
+                return written;
+            }
+            decoder->position -= 1.0;
+        }
+        float t = (float)decoder->position;
+        output[written++] = decoder->x0 + t * (decoder->x1 - decoder->x0);
+        decoder->position += decoder->step;
+    }
+    return written;
+}
+
+uint32_t wav_decoder_read_int16(wav_decoder_t* decoder, int16_t* output, uint32_t max_samples) {
+    float block[WAV_DECODER_CHUNK_FRAMES];
+    uint32_t written = 0;
+
+    while (written < max_samples) {
+        uint32_t want = max_samples - written;
+        if (want > WAV_DECODER_CHUNK_FRAMES) {
+            want = WAV_DECODER_CHUNK_FRAMES;
+        }
+        uint32_t got = wav_decoder_read(decoder, block, want);
+        for (uint32_t i = 0; i < got; i++) {
+            int32_t v = (int32_t)(block[i] * 32768.0f);
+            output[written + i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+        }
+        written += got;
+        if (got < want) {
+            break;
+        }
+    }
+    return written;
+}
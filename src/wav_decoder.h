@@ -0,0 +1,100 @@
+/**
+ * wav_decoder.h - Streaming RIFF/WAVE decoder
+ *
+ * Decodes a WAV stream block by block in constant memory, pulling bytes
+ * through a read callback (SD card file, stdio FILE, pipe). Nothing is
+ * seeked, so non-seekable sources work too; chunks before the audio
+ * (LIST, bext, fact, ...) are read and discarded.
+ *
+ * Supported payloads:
+ * - PCM 8 (unsigned), 16, 24 and 32-bit integer
+ * - IEEE float 32-bit
+ * - 1 to WAV_DECODER_MAX_CHANNELS channels, averaged to mono on the fly
+ *
+ * Output is mono float in [-1, 1) at the file's rate, or at a chosen output
+ * rate (anti-alias filter plus linear interpolation) so recordings at
+ * 44.1/48 kHz can feed the 10 kHz analyzer directly.
+ */
+
+#ifndef WAV_DECODER_H
+#define WAV_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "wav_reader.h"
+#include "biquad_filter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WAV_DECODER_MAX_CHANNELS    8
+#define WAV_DECODER_CHUNK_FRAMES    64      // Frames decoded per read callback
+#define WAV_DECODER_SCRATCH_BYTES   (WAV_DECODER_CHUNK_FRAMES * WAV_DECODER_MAX_CHANNELS * 4)
+
+/**
+ * Byte source: copy up to `bytes` into `buffer`
+ *
+ * @return Bytes copied; 0 = end of stream
+ */
+typedef size_t (*wav_read_fn)(void* handle, uint8_t* buffer, size_t bytes);
+
+typedef struct {
+    wav_read_fn read;
+    void* handle;
+    wav_format_t format;
+    uint32_t bytes_remaining;               // Left in the data chunk (0xFFFFFFFF = until EOF)
+    uint32_t bytes_consumed;                // Payload bytes decoded so far
+    int end_of_stream;
+
+    /* Decoded mono samples at the file rate, not yet handed out */
+    float decoded[WAV_DECODER_CHUNK_FRAMES];
+    uint32_t decoded_count;
+    uint32_t decoded_pos;
+
+    /* Optional rate conversion */
+    uint32_t output_rate;                   // 0 = file rate
+    double step;                            // Input samples per output sample
+    double position;                        // Fractional position between x0 and x1
+    float x0, x1;
+    int primed;
+    biquad_cascade_t anti_alias;
+
+    uint8_t scratch[WAV_DECODER_SCRATCH_BYTES];
+} wav_decoder_t;
+
+/**
+ * Read the RIFF header and chunks up to the start of the audio
+ *
+ * @return WAV_OK, WAV_FORMAT_ERROR or WAV_UNSUPPORTED (e.g. 64-bit float)
+ */
+wav_error_t wav_decoder_open(wav_decoder_t* decoder, wav_read_fn read, void* handle);
+
+/**
+ * Resample the output to `output_rate` (0 or the file rate = no conversion)
+ * Call after wav_decoder_open() and before the first read
+ */
+void wav_decoder_set_output_rate(wav_decoder_t* decoder, uint32_t output_rate);
+
+/**
+ * Decode the next samples as mono float
+ *
+ * @return Samples written (less than max_samples only at end of stream)
+ */
+uint32_t wav_decoder_read(wav_decoder_t* decoder, float* output, uint32_t max_samples);
+
+/**
+ * Decode the next samples as mono int16 (for apply_fft / the streaming front end)
+ */
+uint32_t wav_decoder_read_int16(wav_decoder_t* decoder, int16_t* output, uint32_t max_samples);
+
+/**
+ * Read callback for stdio streams (handle = FILE*)
+ */
+size_t wav_read_stdio(void* handle, uint8_t* buffer, size_t bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAV_DECODER_H
@@ -0,0 +1,209 @@
+/**
+ * wav_reader.c - RIFF/WAVE parsing and memory-mapped access
+ *
+ * RIFF layout: "RIFF" <size> "WAVE", then chunks of <id:4> <size:4> <data>,
+ * each padded to an even length. All header fields are little-endian and
+ * read byte-wise so the parser works on unaligned images.
+ */
+
+#ifndef __arm__
+#define _POSIX_C_SOURCE 200112L     // mmap / fstat
+#endif
+
+#include "wav_reader.h"
+#include <string.h>
+
+#ifndef __arm__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* ============================================================================
+ * HEADER PARSING
+ * ========================================================================== */
+
+static uint16_t read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+wav_error_t wav_parse_fmt(const uint8_t* body, uint32_t chunk_size, wav_format_t* format) {
+    if (body == NULL || format == NULL || chunk_size < 16) {
+        return WAV_FORMAT_ERROR;
+    }
+    format->format = read_le16(body);
+    format->channels = read_le16(body + 2);
+    format->sample_rate = read_le32(body + 4);
+    format->block_align = read_le16(body + 12);
+    format->bits_per_sample = read_le16(body + 14);
+
+    /* WAVE_FORMAT_EXTENSIBLE: the real format is the first two
+       bytes of the sub-format GUID */
+    if (format->format == WAV_FORMAT_EXTENSIBLE) {
+        if (chunk_size < 40) {
+            return WAV_FORMAT_ERROR;
+        }
+        format->format = read_le16(body + 24);
+    }
+    if (format->channels == 0 || format->sample_rate == 0 || format->bits_per_sample == 0 ||
+        format->block_align != format->channels * ((format->bits_per_sample + 7) / 8)) {
+        return WAV_FORMAT_ERROR;
+    }
+    return WAV_OK;
+}
+
+wav_error_t wav_parse_header(const uint8_t* data, size_t size, wav_format_t* format) {
+    int have_fmt = 0;
+
+    if (data == NULL || format == NULL || size < 12 ||
+        memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) {
+        return WAV_FORMAT_ERROR;
+    }
+    memset(format, 0, sizeof(*format));
+
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        uint32_t chunk_size = read_le32(chunk + 4);
+        size_t body = pos + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunk_size > size - body || wav_parse_fmt(data + body, chunk_size, format) != WAV_OK) {
+                return WAV_FORMAT_ERROR;
+            }
+            have_fmt = 1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) {
+                return WAV_FORMAT_ERROR;    // fmt must precede data
+            }
+            /* Recorders that were cut off leave a data size past the end
+               (or 0xFFFFFFFF while streaming) - keep what is there */
+            size_t available = size - body;
+            format->data_offset = (uint32_t)body;
+            format->data_size = (chunk_size > available) ? (uint32_t)available : chunk_size;
+            format->data_size -= format->data_size % format->block_align;
+            return WAV_OK;
+        }
+
+        if (chunk_size > size - body) {
+            break;      // Chunk runs past the end and there was no data chunk
+        }
+        pos = body + chunk_size + (chunk_size & 1);
+    }
+    return WAV_FORMAT_ERROR;
+}
+
+/* ============================================================================
+ * BATCH CONVERSION
+ * ========================================================================== */
+
+void wav_int16_to_float(const int16_t* input, float* output, uint32_t num_samples) {
+    const float scale = 1.0f / 32768.0f;
+    uint32_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 8 <= num_samples; i += 8) {
+        __m128i s16 = _mm_loadu_si128((const __m128i*)(input + i));
+        /* Sign-extend to 32 bits: put each sample in the high half, shift back */
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s16, s16), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s16, s16), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+    }
+#endif
+
+    for (; i < num_samples; i++) {
+        output[i] = (float)input[i] * scale;
+    }
+}
+
+/* ============================================================================
+ * MEMORY-MAPPED FILES
+ * ========================================================================== */
+
+#ifndef __arm__
+
+wav_error_t wav_reader_open(wav_reader_t* reader, const char* filename) {
+    struct stat st;
+
+    if (reader == NULL || filename == NULL) {
+        return WAV_ERROR;
+    }
+    memset(reader, 0, sizeof(*reader));
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return WAV_FILE_ERROR;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return WAV_FILE_ERROR;
+    }
+    if (st.st_size < 12) {
+        close(fd);
+        return WAV_FORMAT_ERROR;
+    }
+
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);      // The mapping keeps the file referenced
+    if (map == MAP_FAILED) {
+        return WAV_FILE_ERROR;
+    }
+    reader->map = (const uint8_t*)map;
+    reader->map_size = (size_t)st.st_size;
+
+    wav_error_t err = wav_parse_header(reader->map, reader->map_size, &reader->format);
+    if (err == WAV_OK) {
+        /* Views are handed out as int16_t*: needs 16-bit PCM, an even
+           payload offset (chunks are word aligned) and a little-endian host */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        err = WAV_UNSUPPORTED;
+#else
+        if (reader->format.format != WAV_FORMAT_PCM || reader->format.bits_per_sample != 16 ||
+            (reader->format.data_offset & 1) != 0) {
+            err = WAV_UNSUPPORTED;
+        }
+#endif
+    }
+    if (err != WAV_OK) {
+        wav_reader_close(reader);
+        return err;
+    }
+
+    /* Sequential analysis - let the kernel read ahead aggressively */
+    posix_madvise(map, reader->map_size, POSIX_MADV_SEQUENTIAL);
+
+    reader->samples = (const int16_t*)(reader->map + reader->format.data_offset);
+    reader->num_frames = reader->format.data_size / reader->format.block_align;
+    return WAV_OK;
+}
+
+const int16_t* wav_reader_view(const wav_reader_t* reader, uint32_t first_frame, uint32_t* num_frames) {
+    if (reader->samples == NULL || first_frame >= reader->num_frames) {
+        *num_frames = 0;
+        return NULL;
+    }
+    if (*num_frames > reader->num_frames - first_frame) {
+        *num_frames = reader->num_frames - first_frame;
+    }
+    return reader->samples + (size_t)first_frame * reader->format.channels;
+}
+
+void wav_reader_close(wav_reader_t* reader) {
+    if (reader->map != NULL) {
+        munmap((void*)reader->map, reader->map_size);
+    }
+    memset(reader, 0, sizeof(*reader));
+}
+
+#endif // __arm__
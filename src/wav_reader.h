@@ -0,0 +1,132 @@
+/**
+ * wav_reader.h - Zero-copy WAV access for offline analysis
+ *
+ * wav_parse_header() validates a RIFF/WAVE image held in memory and locates
+ * its PCM payload. On native builds wav_reader_open() memory-maps a file and
+ * hands out const int16_t* views straight into the mapping, so the analyzer
+ * reads the recording with no copies at all:
+ *
+ *     wav_reader_t wav;
+ *     wav_reader_open(&wav, "take1.wav");
+ *     for (uint32_t f = 0; f + 256 <= wav.num_frames; f += 128) {
+ *         uint32_t n = 256;
+ *         const int16_t* frame = wav_reader_view(&wav, f, &n);
+ *         apply_fft(frame, n);
+ *     }
+ *     wav_reader_close(&wav);
+ *
+ * Conversion to float only happens when a consumer asks for it, in batches
+ * (SSE2 on x86, scalar elsewhere).
+ */
+
+#ifndef WAV_READER_H
+#define WAV_READER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * TYPES
+ * ========================================================================== */
+
+typedef enum {
+    WAV_OK = 0,
+    WAV_ERROR = -1,             // Bad arguments
+    WAV_FILE_ERROR = -2,        // Open / stat / mmap failed
+    WAV_FORMAT_ERROR = -3,      // Not RIFF/WAVE, missing or truncated chunks
+    WAV_UNSUPPORTED = -4        // Valid WAV but not zero-copy readable (not 16-bit PCM)
+} wav_error_t;
+
+#define WAV_FORMAT_PCM          1
+#define WAV_FORMAT_IEEE_FLOAT   3
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE
+
+typedef struct {
+    uint16_t format;            // WAV_FORMAT_PCM or WAV_FORMAT_IEEE_FLOAT (extensible resolved)
+    uint16_t channels;
+    uint32_t sample_rate;
+    uint16_t bits_per_sample;
+    uint16_t block_align;       // Bytes per frame (all channels)
+    uint32_t data_offset;       // Byte offset of the first sample
+    uint32_t data_size;         // Payload bytes (clipped to the image)
+} wav_format_t;
+
+typedef struct {
+    wav_format_t format;
+    const int16_t* samples;     // Interleaved frames, inside the mapping
+    uint32_t num_frames;
+    const uint8_t* map;
+    size_t map_size;
+} wav_reader_t;
+
+/* ============================================================================
+ * HEADER PARSING (any platform)
+ * ========================================================================== */
+
+/**
+ * Validate a RIFF/WAVE image and locate its fmt and data chunks
+ * Unknown chunks (LIST, bext, fact, ...) are skipped
+ *
+ * @param data: Start of the file image
+ * @param size: Bytes available
+ * @param format: Filled on success
+ * @return WAV_OK or WAV_FORMAT_ERROR
+ */
+wav_error_t wav_parse_header(const uint8_t* data, size_t size, wav_format_t* format);
+
+/**
+ * Parse the body of a "fmt " chunk (shared with the streaming decoder)
+ *
+ * @param body: Chunk payload (after the 8-byte chunk header)
+ * @param chunk_size: Payload bytes available
+ * @return WAV_OK or WAV_FORMAT_ERROR
+ */
+wav_error_t wav_parse_fmt(const uint8_t* body, uint32_t chunk_size, wav_format_t* format);
+
+/* ============================================================================
+ * BATCH CONVERSION
+ * ========================================================================== */
+
+/**
+ * int16 -> float in [-1, 1), 8 samples per step with SSE2
+ */
+void wav_int16_to_float(const int16_t* input, float* output, uint32_t num_samples);
+
+/* ============================================================================
+ * MEMORY-MAPPED FILES (native only)
+ * ========================================================================== */
+
+#ifndef __arm__
+
+/**
+ * Map a 16-bit PCM WAV file read-only
+ *
+ * @return WAV_OK, WAV_FILE_ERROR, WAV_FORMAT_ERROR or WAV_UNSUPPORTED
+ */
+wav_error_t wav_reader_open(wav_reader_t* reader, const char* filename);
+
+/**
+ * Borrow frames [first_frame, first_frame + *num_frames) without copying
+ * Valid until wav_reader_close()
+ *
+ * @param num_frames: In: frames wanted, out: frames available (clipped at end)
+ * @return Pointer into the mapping, or NULL past the end
+ */
+const int16_t* wav_reader_view(const wav_reader_t* reader, uint32_t first_frame, uint32_t* num_frames);
+
+/**
+ * Unmap the file
+ */
+void wav_reader_close(wav_reader_t* reader);
+
+#endif // __arm__
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAV_READER_H
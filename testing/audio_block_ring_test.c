@@ -0,0 +1,117 @@
+//audio block ring test function - build with: gcc -std=c99 -O2 -pthread audio_block_ring_test.c
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "../src/audio_block_ring.c"
+
+#define TOTAL_BLOCKS 2000000
+
+static audio_block_ring_t ring;
+static uint32_t producer_retries = 0;
+
+// every sample of a block encodes its sequence number, so a torn block
+// (half old, half new) or a dropped/reordered block is detectable
+static void fill_block(int16_t *block, uint32_t sequence) {
+    for (int i = 0; i < AUDIO_RING_BLOCK_SIZE; i++) {
+        block[i] = (int16_t)((sequence * 131u + (uint32_t)i) & 0x7FFF);
+    }
+}
+
+static void *producer(void *arg) {
+    (void)arg;
+    for (uint32_t sequence = 0; sequence < TOTAL_BLOCKS; sequence++) {
+        int16_t *slot;
+        // alternate zero-copy and copying writes
+        if (sequence & 1) {
+            while ((slot = audio_ring_write_acquire(&ring)) == NULL) {
+                producer_retries++;
+                sched_yield();
+            }
+            fill_block(slot, sequence);
+            audio_ring_write_commit(&ring);
+        } else {
+            int16_t block[AUDIO_RING_BLOCK_SIZE];
+            fill_block(block, sequence);
+            while (!audio_ring_push(&ring, block)) {
+                producer_retries++;
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+// two threads hammer the ring; the consumer must see every block, in order, intact
+static int test_two_threads(void) {
+    pthread_t thread;
+    uint32_t expected = 0;
+    uint32_t torn = 0;
+    uint32_t out_of_order = 0;
+
+    audio_ring_init(&ring);
+    pthread_create(&thread, NULL, producer, NULL);
+
+    while (expected < TOTAL_BLOCKS) {
+        const int16_t *block = audio_ring_read_acquire(&ring);
+        if (block == NULL) {
+            sched_yield();
+            continue;
+        }
+        uint32_t sequence = expected;
+        if (block[0] != (int16_t)((sequence * 131u) & 0x7FFF)) {
+            out_of_order++;
+        }
+        for (int i = 1; i < AUDIO_RING_BLOCK_SIZE; i++) {
+            if (block[i] != (int16_t)((sequence * 131u + (uint32_t)i) & 0x7FFF)) {
+                torn++;
+                break;
+            }
+        }
+        audio_ring_read_release(&ring);
+        expected++;
+    }
+    pthread_join(thread, NULL);
+
+    // the producer waited out every full ring, so nothing counts as dropped
+    int pass = (torn == 0 && out_of_order == 0 && audio_ring_count(&ring) == 0 &&
+                audio_ring_overruns(&ring) == 0);
+    printf("Two threads, %d blocks | %s (torn %u, out of order %u, full %u, dropped %u, empty %u)\n",
+           TOTAL_BLOCKS, pass ? "PASS" : "FAIL", torn, out_of_order, producer_retries,
+           audio_ring_overruns(&ring), audio_ring_underruns(&ring));
+    return pass;
+}
+
+// a stalled consumer: the ring fills, extra blocks are refused and the ones
+// given up on are counted, and the queued blocks come out untouched
+static int test_overrun_underrun(void) {
+    int16_t block[AUDIO_RING_BLOCK_SIZE];
+
+    audio_ring_init(&ring);
+    for (uint32_t sequence = 0; sequence < AUDIO_RING_BLOCKS + 5; sequence++) {
+        fill_block(block, sequence);
+        if (!audio_ring_push(&ring, block)) {
+            audio_ring_write_drop(&ring);
+        }
+    }
+    int pass = (audio_ring_count(&ring) == AUDIO_RING_BLOCKS && audio_ring_overruns(&ring) == 5);
+
+    for (uint32_t sequence = 0; sequence < AUDIO_RING_BLOCKS; sequence++) {
+        pass &= audio_ring_pop(&ring, block);
+        pass &= (block[0] == (int16_t)((sequence * 131u) & 0x7FFF));
+    }
+    pass &= !audio_ring_pop(&ring, block);
+    pass &= (audio_ring_underruns(&ring) == 1);
+
+    printf("Overrun/underrun counters | %s (overruns %u, underruns %u)\n",
+           pass ? "PASS" : "FAIL", audio_ring_overruns(&ring), audio_ring_underruns(&ring));
+    return pass;
+}
+
+int main() {
+    int passed = 0;
+    passed += test_overrun_underrun();
+    passed += test_two_threads();
+    printf("Audio block ring: %d/2 PASSED\n", passed);
+    return passed == 2 ? 0 : 1;
+}
@@ -1,6 +1,47 @@
 //noise filtering test function
 #include "../src/noise_filtering.c"
 
+// brute-force reference: causal median of the last `window` samples (fewer during warm-up)
+static float reference_causal_median(const float *input, int index, int window) {
+    float buffer[MEDIAN_FILTER_MAX_WINDOW];
+    int start = index - window + 1;
+    if (start < 0) start = 0;
+    int size = 0;
+    for (int j = start; j <= index; j++) {
+        buffer[size++] = input[j];
+    }
+    return find_median(buffer, size);
+}
+
+// streaming filter fed in 128-sample blocks must match the reference exactly
+static int test_streaming_median(int window) {
+    enum { LENGTH = 1000, BLOCK = 128 };
+    static float input[LENGTH];
+    static float output[LENGTH];
+    float storage[MEDIAN_FILTER_STORAGE(window)];   // sized exactly, even windows included
+    median_filter_state_t state;
+
+    srand(1234 + window);
+    for (int i = 0; i < LENGTH; i++) {
+        input[i] = (float)(rand() % 2000 - 1000) / 10.0f;
+    }
+
+    median_filter_init(&state, window, storage);
+    for (int i = 0; i < LENGTH; i += BLOCK) {
+        int n = (LENGTH - i < BLOCK) ? LENGTH - i : BLOCK;
+        median_filter_process(&state, &input[i], &output[i], n);
+    }
+
+    int errors = 0;
+    for (int i = 0; i < LENGTH; i++) {
+        if (output[i] != reference_causal_median(input, i, state.window)) {
+            errors++;
+        }
+    }
+    printf("Streaming median w=%-3d | %s (%d mismatches)\n", window, errors ? "FAIL" : "PASS", errors);
+    return errors == 0;
+}
+
 int main() {
     // test case: 20 samples with some noise spikes
     float input[20] = {
@@ -9,18 +50,27 @@ int main() {
         11.0, -50.0, 13.0, 14.0, 15.0, // spike at index 11 (value -50.0)
         16.0, 17.0, 18.0, 19.0, 20.0
     };
-    
+
     float output[20];
-    
+
     // Apply median filter with window size 5
     median_filter(input, output, 20, 5);
-    
+
     // Print results
     printf("Index | Input    | Output\n");
     printf("------|----------|--------\n");
     for (int i = 0; i < 20; i++) {
         printf("%5d | %8.2f | %8.2f\n", i, input[i], output[i]);
     }
-    
-    return 0;
-}
\ No newline at end of file
+
+    // streaming median: sorting-network path (w <= 9) and sorted-window path
+    printf("\n");
+    int windows[] = {3, 5, 7, 9, 10, 11, 31, 101};
+    int passed = 0;
+    for (int i = 0; i < 8; i++) {
+        passed += test_streaming_median(windows[i]);
+    }
+    printf("Streaming median: %d/8 PASSED\n", passed);
+
+    return passed == 8 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+//prompt bundle packer - packs a folder of WAV prompts into one PROMPTS.BIN
+//build from the repo root with:
+//  gcc -std=c99 -O2 -I"Guitar Unit Testing Files" -Isrc tools/prompt_packer.c src/prompt_cache.c
+//      src/prompt_bundle.c src/wav_decoder.c src/wav_reader.c src/biquad_filter.c -lm -o prompt_packer
+//usage: prompt_packer <wav_folder> <bundle_out>
+//each prompt is keyed by its file name (E.WAV, UP.WAV, ...), decoded to mono
+//44.1 kHz int16 the same way the firmware's loose-file loader does it
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include "config.h"
+#include "prompt_bundle.h"
+#include "prompt_cache.h"
+
+static int is_wav(const char *name) {
+    size_t len = strlen(name);
+    return len > 4 && (strcmp(name + len - 4, ".wav") == 0 || strcmp(name + len - 4, ".WAV") == 0);
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <wav_folder> <bundle_out>\n", argv[0]);
+        return 2;
+    }
+
+    DIR *dir = opendir(argv[1]);
+    if (dir == NULL) {
+        fprintf(stderr, "cannot open folder %s\n", argv[1]);
+        return 1;
+    }
+
+    // sorted so the same folder always gives a byte-identical bundle
+    char *names[PROMPT_BUNDLE_MAX_ENTRIES];
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!is_wav(entry->d_name)) continue;
+        if (count == PROMPT_BUNDLE_MAX_ENTRIES || count == PROMPT_CACHE_MAX_CLIPS) {
+            fprintf(stderr, "too many prompts (max %d)\n", PROMPT_CACHE_MAX_CLIPS);
+            closedir(dir);
+            return 1;
+        }
+        names[count++] = strdup(entry->d_name);
+    }
+    closedir(dir);
+    qsort(names, (size_t)count, sizeof(names[0]), compare_names);
+
+    char root[MAX_FILENAME_LENGTH];
+    snprintf(root, sizeof(root), "%s/", argv[1]);
+
+    prompt_cache_init();
+    for (int i = 0; i < count; i++) {
+        prompt_cache_error_t err = prompt_cache_load_file(names[i], root);
+        if (err != PROMPT_CACHE_OK) {
+            fprintf(stderr, "%s: cannot decode (error %d)\n", names[i], err);
+            return 1;
+        }
+    }
+
+    const char *clip_names[PROMPT_BUNDLE_MAX_ENTRIES];
+    const int16_t *clip_samples[PROMPT_BUNDLE_MAX_ENTRIES];
+    uint32_t clip_lengths[PROMPT_BUNDLE_MAX_ENTRIES];
+    for (int i = 0; i < count; i++) {
+        const prompt_clip_t *clip = prompt_cache_clip(i);
+        clip_names[i] = clip->name;
+        clip_samples[i] = clip->samples;
+        clip_lengths[i] = clip->num_samples;
+        printf("  %-24s %7u samples (%.2f s)\n", clip->name, clip->num_samples,
+               clip->num_samples / (double)PROMPT_CACHE_SAMPLE_RATE);
+    }
+
+    FILE *out = fopen(argv[2], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "cannot create %s\n", argv[2]);
+        return 1;
+    }
+    prompt_bundle_error_t err = prompt_bundle_write(out, PROMPT_CACHE_SAMPLE_RATE, count,
+                                                    clip_names, clip_samples, clip_lengths);
+    long size = ftell(out);
+    if (fclose(out) != 0 || err != PROMPT_BUNDLE_OK) {
+        fprintf(stderr, "writing %s failed (error %d)\n", argv[2], err);
+        return 1;
+    }
+
+    printf("%s: %d prompts, %ld bytes\n", argv[2], count, size);
+    for (int i = 0; i < count; i++) free(names[i]);
+    return 0;
+}
@@ -0,0 +1,322 @@
+//streaming tuner daemon - runs the real analysis pipeline on PCM from stdin or a FIFO
+//build from the repo root with (CMSIS mock on the include path as in the native env):
+//  gcc -std=c99 -O2 -pthread -I"Guitar Unit Testing Files" -ICMSIS-DSP-Tests -Isrc tools/tuner_daemon.c
+//      $(ls src/*.c | grep -v -e main -e button_input -e teensy_audio_io) -lm -o tuner_daemon
+//usage: tuner_daemon [-i input] [-o output] [-f wav|raw] [-r rate] [-c channels] [-L]
+//  -i  file or FIFO to read (default: stdin)
+//  -o  where result records go (default: stdout)
+//  -f  wav (default) or raw little-endian s16 PCM
+//  -r  raw input sample rate (default 44100), -c raw channel count (default 1)
+//  -L  refine again on the 1024-sample history (low strings within a cent, ~4x the refinement cost)
+//examples:
+//  arecord -f S16_LE -r 44100 -c 1 -t raw | tuner_daemon -f raw
+//  tuner_daemon -i recording.wav -o results.jsonl
+//
+//three threads connected by lock-free SPSC queues:
+//  capture   decode + resample to the analyzer rate, push 128-sample blocks (audio_block_ring)
+//  analysis  streaming front end (hum notch, 256-point frames every 128 samples), string match
+//  feedback  one JSON record per detected frame, then throughput and latency stats on stderr
+//
+//the capture thread waits when the analysis falls behind instead of dropping blocks, so a
+//file is analyzed completely at full speed; a live source is absorbed by the pipe buffer
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "audio_processing.h"
+#include "string_detection.h"
+#include "audio_block_ring.h"
+#include "wav_decoder.h"
+
+#define RESULT_SLOTS 256                    // power of two
+#define MAX_LATENCIES (1 << 20)
+
+typedef struct {
+    double time_s;                          // audio time at the end of the frame
+    double frequency;
+    float confidence;
+    TuningResult result;
+    uint64_t latency_ns;                    // block captured -> record written
+    uint64_t captured_ns;
+} result_record_t;
+
+//---------------- shared state ----------------
+
+static audio_block_ring_t block_ring;
+static uint64_t block_stamps[AUDIO_RING_BLOCKS];    // capture time per ring slot, published with the block
+static result_record_t results[RESULT_SLOTS];
+static uint32_t results_head = 0;                   // analysis thread
+static uint32_t results_tail = 0;                   // feedback thread
+static int capture_done = 0;
+static int analysis_done = 0;
+static uint64_t capture_waits = 0;
+static uint64_t analyzed_samples = 0;
+
+static const char *output_path = NULL;
+
+//---------------- input ----------------
+
+typedef struct {
+    FILE *file;
+    bool raw;
+    uint8_t header[44];                     // synthesized streaming header for raw input
+    size_t header_left;
+} input_t;
+
+static void put_le16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put_le32(uint8_t *p, uint32_t v) { put_le16(p, (uint16_t)v); put_le16(p + 2, (uint16_t)(v >> 16)); }
+
+//raw PCM goes through the same decoder (downmix + resampler) behind a WAV header with
+//unknown sizes, exactly what arecord writes when streaming to a pipe
+static void make_raw_header(input_t *in, uint32_t rate, uint16_t channels) {
+    uint8_t *h = in->header;
+    memcpy(h, "RIFF", 4);
+    put_le32(h + 4, 0xFFFFFFFFu);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put_le32(h + 16, 16);
+    put_le16(h + 20, 1);                    // PCM
+    put_le16(h + 22, channels);
+    put_le32(h + 24, rate);
+    put_le32(h + 28, rate * channels * 2);
+    put_le16(h + 32, (uint16_t)(channels * 2));
+    put_le16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    put_le32(h + 40, 0xFFFFFFFFu);
+    in->header_left = sizeof(in->header);
+}
+
+static size_t input_read(void *handle, uint8_t *buffer, size_t bytes) {
+    input_t *in = (input_t *)handle;
+    if (in->header_left > 0) {
+        size_t n = bytes < in->header_left ? bytes : in->header_left;
+        memcpy(buffer, in->header + sizeof(in->header) - in->header_left, n);
+        in->header_left -= n;
+        return n;
+    }
+    return fread(buffer, 1, bytes, in->file);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void wait_briefly(void) {
+    struct timespec ts = { 0, 50000 };      // 50 us
+    nanosleep(&ts, NULL);
+}
+
+//---------------- capture thread ----------------
+
+static void *capture_thread(void *arg) {
+    static wav_decoder_t decoder;
+    input_t *in = (input_t *)arg;
+    int16_t block[AUDIO_RING_BLOCK_SIZE];
+
+    if (wav_decoder_open(&decoder, input_read, in) != WAV_OK) {
+        fprintf(stderr, "tuner_daemon: input is not a supported WAV stream\n");
+        __atomic_store_n(&capture_done, 1, __ATOMIC_RELEASE);
+        return NULL;
+    }
+    wav_decoder_set_output_rate(&decoder, SAMPLE_RATE);
+
+    for (;;) {
+        uint32_t got = wav_decoder_read_int16(&decoder, block, AUDIO_RING_BLOCK_SIZE);
+        if (got == 0) {
+            break;
+        }
+        memset(block + got, 0, (AUDIO_RING_BLOCK_SIZE - got) * sizeof(int16_t));
+
+        int16_t *slot;
+        while ((slot = audio_ring_write_acquire(&block_ring)) == NULL) {
+            capture_waits++;                // back-pressure, not loss
+            wait_briefly();
+        }
+        memcpy(slot, block, sizeof(block));
+        block_stamps[block_ring.head & (AUDIO_RING_BLOCKS - 1)] = now_ns();
+        audio_ring_write_commit(&block_ring);
+    }
+    __atomic_store_n(&capture_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+//---------------- analysis thread ----------------
+
+static void *analysis_thread(void *arg) {
+    (void)arg;
+    uint64_t samples = 0;
+
+    for (;;) {
+        const int16_t *block = audio_ring_read_acquire(&block_ring);
+        if (block == NULL) {
+            if (__atomic_load_n(&capture_done, __ATOMIC_ACQUIRE) && audio_ring_count(&block_ring) == 0) {
+                break;
+            }
+            wait_briefly();
+            continue;
+        }
+        uint64_t stamp = block_stamps[block_ring.tail & (AUDIO_RING_BLOCKS - 1)];
+        double frequency = 0.0;
+        int analyzed = audio_processing_process_block(block, AUDIO_RING_BLOCK_SIZE, &frequency);
+        audio_ring_read_release(&block_ring);
+        samples += AUDIO_RING_BLOCK_SIZE;
+
+        if (!analyzed || frequency <= 0.0) {
+            continue;
+        }
+        while (results_head - __atomic_load_n(&results_tail, __ATOMIC_ACQUIRE) >= RESULT_SLOTS) {
+            wait_briefly();
+        }
+        result_record_t *record = &results[results_head & (RESULT_SLOTS - 1)];
+        record->time_s = (double)samples / SAMPLE_RATE;
+        record->frequency = frequency;
+        record->confidence = audio_processing_last_confidence();
+        record->result = analyze_tuning_auto(frequency);
+        record->captured_ns = stamp;
+        __atomic_store_n(&results_head, results_head + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&analyzed_samples, samples, __ATOMIC_RELAXED);
+    __atomic_store_n(&analysis_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+//---------------- feedback thread ----------------
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void *feedback_thread(void *arg) {
+    FILE *out = (FILE *)arg;
+    uint64_t *latencies = malloc(MAX_LATENCIES * sizeof(uint64_t));
+    size_t count = 0;
+    uint64_t records = 0;
+
+    for (;;) {
+        uint32_t tail = results_tail;
+        if (tail == __atomic_load_n(&results_head, __ATOMIC_ACQUIRE)) {
+            if (__atomic_load_n(&analysis_done, __ATOMIC_ACQUIRE) &&
+                tail == __atomic_load_n(&results_head, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            fflush(out);
+            wait_briefly();
+            continue;
+        }
+        const result_record_t *record = &results[tail & (RESULT_SLOTS - 1)];
+        const TuningResult *r = &record->result;
+        fprintf(out, "{\"time\":%.4f,\"frequency\":%.2f,\"confidence\":%.2f,\"string\":%d,"
+                     "\"note\":\"%s\",\"octave\":%d,\"target\":%.2f,\"cents\":%.1f,\"direction\":\"%s\"}\n",
+                record->time_s, record->frequency, record->confidence, r->detected_string,
+                r->note_name ? r->note_name : "", r->octave, r->target_frequency, r->cents_offset,
+                r->direction ? r->direction : "");
+        uint64_t latency = now_ns() - record->captured_ns;
+        __atomic_store_n(&results_tail, tail + 1, __ATOMIC_RELEASE);
+
+        records++;
+        if (latencies != NULL && count < MAX_LATENCIES) {
+            latencies[count++] = latency;
+        }
+    }
+    fflush(out);
+
+    if (latencies != NULL && count > 0) {
+        qsort(latencies, count, sizeof(uint64_t), compare_u64);
+        fprintf(stderr, "records: %llu  latency p50 %.3f ms  p99 %.3f ms  max %.3f ms\n",
+                (unsigned long long)records, latencies[count / 2] / 1e6,
+                latencies[(count * 99) / 100] / 1e6, latencies[count - 1] / 1e6);
+    } else {
+        fprintf(stderr, "records: %llu\n", (unsigned long long)records);
+    }
+    free(latencies);
+    return NULL;
+}
+
+//---------------- main ----------------
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-i input] [-o output] [-f wav|raw] [-r rate] [-c channels] [-L]\n", name);
+}
+
+int main(int argc, char **argv) {
+    static input_t in;
+    const char *input_path = NULL;
+    uint32_t raw_rate = 44100;
+    uint16_t raw_channels = 1;
+    bool long_refinement = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "i:o:f:r:c:Lh")) != -1) {
+        switch (opt) {
+            case 'i': input_path = optarg; break;
+            case 'o': output_path = optarg; break;
+            case 'f':
+                if (strcmp(optarg, "raw") == 0) in.raw = true;
+                else if (strcmp(optarg, "wav") != 0) { usage(argv[0]); return 2; }
+                break;
+            case 'r': raw_rate = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'c': raw_channels = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 'L': long_refinement = true; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (raw_rate == 0 || raw_channels == 0 || raw_channels > WAV_DECODER_MAX_CHANNELS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    in.file = (input_path == NULL || strcmp(input_path, "-") == 0) ? stdin : fopen(input_path, "rb");
+    if (in.file == NULL) {
+        fprintf(stderr, "cannot open %s\n", input_path);
+        return 1;
+    }
+    if (in.raw) {
+        make_raw_header(&in, raw_rate, raw_channels);
+    }
+    FILE *out = (output_path == NULL) ? stdout : fopen(output_path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "cannot create %s\n", output_path);
+        return 1;
+    }
+
+    //analysis state is owned by the analysis thread from here on; keep init chatter off the record stream
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    if (out == stdout) {
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+    audio_processing_init();
+    audio_processing_set_long_refinement(long_refinement);
+    string_detection_init();
+    fflush(stdout);
+    if (out == stdout) {
+        dup2(saved_stdout, STDOUT_FILENO);
+    }
+    close(saved_stdout);
+    audio_ring_init(&block_ring);
+
+    pthread_t capture, analysis, feedback;
+    uint64_t start = now_ns();
+    pthread_create(&feedback, NULL, feedback_thread, out);
+    pthread_create(&analysis, NULL, analysis_thread, NULL);
+    pthread_create(&capture, NULL, capture_thread, &in);
+    pthread_join(capture, NULL);
+    pthread_join(analysis, NULL);
+    pthread_join(feedback, NULL);
+    double elapsed = (now_ns() - start) / 1e9;
+
+    double audio_s = (double)analyzed_samples / SAMPLE_RATE;
+    fprintf(stderr, "audio: %.2f s in %.3f s wall (%.1fx real time)  capture waits: %llu\n",
+            audio_s, elapsed, elapsed > 0 ? audio_s / elapsed : 0.0, (unsigned long long)capture_waits);
+
+    if (in.file != stdin) fclose(in.file);
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,353 @@
+//multi-stream tuner service - thousands of independent tuner sessions on a pinned worker pool
+//build from the repo root with (CMSIS mock on the include path as in the native env):
+//  gcc -std=c99 -O2 -pthread -Isrc -I"Guitar Unit Testing Files" -ICMSIS-DSP-Tests tools/tuner_service.c
+//      $(ls src/*.c | grep -v -e main -e button_input -e teensy_audio_io) -lm -o tuner_service
+//usage: tuner_service [-s sessions] [-w workers] [-d seconds] [-b batch] [-S]
+//  -s  sessions to run (default 1024)
+//  -w  worker threads, one per core (default: all online cores)
+//  -d  seconds of audio per session (default 5)
+//  -b  sessions per batch (default 16)
+//  -S  sweep 1..workers and print sessions per core for each
+//
+//the built-in load generator gives every session its own plucked string (six strings,
+//several detunings, staggered starts) and reports how many sessions one core keeps up
+//with in real time, plus the share of sessions that ended on the right string
+//
+//engine:
+//  - sessions live in one array, split into one contiguous range per worker; each worker
+//    initializes its own range, so the memory is first touched (and placed) by its core
+//  - workers are pinned to a core and process their range in batches: for every session
+//    in a batch the input pointers are gathered first and the next session is prefetched
+//    while the current one is analyzed
+//  - the service advances in ticks of one 128-sample block (12.8 ms of audio) per session;
+//    a tick is one barrier round, so tick time against 12.8 ms is the real-time margin
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "tuner_session.h"
+
+#define BLOCK_SAMPLES 128
+#define BLOCK_PERIOD_S ((double)BLOCK_SAMPLES / SAMPLE_RATE)
+#define MAX_WORKERS 256
+#define MAX_BATCH 64
+
+//---------------- engine ----------------
+
+//input for session `index` at `tick`: BLOCK_SAMPLES contiguous samples, or NULL for silence
+typedef const int16_t *(*service_input_fn)(void *context, uint32_t index, uint32_t tick);
+//called on the worker thread when a session reports TUNER_SESSION_FEEDBACK
+typedef void (*service_feedback_fn)(void *context, uint32_t index, const tuner_session_t *session);
+
+typedef struct service service_t;
+
+typedef struct {
+    service_t *service;
+    uint32_t id;
+    int cpu;
+    uint32_t begin, end;                    // session range
+    uint64_t feedback_events;
+} worker_t;
+
+struct service {
+    tuner_session_t *sessions;
+    uint32_t session_count;
+    uint32_t worker_count;
+    uint32_t batch;
+    service_input_fn input;
+    service_feedback_fn feedback;
+    void *context;
+    worker_t workers[MAX_WORKERS];
+    pthread_t threads[MAX_WORKERS];
+    pthread_barrier_t start, done;
+    uint32_t tick;
+    bool stop;
+};
+
+static const int16_t silence[BLOCK_SAMPLES];
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        fprintf(stderr, "tuner_service: could not pin a worker to cpu %d\n", cpu);
+    }
+}
+
+static void run_batch(worker_t *worker, uint32_t first, uint32_t count, uint32_t tick) {
+    service_t *service = worker->service;
+    const int16_t *blocks[MAX_BATCH];
+
+    for (uint32_t i = 0; i < count; i++) {
+        const int16_t *block = service->input(service->context, first + i, tick);
+        blocks[i] = block ? block : silence;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        tuner_session_t *session = &service->sessions[first + i];
+        if (i + 1 < count) {
+            __builtin_prefetch(&service->sessions[first + i + 1].analyzer.stream_window);
+            __builtin_prefetch(blocks[i + 1]);
+        }
+        int events = tuner_session_process_block(session, blocks[i], BLOCK_SAMPLES);
+        if ((events & TUNER_SESSION_FEEDBACK) && service->feedback != NULL) {
+            service->feedback(service->context, first + i, session);
+            worker->feedback_events++;
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *worker = (worker_t *)arg;
+    service_t *service = worker->service;
+
+    if (worker->cpu >= 0) {
+        pin_to_cpu(worker->cpu);
+    }
+    for (uint32_t i = worker->begin; i < worker->end; i++) {
+        tuner_session_init(&service->sessions[i], NULL, 0);
+    }
+    pthread_barrier_wait(&service->done);   // initialized
+
+    for (;;) {
+        pthread_barrier_wait(&service->start);
+        if (service->stop) {
+            break;
+        }
+        for (uint32_t first = worker->begin; first < worker->end; first += service->batch) {
+            uint32_t count = worker->end - first;
+            run_batch(worker, first, count < service->batch ? count : service->batch, service->tick);
+        }
+        pthread_barrier_wait(&service->done);
+    }
+    return NULL;
+}
+
+static service_t *service_create(uint32_t sessions, uint32_t workers, uint32_t batch, service_input_fn input,
+                                 service_feedback_fn feedback, void *context) {
+    service_t *service = calloc(1, sizeof(service_t));
+    if (service == NULL) {
+        return NULL;
+    }
+    //64-byte aligned, and every range boundary below falls on a line start,
+    //so no two workers' ranges share a cache line
+    size_t bytes = ((size_t)sessions * sizeof(tuner_session_t) + 63) & ~(size_t)63;
+    service->sessions = aligned_alloc(64, bytes);
+    if (service->sessions == NULL) {
+        free(service);
+        return NULL;
+    }
+    service->session_count = sessions;
+    service->worker_count = workers;
+    service->batch = batch;
+    service->input = input;
+    service->feedback = feedback;
+    service->context = context;
+    pthread_barrier_init(&service->start, NULL, workers + 1);
+    pthread_barrier_init(&service->done, NULL, workers + 1);
+
+    //smallest run of sessions spanning whole cache lines
+    uint32_t step = 1;
+    while ((step * sizeof(tuner_session_t)) % 64 != 0) {
+        step++;
+    }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (uint32_t w = 0; w < workers; w++) {
+        worker_t *worker = &service->workers[w];
+        worker->service = service;
+        worker->id = w;
+        worker->cpu = (cpus > 0) ? (int)(w % (uint32_t)cpus) : -1;
+        worker->begin = (uint32_t)((uint64_t)sessions * w / workers) / step * step;
+        worker->end = (w + 1 == workers) ? sessions
+                                         : (uint32_t)((uint64_t)sessions * (w + 1) / workers) / step * step;
+        pthread_create(&service->threads[w], NULL, worker_main, worker);
+    }
+    pthread_barrier_wait(&service->done);   // every worker has initialized its sessions
+    return service;
+}
+
+//process one block for every session; returns when all workers are done
+static void service_tick(service_t *service) {
+    pthread_barrier_wait(&service->start);
+    pthread_barrier_wait(&service->done);
+    service->tick++;
+}
+
+static void service_destroy(service_t *service) {
+    service->stop = true;
+    pthread_barrier_wait(&service->start);
+    for (uint32_t w = 0; w < service->worker_count; w++) {
+        pthread_join(service->threads[w], NULL);
+    }
+    pthread_barrier_destroy(&service->start);
+    pthread_barrier_destroy(&service->done);
+    free(service->sessions);
+    free(service);
+}
+
+//---------------- load generator ----------------
+
+#define BANK_BLOCKS 80                      // 1.024 s per pluck, then it is plucked again
+#define BANK_SAMPLES (BANK_BLOCKS * BLOCK_SAMPLES)
+#define BANK_DETUNES 4
+
+static const double detune_cents[BANK_DETUNES] = { -30.0, -8.0, 3.0, 18.0 };
+static int16_t bank[6][BANK_DETUNES][BANK_SAMPLES];
+
+typedef struct {
+    uint32_t string_index;                  // 0..5 -> string 1..6
+    uint32_t detune;
+    uint32_t start_block;
+} stream_t;
+
+static stream_t *streams;
+
+//decaying harmonic pluck with a little noise, like a real string into a pickup
+static void build_bank(void) {
+    const tuning_table_t *guitar = tuning_table_builtin(TUNING_PROFILE_GUITAR_STANDARD);
+    uint32_t seed = 12345;
+    for (int s = 0; s < 6; s++) {
+        for (int d = 0; d < BANK_DETUNES; d++) {
+            double f = guitar->strings[s].target_hz * pow(2.0, detune_cents[d] / 1200.0);
+            for (int i = 0; i < BANK_SAMPLES; i++) {
+                double t = (double)i / SAMPLE_RATE;
+                double v = sin(2.0 * M_PI * f * t) + 0.5 * sin(4.0 * M_PI * f * t) + 0.25 * sin(6.0 * M_PI * f * t);
+                seed = seed * 1664525u + 1013904223u;
+                double noise = ((int32_t)(seed >> 16) - 32768) / 32768.0 * 0.01;
+                bank[s][d][i] = (int16_t)(8000.0 * (v * exp(-1.5 * t) + noise));
+            }
+        }
+    }
+}
+
+static const int16_t *generator_input(void *context, uint32_t index, uint32_t tick) {
+    (void)context;
+    const stream_t *stream = &streams[index];
+    uint32_t block = (stream->start_block + tick) % BANK_BLOCKS;
+    return &bank[stream->string_index][stream->detune][block * BLOCK_SAMPLES];
+}
+
+static void generator_feedback(void *context, uint32_t index, const tuner_session_t *session) {
+    (void)context; (void)index; (void)session;   // a server would hand the phrase to the stream's output here
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    double mean_tick_s;
+    double p99_tick_s;
+    double sessions_per_core;
+    double correct;
+} bench_result_t;
+
+static bool run_bench(uint32_t sessions, uint32_t workers, uint32_t batch, uint32_t ticks, bench_result_t *out) {
+    service_t *service = service_create(sessions, workers, batch, generator_input, generator_feedback, NULL);
+    if (service == NULL) {
+        fprintf(stderr, "tuner_service: out of memory for %u sessions\n", sessions);
+        return false;
+    }
+    double *tick_times = malloc(ticks * sizeof(double));
+    double total = 0.0;
+    for (uint32_t t = 0; t < ticks; t++) {
+        double start = now_s();
+        service_tick(service);
+        tick_times[t] = now_s() - start;
+        total += tick_times[t];
+    }
+
+    uint32_t correct = 0;
+    for (uint32_t i = 0; i < sessions; i++) {
+        if (service->sessions[i].result.detected_string == (int)streams[i].string_index + 1) {
+            correct++;
+        }
+    }
+    qsort(tick_times, ticks, sizeof(double), compare_double);
+    out->mean_tick_s = total / ticks;
+    out->p99_tick_s = tick_times[(ticks * 99) / 100];
+    //sessions one core sustains with the mean tick exactly filling the block period
+    out->sessions_per_core = sessions * (BLOCK_PERIOD_S / out->mean_tick_s) / workers;
+    out->correct = (double)correct / sessions;
+    free(tick_times);
+    service_destroy(service);
+    return true;
+}
+
+static void print_result(uint32_t sessions, uint32_t workers, const bench_result_t *r) {
+    printf("%7u  %7u  %9.3f  %9.3f  %8.1fx  %12.0f  %7.1f%%\n", sessions, workers, r->mean_tick_s * 1e3,
+           r->p99_tick_s * 1e3, BLOCK_PERIOD_S / r->mean_tick_s, r->sessions_per_core, r->correct * 100.0);
+}
+
+int main(int argc, char **argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t sessions = 1024;
+    uint32_t workers = (cpus > 0) ? (uint32_t)cpus : 1;
+    uint32_t batch = 16;
+    double seconds = 5.0;
+    bool sweep = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:w:d:b:Sh")) != -1) {
+        switch (opt) {
+            case 's': sessions = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'w': workers = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': seconds = atof(optarg); break;
+            case 'b': batch = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'S': sweep = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-s sessions] [-w workers] [-d seconds] [-b batch] [-S]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (sessions == 0 || workers == 0 || workers > MAX_WORKERS || workers > sessions ||
+        batch == 0 || batch > MAX_BATCH || seconds <= 0.0) {
+        fprintf(stderr, "tuner_service: bad arguments\n");
+        return 2;
+    }
+    uint32_t ticks = (uint32_t)(seconds / BLOCK_PERIOD_S);
+    if (ticks == 0) {
+        ticks = 1;
+    }
+
+    build_bank();
+    streams = malloc(sessions * sizeof(stream_t));
+    if (streams == NULL) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < sessions; i++) {
+        streams[i].string_index = i % 6;
+        streams[i].detune = (i / 6) % BANK_DETUNES;
+        streams[i].start_block = (i * 7) % (BANK_BLOCKS / 2);   // staggered plucks, all audible by the end
+    }
+
+    printf("%u sessions, %.1f s of audio each (%u ticks of %.1f ms), batch %u, %ld cores online\n",
+           sessions, ticks * BLOCK_PERIOD_S, ticks, BLOCK_PERIOD_S * 1e3, batch, cpus);
+    printf("sessions  workers  tick ms    p99 ms     realtime   sessions/core  correct\n");
+    bench_result_t result;
+    if (sweep) {
+        for (uint32_t w = 1; w <= workers; w *= 2) {
+            if (!run_bench(sessions, w, batch, ticks, &result)) return 1;
+            print_result(sessions, w, &result);
+        }
+    } else {
+        if (!run_bench(sessions, workers, batch, ticks, &result)) return 1;
+        print_result(sessions, workers, &result);
+    }
+    free(streams);
+    return 0;
+}